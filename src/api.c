@@ -1,12 +1,43 @@
+#ifndef _WIN32
+#define _FILE_OFFSET_BITS 64
+#endif
+
 #include "api.h"
 
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <raylib.h>
 
+#include "bus.h"
+#include "capture.h"
+#include "feeder.h"
 #include "font.h"
+#include "headless.h"
 #include "icon.h"
+#include "noise.h"
+#include "pcm.h"
+#include "pixels.h"
+#include "reload.h"
 #include "util.h"
+#include "voice.h"
+#include "walk.h"
+
+#define MINIZ_HEADER_FILE_ONLY
+#define MINIZ_NO_ZLIB_COMPATIBLE_NAMES
+#include "lib/zip/miniz.h"
+
+#define ZSTREAM_CHUNK (64 * 1024)
+
+#ifdef _WIN32
+#define fileSeek _fseeki64
+#define fileTell _ftelli64
+#else
+#define fileSeek fseeko
+#define fileTell ftello
+#endif
 
 static int argCount;
 static char** args;
@@ -72,7 +103,10 @@ int uiTextHeight(mu_Font font)
 
 void audioInit(WrenVM* vm)
 {
-    InitAudioDevice();
+    // Still open after a hot reload restart.
+    if (!IsAudioDeviceReady())
+        InitAudioDevice();
+
     if (!IsAudioDeviceReady()) {
         VM_ABORT(vm, "Failed to initialize audio.");
         return;
@@ -101,6 +135,29 @@ void audioSetVolume(WrenVM* vm)
     SetMasterVolume(volume);
 }
 
+void audioGetMaxVoices(WrenVM* vm)
+{
+    wrenSetSlotDouble(vm, 0, voiceGetLimit());
+}
+
+void audioSetMaxVoices(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "voices");
+    int limit = (int)wrenGetSlotDouble(vm, 1);
+
+    if (limit < 1) {
+        VM_ABORT(vm, "Voice limit must be at least 1.");
+        return;
+    }
+
+    voiceSetLimit(limit);
+}
+
+void audioGetActiveVoices(WrenVM* vm)
+{
+    wrenSetSlotDouble(vm, 0, voiceGetActive());
+}
+
 void soundAllocate(WrenVM* vm)
 {
     wrenEnsureSlots(vm, 1);
@@ -110,6 +167,9 @@ void soundAllocate(WrenVM* vm)
 void soundFinalize(void* data)
 {
     Sound* sound = (Sound*)data;
+    reloadForget(sound);
+    voiceRelease(sound);
+    busDetach(sound->stream);
     UnloadSound(*sound);
 }
 
@@ -129,6 +189,9 @@ void soundNew(WrenVM* vm)
         VM_ABORT(vm, "Failed to load sound.");
         return;
     }
+
+    busAttach(sound->stream, BUS_SFX);
+    reloadTrack(RELOAD_SOUND, sound, path, NULL, 0);
 }
 
 void soundPlay(WrenVM* vm)
@@ -203,3170 +266,5987 @@ void soundSetPan(WrenVM* vm)
     SetSoundPan(*sound, pan);
 }
 
-void soundAliasFinalize(void* data)
+static void playVoice(WrenVM* vm, int priority)
 {
-    Sound* sound = (Sound*)data;
-    UnloadSoundAlias(*sound);
+    Sound* sound = (Sound*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "volume");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "pitch");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "pan");
+    float volume = (float)wrenGetSlotDouble(vm, 1);
+    float pitch = (float)wrenGetSlotDouble(vm, 2);
+    float pan = (float)wrenGetSlotDouble(vm, 3);
+
+    if (volume < 0.0f || volume > 1.0f) {
+        VM_ABORT(vm, "Volume must be between 0.0 and 1.0.");
+        return;
+    }
+
+    if (pitch < 0.0f) {
+        VM_ABORT(vm, "Pitch must be greater than 0.0.");
+        return;
+    }
+
+    if (pan < 0.0f || pan > 1.0f) {
+        VM_ABORT(vm, "Pan must be between 0.0 and 1.0.");
+        return;
+    }
+
+    wrenSetSlotBool(vm, 0, voicePlay(sound, volume, pitch, pan, priority));
 }
 
-void soundAliasNew(WrenVM* vm)
+void soundPlayVoice(WrenVM* vm)
+{
+    playVoice(vm, 0);
+}
+
+void soundPlayVoice2(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "priority");
+    playVoice(vm, (int)wrenGetSlotDouble(vm, 4));
+}
+
+void soundStopVoices(WrenVM* vm)
 {
     Sound* sound = (Sound*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "sound");
-    Sound* other = (Sound*)wrenGetSlotForeign(vm, 1);
-    *sound = LoadSoundAlias(*other);
+    voiceStop(sound);
 }
 
-// Graphics
+void soundSetVoices(WrenVM* vm)
+{
+    Sound* sound = (Sound*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "voices");
+    int size = (int)wrenGetSlotDouble(vm, 1);
 
-void graphicsBegin(WrenVM* vm)
+    if (size < 1) {
+        VM_ABORT(vm, "Sound must have at least 1 voice.");
+        return;
+    }
+
+    if (!voiceSetPoolSize(sound, size)) {
+        VM_ABORT(vm, "Failed to allocate voices.");
+        return;
+    }
+}
+
+// Returns -1 after aborting if the slot doesn't name a bus.
+static int getBus(WrenVM* vm, int slot)
 {
-    BeginDrawing();
+    if (wrenGetSlotType(vm, slot) != WREN_TYPE_STRING) {
+        VM_ABORT(vm, "Expected bus to be of type STRING.");
+        return -1;
+    }
+
+    int bus = busFind(wrenGetSlotString(vm, slot));
+    if (bus < 0)
+        VM_ABORT(vm, "Bus must be music, sfx or voice.");
+
+    return bus;
 }
 
-void graphicsEnd(WrenVM* vm)
+void soundSetBus(WrenVM* vm)
 {
-    EndDrawing();
+    Sound* sound = (Sound*)wrenGetSlotForeign(vm, 0);
+    int bus = getBus(vm, 1);
+    if (bus < 0)
+        return;
+
+    busAttach(sound->stream, bus);
+
+    // Voices are routed when they are created, so they pick up the new bus on the next play.
+    voiceReset(sound);
 }
 
-void graphicsBeginBlend(WrenVM* vm)
+void soundAliasFinalize(void* data)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "mode");
-    const char* mode = wrenGetSlotString(vm, 1);
+    Sound* sound = (Sound*)data;
+    reloadForget(sound);
+    busDetach(sound->stream);
+    UnloadSoundAlias(*sound);
+}
 
-    if (TextIsEqual(mode, "alpha"))
-        BeginBlendMode(BLEND_ALPHA);
-    else if (TextIsEqual(mode, "additive"))
-        BeginBlendMode(BLEND_ADDITIVE);
-    else if (TextIsEqual(mode, "multiplied"))
-        BeginBlendMode(BLEND_MULTIPLIED);
-    else if (TextIsEqual(mode, "addColors"))
-        BeginBlendMode(BLEND_ADD_COLORS);
-    else if (TextIsEqual(mode, "subtractColors"))
-        BeginBlendMode(BLEND_SUBTRACT_COLORS);
-    else if (TextIsEqual(mode, "alphaPremultiply"))
-        BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
-    else
-        VM_ABORT(vm, "Invalid blend mode.");
+void soundAliasNew(WrenVM* vm)
+{
+    Sound* sound = (Sound*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "sound");
+    Sound* other = (Sound*)wrenGetSlotForeign(vm, 1);
+    *sound = LoadSoundAlias(*other);
+    busAttach(sound->stream, busOf(other->stream, BUS_SFX));
+    reloadTrackAlias(sound, other);
 }
 
-void graphicsEndBlend(WrenVM* vm)
+typedef struct {
+    Music music;
+    unsigned char* data; // Inflated egg entry the stream decodes from, if it had to be copied
+    bool loaded;
+} MusicStream;
+
+// Runs on the feeder thread with the feeder lock held.
+static void feedMusic(void* arg)
 {
-    EndBlendMode();
+    MusicStream* stream = (MusicStream*)arg;
+    UpdateMusicStream(stream->music);
 }
 
-void graphicsBeginScissor(WrenVM* vm)
+void musicAllocate(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    int width = (int)wrenGetSlotDouble(vm, 3);
-    int height = (int)wrenGetSlotDouble(vm, 4);
-    BeginScissorMode(x, y, width, height);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(MusicStream));
 }
 
-void graphicsEndScissor(WrenVM* vm)
+void musicFinalize(void* data)
 {
-    EndScissorMode();
+    MusicStream* stream = (MusicStream*)data;
+
+    if (stream->loaded) {
+        feederRemove(stream);
+        busDetach(stream->music.stream);
+        UnloadMusicStream(stream->music);
+    }
+
+    free(stream->data);
 }
 
-void graphicsScreenshot(WrenVM* vm)
+void musicNew(WrenVM* vm)
 {
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
     const char* path = wrenGetSlotString(vm, 1);
-    TakeScreenshot(path);
+
+    if (!IsAudioDeviceReady()) {
+        VM_ABORT(vm, "Cannot load music before audio initialization.");
+        return;
+    }
+
+    // raylib opens music files itself, so entries in an egg are decoded from memory instead.
+    // Stored entries are used straight from the mapping.
+    Egg* egg = ((vmData*)wrenGetUserData(vm))->egg;
+    if (egg) {
+        size_t size;
+        const unsigned char* data = eggView(egg, path, &size);
+        if (data == NULL)
+            data = stream->data = eggLoad(egg, path, &size);
+
+        if (data != NULL)
+            stream->music = LoadMusicStreamFromMemory(GetFileExtension(path), data, (int)size);
+    } else {
+        stream->music = LoadMusicStream(path);
+    }
+
+    if (!IsMusicReady(stream->music)) {
+        VM_ABORT(vm, "Failed to load music.");
+        return;
+    }
+
+    stream->loaded = true;
+    busAttach(stream->music.stream, BUS_MUSIC);
+
+    if (!feederAdd(feedMusic, stream)) {
+        VM_ABORT(vm, "Failed to start audio thread.");
+        return;
+    }
 }
 
-void graphicsMeasure(WrenVM* vm)
+void musicPlay(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "size");
-    const char* text = wrenGetSlotString(vm, 1);
-    int size = (int)wrenGetSlotDouble(vm, 2);
-
-    if (size < defaultFont.baseSize)
-        size = defaultFont.baseSize;
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    feederLock();
+    PlayMusicStream(stream->music);
+    feederUnlock();
+}
 
-    wrenSetSlotDouble(vm, 0, MeasureTextEx(defaultFont, text, (float)size, size / defaultFont.baseSize).x);
+void musicStop(WrenVM* vm)
+{
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    feederLock();
+    StopMusicStream(stream->music);
+    feederUnlock();
 }
 
-void graphicsNoise(WrenVM* vm)
+void musicPause(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "frequency");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "depth");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    float frequency = (float)wrenGetSlotDouble(vm, 3);
-    int depth = (int)wrenGetSlotDouble(vm, 4);
-    wrenSetSlotDouble(vm, 0, perlin2d(x, y, frequency, depth));
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    feederLock();
+    PauseMusicStream(stream->music);
+    feederUnlock();
 }
 
-void graphicsClear(WrenVM* vm)
+void musicResume(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "color");
-    Color* color = (Color*)wrenGetSlotForeign(vm, 1);
-    ClearBackground(*color);
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    feederLock();
+    ResumeMusicStream(stream->music);
+    feederUnlock();
 }
 
-void graphicsPrint(WrenVM* vm)
+void musicSeek(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "size");
-    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "color");
-    const char* text = wrenGetSlotString(vm, 1);
-    int x = (int)wrenGetSlotDouble(vm, 2);
-    int y = (int)wrenGetSlotDouble(vm, 3);
-    int size = (int)wrenGetSlotDouble(vm, 4);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 5);
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "position");
+    float position = (float)wrenGetSlotDouble(vm, 1);
 
-    if (size < defaultFont.baseSize)
-        size = defaultFont.baseSize;
+    if (position < 0.0f) {
+        VM_ABORT(vm, "Position must be greater than 0.0.");
+        return;
+    }
 
-    DrawTextEx(defaultFont, text, (Vector2) { (float)x, (float)y }, size, size / defaultFont.baseSize, *color);
+    feederLock();
+    SeekMusicStream(stream->music, position);
+    feederUnlock();
 }
 
-void graphicsPixel(WrenVM* vm)
+void musicGetPlaying(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, FOREIGN, "color");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 3);
-    DrawPixel(x, y, *color);
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    feederLock();
+    bool playing = IsMusicStreamPlaying(stream->music);
+    feederUnlock();
+    wrenSetSlotBool(vm, 0, playing);
 }
 
-void graphicsLine(WrenVM* vm)
+void musicGetLength(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x1");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y1");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "x2");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "y2");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "thick");
-    ASSERT_SLOT_TYPE(vm, 6, FOREIGN, "color");
-    int x1 = (int)wrenGetSlotDouble(vm, 1);
-    int y1 = (int)wrenGetSlotDouble(vm, 2);
-    int x2 = (int)wrenGetSlotDouble(vm, 3);
-    int y2 = (int)wrenGetSlotDouble(vm, 4);
-    float thick = (float)wrenGetSlotDouble(vm, 5);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 6);
-    DrawLineEx((Vector2) { (float)x1, (float)y1 }, (Vector2) { (float)x2, (float)y2 }, thick, *color);
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, GetMusicTimeLength(stream->music));
 }
 
-void graphicsLineBezier(WrenVM* vm)
+void musicGetPosition(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x1");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y1");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "x2");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "y2");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "thick");
-    ASSERT_SLOT_TYPE(vm, 6, FOREIGN, "color");
-    int x1 = (int)wrenGetSlotDouble(vm, 1);
-    int y1 = (int)wrenGetSlotDouble(vm, 2);
-    int x2 = (int)wrenGetSlotDouble(vm, 3);
-    int y2 = (int)wrenGetSlotDouble(vm, 4);
-    float thick = (float)wrenGetSlotDouble(vm, 5);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 6);
-    DrawLineBezier((Vector2) { (float)x1, (float)y1 }, (Vector2) { (float)x2, (float)y2 }, thick, *color);
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    feederLock();
+    float position = GetMusicTimePlayed(stream->music);
+    feederUnlock();
+    wrenSetSlotDouble(vm, 0, position);
 }
 
-void graphicsCircle(WrenVM* vm)
+void musicGetLooping(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "radius");
-    ASSERT_SLOT_TYPE(vm, 4, FOREIGN, "color");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    float radius = (float)wrenGetSlotDouble(vm, 3);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 4);
-    DrawCircle(x, y, radius, *color);
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotBool(vm, 0, stream->music.looping);
 }
 
-void graphicsCircleLines(WrenVM* vm)
+void musicSetLooping(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "radius");
-    ASSERT_SLOT_TYPE(vm, 4, FOREIGN, "color");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    float radius = (float)wrenGetSlotDouble(vm, 3);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 4);
-    DrawCircleLines(x, y, radius, *color);
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, BOOL, "looping");
+    feederLock();
+    stream->music.looping = wrenGetSlotBool(vm, 1);
+    feederUnlock();
 }
 
-void graphicsEllipse(WrenVM* vm)
+void musicSetVolume(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "rx");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "ry");
-    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "color");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    float rx = (float)wrenGetSlotDouble(vm, 3);
-    float ry = (float)wrenGetSlotDouble(vm, 4);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 5);
-    DrawEllipse(x, y, rx, ry, *color);
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "volume");
+    float volume = (float)wrenGetSlotDouble(vm, 1);
+
+    if (volume < 0.0f || volume > 1.0f) {
+        VM_ABORT(vm, "Volume must be between 0.0 and 1.0.");
+        return;
+    }
+
+    feederLock();
+    SetMusicVolume(stream->music, volume);
+    feederUnlock();
 }
 
-void graphicsEllipseLines(WrenVM* vm)
+void musicSetPitch(WrenVM* vm)
 {
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "pitch");
+    float pitch = (float)wrenGetSlotDouble(vm, 1);
+
+    if (pitch < 0.0f) {
+        VM_ABORT(vm, "Pitch must be greater than 0.0.");
+        return;
+    }
+
+    feederLock();
+    SetMusicPitch(stream->music, pitch);
+    feederUnlock();
+}
+
+void musicSetPan(WrenVM* vm)
+{
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "pan");
+    float pan = (float)wrenGetSlotDouble(vm, 1);
+
+    if (pan < 0.0f || pan > 1.0f) {
+        VM_ABORT(vm, "Pan must be between 0.0 and 1.0.");
+        return;
+    }
+
+    feederLock();
+    SetMusicPan(stream->music, pan);
+    feederUnlock();
+}
+
+void musicSetBus(WrenVM* vm)
+{
+    MusicStream* stream = (MusicStream*)wrenGetSlotForeign(vm, 0);
+    int bus = getBus(vm, 1);
+    if (bus < 0)
+        return;
+
+    busAttach(stream->music.stream, bus);
+}
+
+typedef struct {
+    Pcm* pcm; // NULL until the stream is created
+} PcmStream;
+
+void audioStreamAllocate(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(PcmStream));
+}
+
+void audioStreamFinalize(void* data)
+{
+    PcmStream* stream = (PcmStream*)data;
+
+    if (stream->pcm) {
+        busDetach(pcmGetStream(stream->pcm));
+        pcmDestroy(stream->pcm);
+    }
+}
+
+static void newAudioStream(WrenVM* vm, double frames)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "sampleRate");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "sampleSize");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "channels");
+    int sampleRate = (int)wrenGetSlotDouble(vm, 1);
+    int sampleSize = (int)wrenGetSlotDouble(vm, 2);
+    int channels = (int)wrenGetSlotDouble(vm, 3);
+
+    if (!IsAudioDeviceReady()) {
+        VM_ABORT(vm, "Cannot create audio stream before audio initialization.");
+        return;
+    }
+
+    if (sampleRate < 1) {
+        VM_ABORT(vm, "Sample rate must be at least 1.");
+        return;
+    }
+
+    if (sampleSize != 8 && sampleSize != 16 && sampleSize != 32) {
+        VM_ABORT(vm, "Sample size must be 8, 16 or 32.");
+        return;
+    }
+
+    if (channels != 1 && channels != 2) {
+        VM_ABORT(vm, "Channels must be 1 or 2.");
+        return;
+    }
+
+    if (frames < 1 || frames > sampleRate * 60.0) {
+        VM_ABORT(vm, "Frames must be between 1 and a minute of audio.");
+        return;
+    }
+
+    stream->pcm = pcmCreate(sampleRate, sampleSize, channels, (size_t)frames);
+    if (stream->pcm == NULL) {
+        VM_ABORT(vm, "Failed to create audio stream.");
+        return;
+    }
+
+    busAttach(pcmGetStream(stream->pcm), BUS_SFX);
+}
+
+void audioStreamNew(WrenVM* vm)
+{
+    // A tenth of a second of queue by default.
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "sampleRate");
+    newAudioStream(vm, wrenGetSlotDouble(vm, 1) / 10);
+}
+
+void audioStreamNew2(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "frames");
+    newAudioStream(vm, wrenGetSlotDouble(vm, 4));
+}
+
+static void writeAudioStream(WrenVM* vm, const uint8_t* data, int size)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    size_t frameSize = pcmGetFrameSize(stream->pcm);
+
+    if ((size_t)size % frameSize != 0) {
+        VM_ABORT(vm, "Size must be a whole number of frames.");
+        return;
+    }
+
+    wrenSetSlotDouble(vm, 0, (double)pcmWrite(stream->pcm, data, size / frameSize));
+}
+
+void audioStreamWrite(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "buffer");
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
+    writeAudioStream(vm, buffer->data, buffer->size);
+}
+
+void audioStreamWrite2(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "buffer");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "size");
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
+    int size = (int)wrenGetSlotDouble(vm, 3);
+
+    if (offset < 0 || size < 0 || offset + size > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
+
+    writeAudioStream(vm, &buffer->data[offset], size);
+}
+
+void audioStreamPlay(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    PlayAudioStream(pcmGetStream(stream->pcm));
+}
+
+void audioStreamStop(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    StopAudioStream(pcmGetStream(stream->pcm));
+
+    // A callback may still be running, so the ring drops the queued frames without touching
+    // what it is reading. Frames written after this are kept for the next play.
+    pcmClear(stream->pcm);
+}
+
+void audioStreamPause(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    PauseAudioStream(pcmGetStream(stream->pcm));
+}
+
+void audioStreamResume(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    ResumeAudioStream(pcmGetStream(stream->pcm));
+}
+
+void audioStreamGetPlaying(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotBool(vm, 0, IsAudioStreamPlaying(pcmGetStream(stream->pcm)));
+}
+
+void audioStreamGetQueued(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, (double)pcmGetQueued(stream->pcm));
+}
+
+void audioStreamGetSpace(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, (double)pcmGetSpace(stream->pcm));
+}
+
+void audioStreamGetLatency(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, (double)pcmGetQueued(stream->pcm) / pcmGetStream(stream->pcm).sampleRate);
+}
+
+void audioStreamGetUnderruns(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, (double)pcmGetUnderruns(stream->pcm));
+}
+
+void audioStreamSetVolume(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "volume");
+    float volume = (float)wrenGetSlotDouble(vm, 1);
+
+    if (volume < 0.0f || volume > 1.0f) {
+        VM_ABORT(vm, "Volume must be between 0.0 and 1.0.");
+        return;
+    }
+
+    SetAudioStreamVolume(pcmGetStream(stream->pcm), volume);
+}
+
+void audioStreamSetPitch(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "pitch");
+    float pitch = (float)wrenGetSlotDouble(vm, 1);
+
+    if (pitch < 0.0f) {
+        VM_ABORT(vm, "Pitch must be greater than 0.0.");
+        return;
+    }
+
+    SetAudioStreamPitch(pcmGetStream(stream->pcm), pitch);
+}
+
+void audioStreamSetPan(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "pan");
+    float pan = (float)wrenGetSlotDouble(vm, 1);
+
+    if (pan < 0.0f || pan > 1.0f) {
+        VM_ABORT(vm, "Pan must be between 0.0 and 1.0.");
+        return;
+    }
+
+    SetAudioStreamPan(pcmGetStream(stream->pcm), pan);
+}
+
+void audioStreamSetBus(WrenVM* vm)
+{
+    PcmStream* stream = (PcmStream*)wrenGetSlotForeign(vm, 0);
+    int bus = getBus(vm, 1);
+    if (bus < 0)
+        return;
+
+    busAttach(pcmGetStream(stream->pcm), bus);
+}
+
+// Mixer
+
+void mixerGain(WrenVM* vm)
+{
+    int bus = getBus(vm, 1);
+    if (bus < 0)
+        return;
+
+    wrenSetSlotDouble(vm, 0, busGetGain(bus));
+}
+
+void mixerSetGain(WrenVM* vm)
+{
+    int bus = getBus(vm, 1);
+    if (bus < 0)
+        return;
+
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "gain");
+    float gain = (float)wrenGetSlotDouble(vm, 2);
+
+    if (gain < 0.0f) {
+        VM_ABORT(vm, "Gain must be at least 0.0.");
+        return;
+    }
+
+    busSetGain(bus, gain);
+}
+
+void mixerDuck(WrenVM* vm)
+{
+    int bus = getBus(vm, 1);
+    if (bus < 0)
+        return;
+
+    int by = getBus(vm, 2);
+    if (by < 0)
+        return;
+
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "amount");
+    float amount = (float)wrenGetSlotDouble(vm, 3);
+
+    if (amount < 0.0f || amount > 1.0f) {
+        VM_ABORT(vm, "Amount must be between 0.0 and 1.0.");
+        return;
+    }
+
+    if (bus == by) {
+        VM_ABORT(vm, "A bus cannot duck itself.");
+        return;
+    }
+
+    busSetDuck(bus, by, amount);
+}
+
+void mixerSetLowPass(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "cutoff");
+    float cutoff = (float)wrenGetSlotDouble(vm, 1);
+
+    if (cutoff < 0.0f) {
+        VM_ABORT(vm, "Cutoff must be at least 0.0.");
+        return;
+    }
+
+    busSetLowPass(cutoff);
+}
+
+void mixerReverb(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "mix");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "roomSize");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "damping");
+    float mix = (float)wrenGetSlotDouble(vm, 1);
+    float roomSize = (float)wrenGetSlotDouble(vm, 2);
+    float damping = (float)wrenGetSlotDouble(vm, 3);
+
+    if (mix < 0.0f || mix > 1.0f || roomSize < 0.0f || roomSize > 1.0f || damping < 0.0f || damping > 1.0f) {
+        VM_ABORT(vm, "Reverb mix, room size and damping must be between 0.0 and 1.0.");
+        return;
+    }
+
+    busSetReverb(mix, roomSize, damping);
+}
+
+void mixerCompressor(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "threshold");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "ratio");
+    float threshold = (float)wrenGetSlotDouble(vm, 1);
+    float ratio = (float)wrenGetSlotDouble(vm, 2);
+
+    if (threshold > 0.0f) {
+        VM_ABORT(vm, "Threshold must be at most 0 dB.");
+        return;
+    }
+
+    if (ratio < 1.0f) {
+        VM_ABORT(vm, "Ratio must be at least 1.0.");
+        return;
+    }
+
+    busSetCompressor(threshold, ratio);
+}
+
+// Graphics
+
+void graphicsBegin(WrenVM* vm)
+{
+    BeginDrawing();
+    headlessBegin();
+}
+
+void graphicsEnd(WrenVM* vm)
+{
+    headlessEnd();
+    captureFrame();
+    EndDrawing();
+}
+
+void graphicsBeginBlend(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "mode");
+    const char* mode = wrenGetSlotString(vm, 1);
+
+    if (TextIsEqual(mode, "alpha"))
+        BeginBlendMode(BLEND_ALPHA);
+    else if (TextIsEqual(mode, "additive"))
+        BeginBlendMode(BLEND_ADDITIVE);
+    else if (TextIsEqual(mode, "multiplied"))
+        BeginBlendMode(BLEND_MULTIPLIED);
+    else if (TextIsEqual(mode, "addColors"))
+        BeginBlendMode(BLEND_ADD_COLORS);
+    else if (TextIsEqual(mode, "subtractColors"))
+        BeginBlendMode(BLEND_SUBTRACT_COLORS);
+    else if (TextIsEqual(mode, "alphaPremultiply"))
+        BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    else
+        VM_ABORT(vm, "Invalid blend mode.");
+}
+
+void graphicsEndBlend(WrenVM* vm)
+{
+    EndBlendMode();
+}
+
+void graphicsBeginScissor(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    int width = (int)wrenGetSlotDouble(vm, 3);
+    int height = (int)wrenGetSlotDouble(vm, 4);
+    BeginScissorMode(x, y, width, height);
+}
+
+void graphicsEndScissor(WrenVM* vm)
+{
+    EndScissorMode();
+}
+
+void graphicsScreenshot(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    const char* path = wrenGetSlotString(vm, 1);
+
+    if (!captureScreenshot(path)) {
+        VM_ABORT(vm, "Path is too long.");
+        return;
+    }
+}
+
+void graphicsStartRecording(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "directory");
+    ASSERT_SLOT_TYPE(vm, 2, STRING, "type");
+    const char* directory = wrenGetSlotString(vm, 1);
+    const char* type = wrenGetSlotString(vm, 2);
+
+    if (strcmp(type, ".png") != 0 && strcmp(type, ".qoi") != 0) {
+        VM_ABORT(vm, "Recording type must be \".png\" or \".qoi\".");
+        return;
+    }
+
+    if (!DirectoryExists(directory)) {
+        VM_ABORT(vm, "Directory does not exist.");
+        return;
+    }
+
+    if (!captureStartRecording(directory, type)) {
+        VM_ABORT(vm, "Path is too long.");
+        return;
+    }
+}
+
+void graphicsStopRecording(WrenVM* vm)
+{
+    captureStopRecording();
+}
+
+void graphicsGetRecording(WrenVM* vm)
+{
+    wrenSetSlotBool(vm, 0, captureRecording());
+}
+
+void graphicsGetRecordedFrames(WrenVM* vm)
+{
+    wrenSetSlotDouble(vm, 0, captureRecordedFrames());
+}
+
+void graphicsGetCaptureFailures(WrenVM* vm)
+{
+    wrenSetSlotDouble(vm, 0, captureFailures());
+}
+
+void graphicsMeasure(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "size");
+    const char* text = wrenGetSlotString(vm, 1);
+    int size = (int)wrenGetSlotDouble(vm, 2);
+
+    if (size < defaultFont.baseSize)
+        size = defaultFont.baseSize;
+
+    wrenSetSlotDouble(vm, 0, MeasureTextEx(defaultFont, text, (float)size, size / defaultFont.baseSize).x);
+}
+
+void graphicsNoise(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "frequency");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "depth");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    float frequency = (float)wrenGetSlotDouble(vm, 3);
+    int depth = (int)wrenGetSlotDouble(vm, 4);
+    wrenSetSlotDouble(vm, 0, perlin2d(x, y, frequency, depth));
+}
+
+void graphicsClear(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "color");
+    Color* color = (Color*)wrenGetSlotForeign(vm, 1);
+    ClearBackground(*color);
+}
+
+void graphicsPrint(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "size");
+    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "color");
+    const char* text = wrenGetSlotString(vm, 1);
+    int x = (int)wrenGetSlotDouble(vm, 2);
+    int y = (int)wrenGetSlotDouble(vm, 3);
+    int size = (int)wrenGetSlotDouble(vm, 4);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 5);
+
+    if (size < defaultFont.baseSize)
+        size = defaultFont.baseSize;
+
+    DrawTextEx(defaultFont, text, (Vector2) { (float)x, (float)y }, size, size / defaultFont.baseSize, *color);
+}
+
+void graphicsPixel(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, FOREIGN, "color");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 3);
+    DrawPixel(x, y, *color);
+}
+
+void graphicsLine(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x1");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y1");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "x2");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "y2");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "thick");
+    ASSERT_SLOT_TYPE(vm, 6, FOREIGN, "color");
+    int x1 = (int)wrenGetSlotDouble(vm, 1);
+    int y1 = (int)wrenGetSlotDouble(vm, 2);
+    int x2 = (int)wrenGetSlotDouble(vm, 3);
+    int y2 = (int)wrenGetSlotDouble(vm, 4);
+    float thick = (float)wrenGetSlotDouble(vm, 5);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 6);
+    DrawLineEx((Vector2) { (float)x1, (float)y1 }, (Vector2) { (float)x2, (float)y2 }, thick, *color);
+}
+
+void graphicsLineBezier(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x1");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y1");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "x2");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "y2");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "thick");
+    ASSERT_SLOT_TYPE(vm, 6, FOREIGN, "color");
+    int x1 = (int)wrenGetSlotDouble(vm, 1);
+    int y1 = (int)wrenGetSlotDouble(vm, 2);
+    int x2 = (int)wrenGetSlotDouble(vm, 3);
+    int y2 = (int)wrenGetSlotDouble(vm, 4);
+    float thick = (float)wrenGetSlotDouble(vm, 5);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 6);
+    DrawLineBezier((Vector2) { (float)x1, (float)y1 }, (Vector2) { (float)x2, (float)y2 }, thick, *color);
+}
+
+void graphicsCircle(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "radius");
+    ASSERT_SLOT_TYPE(vm, 4, FOREIGN, "color");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    float radius = (float)wrenGetSlotDouble(vm, 3);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 4);
+    DrawCircle(x, y, radius, *color);
+}
+
+void graphicsCircleLines(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "radius");
+    ASSERT_SLOT_TYPE(vm, 4, FOREIGN, "color");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    float radius = (float)wrenGetSlotDouble(vm, 3);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 4);
+    DrawCircleLines(x, y, radius, *color);
+}
+
+void graphicsEllipse(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "rx");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "ry");
+    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "color");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    float rx = (float)wrenGetSlotDouble(vm, 3);
+    float ry = (float)wrenGetSlotDouble(vm, 4);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 5);
+    DrawEllipse(x, y, rx, ry, *color);
+}
+
+void graphicsEllipseLines(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "rx");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "ry");
+    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "color");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    float rx = (float)wrenGetSlotDouble(vm, 3);
+    float ry = (float)wrenGetSlotDouble(vm, 4);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 5);
+    DrawEllipseLines(x, y, rx, ry, *color);
+}
+
+void graphicsRectangle(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "r");
+    ASSERT_SLOT_TYPE(vm, 6, NUM, "ox");
+    ASSERT_SLOT_TYPE(vm, 7, NUM, "oy");
+    ASSERT_SLOT_TYPE(vm, 8, FOREIGN, "color");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    int width = (int)wrenGetSlotDouble(vm, 3);
+    int height = (int)wrenGetSlotDouble(vm, 4);
+    float r = (float)wrenGetSlotDouble(vm, 5);
+    int ox = (int)wrenGetSlotDouble(vm, 6);
+    int oy = (int)wrenGetSlotDouble(vm, 7);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 8);
+    DrawRectanglePro((Rectangle) { (float)x, (float)y, (float)width, (float)height }, (Vector2) { (float)ox, (float)oy }, r, *color);
+}
+
+void graphicsRectangleLines(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "thick");
+    ASSERT_SLOT_TYPE(vm, 6, FOREIGN, "color");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    int width = (int)wrenGetSlotDouble(vm, 3);
+    int height = (int)wrenGetSlotDouble(vm, 4);
+    float thick = (float)wrenGetSlotDouble(vm, 5);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 6);
+    DrawRectangleLinesEx((Rectangle) { (float)x, (float)y, (float)width, (float)height }, thick, *color);
+}
+
+void graphicsTriangle(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x1");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y1");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "x2");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "y2");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "x3");
+    ASSERT_SLOT_TYPE(vm, 6, NUM, "y3");
+    ASSERT_SLOT_TYPE(vm, 7, FOREIGN, "color");
+    int x1 = (int)wrenGetSlotDouble(vm, 1);
+    int y1 = (int)wrenGetSlotDouble(vm, 2);
+    int x2 = (int)wrenGetSlotDouble(vm, 3);
+    int y2 = (int)wrenGetSlotDouble(vm, 4);
+    int x3 = (int)wrenGetSlotDouble(vm, 5);
+    int y3 = (int)wrenGetSlotDouble(vm, 6);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 7);
+    DrawTriangle((Vector2) { (float)x1, (float)y1 }, (Vector2) { (float)x2, (float)y2 }, (Vector2) { (float)x3, (float)y3 }, *color);
+}
+
+void graphicsTriangleLines(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x1");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y1");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "x2");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "y2");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "x3");
+    ASSERT_SLOT_TYPE(vm, 6, NUM, "y3");
+    ASSERT_SLOT_TYPE(vm, 7, FOREIGN, "color");
+    int x1 = (int)wrenGetSlotDouble(vm, 1);
+    int y1 = (int)wrenGetSlotDouble(vm, 2);
+    int x2 = (int)wrenGetSlotDouble(vm, 3);
+    int y2 = (int)wrenGetSlotDouble(vm, 4);
+    int x3 = (int)wrenGetSlotDouble(vm, 5);
+    int y3 = (int)wrenGetSlotDouble(vm, 6);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 7);
+    DrawTriangleLines((Vector2) { (float)x1, (float)y1 }, (Vector2) { (float)x2, (float)y2 }, (Vector2) { (float)x3, (float)y3 }, *color);
+}
+
+void graphicsPolygon(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "sides");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "radius");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "r");
+    ASSERT_SLOT_TYPE(vm, 6, FOREIGN, "color");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    int sides = (int)wrenGetSlotDouble(vm, 3);
+    float radius = (float)wrenGetSlotDouble(vm, 4);
+    float r = (float)wrenGetSlotDouble(vm, 5);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 6);
+    DrawPoly((Vector2) { (float)x, (float)y }, sides, radius, r, *color);
+}
+
+void graphicsPolygonLines(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "sides");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "radius");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "r");
+    ASSERT_SLOT_TYPE(vm, 6, NUM, "thick");
+    ASSERT_SLOT_TYPE(vm, 7, FOREIGN, "color");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    int sides = (int)wrenGetSlotDouble(vm, 3);
+    float radius = (float)wrenGetSlotDouble(vm, 4);
+    float r = (float)wrenGetSlotDouble(vm, 5);
+    float thick = (float)wrenGetSlotDouble(vm, 6);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 7);
+    DrawPolyLinesEx((Vector2) { (float)x, (float)y }, sides, radius, r, thick, *color);
+}
+
+void graphicsSetNoiseSeed(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "seed");
+    int seed = (int)wrenGetSlotDouble(vm, 1);
+    setSeed(seed);
+}
+
+void graphicsSetLineSpacing(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "spacing");
+    int spacing = (int)wrenGetSlotDouble(vm, 1);
+    SetTextLineSpacing(spacing);
+}
+
+// Arguments are buffer, x, y, [z,] width, height, frequency and depth.
+static void fillNoiseBuffer(WrenVM* vm, NoiseType type)
+{
+    int slot = 2;
+    int count = type == NOISE_SIMPLEX_3D ? 7 : 6;
+
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "buffer");
+    for (int i = slot; i < slot + count; i++) {
+        if (wrenGetSlotType(vm, i) != WREN_TYPE_NUM) {
+            VM_ABORT(vm, "Expected noise parameters to be of type NUM.");
+            return;
+        }
+    }
+
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
+    double x = wrenGetSlotDouble(vm, slot++);
+    double y = wrenGetSlotDouble(vm, slot++);
+    double z = type == NOISE_SIMPLEX_3D ? wrenGetSlotDouble(vm, slot++) : 0.0;
+    int width = (int)wrenGetSlotDouble(vm, slot++);
+    int height = (int)wrenGetSlotDouble(vm, slot++);
+    double frequency = wrenGetSlotDouble(vm, slot++);
+    int depth = (int)wrenGetSlotDouble(vm, slot++);
+
+    if (width < 0 || height < 0 || (size_t)width * height * sizeof(float) > (size_t)buffer->size) {
+        VM_ABORT(vm, "Buffer is too small.");
+        return;
+    }
+
+    if (depth < 1 || !(frequency > 0)) {
+        VM_ABORT(vm, "Noise needs a depth of at least 1 and a positive frequency.");
+        return;
+    }
+
+    fillNoise((float*)buffer->data, type, x, y, z, width, height, frequency, depth);
+}
+
+void noiseFill(WrenVM* vm)
+{
+    fillNoiseBuffer(vm, NOISE_VALUE);
+}
+
+void noiseFillSimplex(WrenVM* vm)
+{
+    fillNoiseBuffer(vm, NOISE_SIMPLEX);
+}
+
+void noiseFillSimplex2(WrenVM* vm)
+{
+    fillNoiseBuffer(vm, NOISE_SIMPLEX_3D);
+}
+
+void noiseSimplex(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    double x = wrenGetSlotDouble(vm, 1);
+    double y = wrenGetSlotDouble(vm, 2);
+    wrenSetSlotDouble(vm, 0, simplex2d(x, y));
+}
+
+void noiseSimplex2(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "z");
+    double x = wrenGetSlotDouble(vm, 1);
+    double y = wrenGetSlotDouble(vm, 2);
+    double z = wrenGetSlotDouble(vm, 3);
+    wrenSetSlotDouble(vm, 0, simplex3d(x, y, z));
+}
+
+struct ButtonMap {
+    MouseButton rl;
+    int mu;
+};
+
+struct KeyMap {
+    KeyboardKey rl;
+    int mu;
+};
+
+static struct ButtonMap buttonMap[] = {
+    { MOUSE_BUTTON_LEFT, MU_MOUSE_LEFT },
+    { MOUSE_BUTTON_RIGHT, MU_MOUSE_RIGHT },
+    { MOUSE_BUTTON_MIDDLE, MU_MOUSE_MIDDLE },
+    { -1, -1 }
+};
+
+static struct KeyMap keyMap[] = {
+    { KEY_LEFT_SHIFT, MU_KEY_SHIFT },
+    { KEY_RIGHT_SHIFT, MU_KEY_SHIFT },
+    { KEY_LEFT_CONTROL, MU_KEY_CTRL },
+    { KEY_RIGHT_CONTROL, MU_KEY_CTRL },
+    { KEY_LEFT_ALT, MU_KEY_ALT },
+    { KEY_RIGHT_ALT, MU_KEY_ALT },
+    { KEY_ENTER, MU_KEY_RETURN },
+    { KEY_KP_ENTER, MU_KEY_RETURN },
+    { KEY_BACKSPACE, MU_KEY_BACKSPACE },
+    { -1, -1 },
+};
+
+void uiUpdate(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+
+    int x = GetMouseX();
+    int y = GetMouseY();
+    mu_input_mousemove(data->uiCtx, x, y);
+
+    Vector2 scroll = GetMouseWheelMoveV();
+    mu_input_scroll(data->uiCtx, scroll.x * -30, scroll.y * -30);
+
+    for (int i = 0;; i++) {
+        struct ButtonMap button = buttonMap[i];
+        if (button.rl == -1)
+            break;
+
+        if (IsMouseButtonPressed(button.rl))
+            mu_input_mousedown(data->uiCtx, x, y, button.mu);
+        else if (IsMouseButtonReleased(button.rl))
+            mu_input_mouseup(data->uiCtx, x, y, button.mu);
+    }
+
+    for (int i = 0;; i++) {
+        struct KeyMap key = keyMap[i];
+        if (key.rl == -1)
+            break;
+
+        if (IsKeyPressed(key.rl))
+            mu_input_keydown(data->uiCtx, key.mu);
+        else if (IsKeyReleased(key.rl))
+            mu_input_keyup(data->uiCtx, key.mu);
+    }
+
+    char buffer[512];
+    for (int i = 0; i < 512; i++) {
+        char c = GetCharPressed();
+        buffer[i] = c;
+        if (c == '\0')
+            break;
+    }
+    mu_input_text(data->uiCtx, buffer);
+}
+
+void uiDraw(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    BeginScissorMode(0, 0, GetScreenWidth(), GetScreenHeight());
+
+    mu_Command* cmd = NULL;
+    while (mu_next_command(data->uiCtx, &cmd)) {
+        switch (cmd->type) {
+        case MU_COMMAND_TEXT:
+            DrawTextEx(defaultFont, cmd->text.str, (Vector2) { (float)cmd->text.pos.x, (float)cmd->text.pos.y }, defaultFont.baseSize, 1, (Color) { cmd->text.color.r, cmd->text.color.g, cmd->text.color.b, cmd->text.color.a });
+            break;
+        case MU_COMMAND_RECT:
+            DrawRectangle(cmd->rect.rect.x, cmd->rect.rect.y, cmd->rect.rect.w, cmd->rect.rect.h, (Color) { cmd->rect.color.r, cmd->rect.color.g, cmd->rect.color.b, cmd->rect.color.a });
+            break;
+        case MU_COMMAND_ICON:
+            Color color = (Color) { cmd->icon.color.r, cmd->icon.color.g, cmd->icon.color.b, cmd->icon.color.a };
+
+            switch (cmd->icon.id) {
+            case MU_ICON_CLOSE:
+                DrawLine(cmd->icon.rect.x + 8, cmd->icon.rect.y + 8, cmd->icon.rect.x + cmd->icon.rect.w - 8, cmd->icon.rect.y + cmd->icon.rect.h - 8, color);
+                DrawLine(cmd->icon.rect.x + cmd->icon.rect.w - 8, cmd->icon.rect.y + 8, cmd->icon.rect.x + 8, cmd->icon.rect.y + cmd->icon.rect.h - 8, color);
+                break;
+            case MU_ICON_CHECK:
+                DrawLine(cmd->icon.rect.x + 5, cmd->icon.rect.y + 5, cmd->icon.rect.x + cmd->icon.rect.w - 5, cmd->icon.rect.y + cmd->icon.rect.h - 5, color);
+                DrawLine(cmd->icon.rect.x + cmd->icon.rect.w - 5, cmd->icon.rect.y + 5, cmd->icon.rect.x + 5, cmd->icon.rect.y + cmd->icon.rect.h - 5, color);
+                break;
+            case MU_ICON_COLLAPSED:
+                DrawLine(cmd->icon.rect.x + 6, cmd->icon.rect.y + 6, cmd->icon.rect.x + cmd->icon.rect.w / 2, cmd->icon.rect.y + cmd->icon.rect.h / 2, color);
+                DrawLine(cmd->icon.rect.x + 6, cmd->icon.rect.y + cmd->icon.rect.h - 6, cmd->icon.rect.x + cmd->icon.rect.w / 2, cmd->icon.rect.y + cmd->icon.rect.h / 2, color);
+                break;
+            case MU_ICON_EXPANDED:
+                DrawLine(cmd->icon.rect.x + 6, cmd->icon.rect.y + 6, cmd->icon.rect.x + cmd->icon.rect.w / 2, cmd->icon.rect.y + cmd->icon.rect.h / 2, color);
+                DrawLine(cmd->icon.rect.x + cmd->icon.rect.w - 6, cmd->icon.rect.y + 6, cmd->icon.rect.x + cmd->icon.rect.w / 2, cmd->icon.rect.y + cmd->icon.rect.h / 2, color);
+                break;
+            }
+
+            break;
+        case MU_COMMAND_CLIP:
+            EndScissorMode();
+            BeginScissorMode(cmd->clip.rect.x, cmd->clip.rect.y, cmd->clip.rect.w, cmd->clip.rect.h);
+            break;
+        }
+    }
+
+    EndScissorMode();
+}
+
+void uiBegin(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    mu_begin(data->uiCtx);
+}
+
+void uiEnd(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    mu_end(data->uiCtx);
+}
+
+void uiBeginWindow(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "title");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "height");
+    const char* title = wrenGetSlotString(vm, 1);
+    int x = (int)wrenGetSlotDouble(vm, 2);
+    int y = (int)wrenGetSlotDouble(vm, 3);
+    int width = (int)wrenGetSlotDouble(vm, 4);
+    int height = (int)wrenGetSlotDouble(vm, 5);
+    wrenSetSlotBool(vm, 0, mu_begin_window(data->uiCtx, title, mu_rect(x, y, width, height)));
+}
+
+void uiEndWindow(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    mu_end_window(data->uiCtx);
+}
+
+void uiLabel(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
+    const char* text = wrenGetSlotString(vm, 1);
+    mu_label(data->uiCtx, text);
+}
+
+void uiHeader(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
+    ASSERT_SLOT_TYPE(vm, 2, STRING, "option");
+    const char* text = wrenGetSlotString(vm, 1);
+    const char* option = wrenGetSlotString(vm, 2);
+
+    int opt;
+    if (TextIsEqual(option, "expanded")) {
+        opt = MU_OPT_EXPANDED;
+    } else {
+        opt = 0;
+    }
+
+    wrenSetSlotBool(vm, 0, mu_header_ex(data->uiCtx, text, opt));
+}
+
+void uiButton(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
+    const char* text = wrenGetSlotString(vm, 1);
+    wrenSetSlotBool(vm, 0, mu_button(data->uiCtx, text));
+}
+
+void uiRow(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "items");
+    ASSERT_SLOT_TYPE(vm, 2, LIST, "widths");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "height");
+    int items = (int)wrenGetSlotDouble(vm, 1);
+
+    int count = wrenGetListCount(vm, 2);
+    int* widths = malloc(count * sizeof(int));
+    for (int i = 0; i < count; i++) {
+        wrenGetListElement(vm, 2, i, 1);
+        widths[i] = (int)wrenGetSlotDouble(vm, 1);
+    }
+
+    int height = (int)wrenGetSlotDouble(vm, 3);
+    mu_layout_row(data->uiCtx, items, widths, height);
+    free(widths);
+}
+
+void uiTextbox(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "buffer");
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
+    wrenSetSlotBool(vm, 0, mu_textbox(data->uiCtx, buffer->data, buffer->size) & MU_RES_SUBMIT);
+}
+
+void uiGetWindowInfo(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    mu_Container* win = mu_get_current_container(data->uiCtx);
+
+    wrenEnsureSlots(vm, 3);
+    wrenSetSlotNewMap(vm, 0);
+
+    wrenSetSlotString(vm, 1, "x");
+    wrenSetSlotDouble(vm, 2, win->rect.x);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "y");
+    wrenSetSlotDouble(vm, 2, win->rect.y);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "width");
+    wrenSetSlotDouble(vm, 2, win->rect.w);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "height");
+    wrenSetSlotDouble(vm, 2, win->rect.h);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "scrollX");
+    wrenSetSlotDouble(vm, 2, win->scroll.x);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "scrollY");
+    wrenSetSlotDouble(vm, 2, win->scroll.y);
+    wrenSetMapValue(vm, 0, 1, 2);
+}
+
+void uiSetWindowSize(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
+    int width = (int)wrenGetSlotDouble(vm, 1);
+    int height = (int)wrenGetSlotDouble(vm, 2);
+    mu_Container* win = mu_get_current_container(data->uiCtx);
+    win->rect.w = width;
+    win->rect.h = height;
+}
+
+void uiOpenPopup(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "name");
+    const char* name = wrenGetSlotString(vm, 1);
+    mu_open_popup(data->uiCtx, name);
+}
+
+void uiBeginPopup(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "name");
+    const char* name = wrenGetSlotString(vm, 1);
+    wrenSetSlotBool(vm, 0, mu_begin_popup(data->uiCtx, name));
+}
+
+void uiEndPopup(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    mu_end_popup(data->uiCtx);
+}
+
+void uiBeginColumn(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    mu_layout_begin_column(data->uiCtx);
+}
+
+void uiEndColumn(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    mu_layout_end_column(data->uiCtx);
+}
+
+void uiSlider(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "buffer");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "min");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "max");
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
+    int min = (int)wrenGetSlotDouble(vm, 3);
+    int max = (int)wrenGetSlotDouble(vm, 4);
+
+    if (offset < 0 || offset >= buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
+
+    mu_slider(data->uiCtx, (float*)(&buffer->data[offset]), min, max);
+}
+
+void uiNext(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    wrenEnsureSlots(vm, 2);
+    wrenSetSlotNewList(vm, 0);
+
+    mu_Rect r = mu_layout_next(data->uiCtx);
+
+    wrenSetSlotDouble(vm, 1, r.x);
+    wrenInsertInList(vm, 0, 0, 1);
+
+    wrenSetSlotDouble(vm, 1, r.y);
+    wrenInsertInList(vm, 0, 1, 1);
+
+    wrenSetSlotDouble(vm, 1, r.w);
+    wrenInsertInList(vm, 0, 2, 1);
+
+    wrenSetSlotDouble(vm, 1, r.h);
+    wrenInsertInList(vm, 0, 3, 1);
+}
+
+void uiDrawRect(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
+    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "color");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    int width = (int)wrenGetSlotDouble(vm, 3);
+    int height = (int)wrenGetSlotDouble(vm, 4);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 5);
+    mu_draw_rect(data->uiCtx, mu_rect(x, y, width, height), mu_color(color->r, color->g, color->b, color->a));
+}
+
+void uiDrawText(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "height");
+    const char* text = wrenGetSlotString(vm, 1);
+    int x = (int)wrenGetSlotDouble(vm, 2);
+    int y = (int)wrenGetSlotDouble(vm, 3);
+    int width = (int)wrenGetSlotDouble(vm, 4);
+    int height = (int)wrenGetSlotDouble(vm, 5);
+    mu_draw_control_text(data->uiCtx, text, mu_rect(x, y, width, height), MU_COLOR_TEXT, MU_OPT_ALIGNCENTER);
+}
+
+void uiBeginTreenode(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
+    const char* text = wrenGetSlotString(vm, 1);
+    wrenSetSlotBool(vm, 0, mu_begin_treenode(data->uiCtx, text));
+}
+
+void uiEndTreenode(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    mu_end_treenode(data->uiCtx);
+}
+
+void uiCheckbox(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
+    ASSERT_SLOT_TYPE(vm, 2, FOREIGN, "buffer");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "offset");
+    const char* text = wrenGetSlotString(vm, 1);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 2);
+    int offset = (int)wrenGetSlotDouble(vm, 3);
+
+    if (offset < 0 || offset >= buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
+
+    wrenSetSlotBool(vm, 0, mu_checkbox(data->uiCtx, text, (int*)(&buffer->data[offset])));
+}
+
+void uiText(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+
+    if (wrenGetSlotType(vm, 1) == WREN_TYPE_STRING) {
+        const char* text = wrenGetSlotString(vm, 1);
+        mu_text(data->uiCtx, text);
+    } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_FOREIGN) {
+        Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
+        mu_text(data->uiCtx, (const char*)buffer->data);
+    }
+}
+
+void uiBeginPanel(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "name");
+    const char* name = wrenGetSlotString(vm, 1);
+    mu_begin_panel(data->uiCtx, name);
+}
+
+void uiEndPanel(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    mu_end_panel(data->uiCtx);
+}
+
+void uiFocus(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    mu_set_focus(data->uiCtx, data->uiCtx->last_id);
+}
+
+void colorAllocate(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Color));
+}
+
+void colorNew(WrenVM* vm)
+{
+    Color* color = (Color*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "r");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "g");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "b");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "a");
+    int r = (int)wrenGetSlotDouble(vm, 1);
+    int g = (int)wrenGetSlotDouble(vm, 2);
+    int b = (int)wrenGetSlotDouble(vm, 3);
+    int a = (int)wrenGetSlotDouble(vm, 4);
+    color->r = r;
+    color->g = g;
+    color->b = b;
+    color->a = a;
+}
+
+void colorNew2(WrenVM* vm)
+{
+    Color* color = (Color*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "r");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "g");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "b");
+    int r = (int)wrenGetSlotDouble(vm, 1);
+    int g = (int)wrenGetSlotDouble(vm, 2);
+    int b = (int)wrenGetSlotDouble(vm, 3);
+    color->r = r;
+    color->g = g;
+    color->b = b;
+    color->a = 255;
+}
+
+void colorGetIndex(WrenVM* vm)
+{
+    unsigned char* color = (unsigned char*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "index");
+    int index = (int)wrenGetSlotDouble(vm, 1);
+
+    if (index < 0 || index > 3) {
+        VM_ABORT(vm, "Invalid color index.");
+        return;
+    }
+
+    wrenSetSlotDouble(vm, 0, color[index]);
+}
+
+void colorSetIndex(WrenVM* vm)
+{
+    unsigned char* color = (unsigned char*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "index");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "value");
+    int index = (int)wrenGetSlotDouble(vm, 1);
+    int value = (int)wrenGetSlotDouble(vm, 2);
+
+    if (index < 0 || index > 3) {
+        VM_ABORT(vm, "Invalid color index.");
+        return;
+    }
+
+    color[index] = value;
+}
+
+// Buffers handed out by Image.pixels. They point straight at the image data,
+// so they are updated whenever raylib reallocates it and emptied when the
+// image goes away, leaving the buffer bounds checks to catch stale use.
+static Buffer** views = NULL;
+static int viewCount = 0;
+static int viewCapacity = 0;
+
+static bool trackView(Buffer* buffer)
+{
+    if (viewCount == viewCapacity) {
+        int capacity = viewCapacity > 0 ? viewCapacity * 2 : 16;
+        Buffer** grown = (Buffer**)realloc(views, capacity * sizeof(Buffer*));
+        if (grown == NULL)
+            return false;
+
+        views = grown;
+        viewCapacity = capacity;
+    }
+
+    views[viewCount++] = buffer;
+    return true;
+}
+
+static void untrackView(Buffer* buffer)
+{
+    for (int i = 0; i < viewCount; i++) {
+        if (views[i] == buffer) {
+            views[i] = views[--viewCount];
+            return;
+        }
+    }
+}
+
+static void refreshViews(Image* image)
+{
+    for (int i = 0; i < viewCount; i++) {
+        if (views[i]->image == image) {
+            views[i]->data = (uint8_t*)image->data;
+            views[i]->size = GetPixelDataSize(image->width, image->height, image->format);
+        }
+    }
+}
+
+static void releaseViews(Image* image)
+{
+    for (int i = 0; i < viewCount; i++) {
+        if (views[i]->image == image) {
+            *views[i] = (Buffer) { NULL, 0, NULL };
+            views[i--] = views[--viewCount];
+        }
+    }
+}
+
+static const char* formatNames[] = {
+    [PIXELFORMAT_UNCOMPRESSED_GRAYSCALE] = "grayscale",
+    [PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA] = "grayscaleAlpha",
+    [PIXELFORMAT_UNCOMPRESSED_R5G6B5] = "R5G6B5",
+    [PIXELFORMAT_UNCOMPRESSED_R8G8B8] = "R8G8B8",
+    [PIXELFORMAT_UNCOMPRESSED_R5G5B5A1] = "R5G5B5A1",
+    [PIXELFORMAT_UNCOMPRESSED_R4G4B4A4] = "R4G4B4A4",
+    [PIXELFORMAT_UNCOMPRESSED_R8G8B8A8] = "R8G8B8A8",
+    [PIXELFORMAT_UNCOMPRESSED_R32] = "R32",
+    [PIXELFORMAT_UNCOMPRESSED_R32G32B32] = "R32G32B32",
+    [PIXELFORMAT_UNCOMPRESSED_R32G32B32A32] = "R32G32B32A32",
+    [PIXELFORMAT_UNCOMPRESSED_R16] = "R16",
+    [PIXELFORMAT_UNCOMPRESSED_R16G16B16] = "R16G16B16",
+    [PIXELFORMAT_UNCOMPRESSED_R16G16B16A16] = "R16G16B16A16",
+};
+
+#define FORMAT_NAME_COUNT (int)(sizeof(formatNames) / sizeof(formatNames[0]))
+
+// Bytes per pixel for formats of 8-bit channels, which the threaded kernels handle, or 0.
+static int formatChannels(int format)
+{
+    switch (format) {
+    case PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:
+        return 1;
+    case PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
+        return 2;
+    case PIXELFORMAT_UNCOMPRESSED_R8G8B8:
+        return 3;
+    case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+// Replaces the pixels with a base level and halved levels down to 1x1, laid out one after another.
+static bool generateMipmaps(Image* image)
+{
+    int channels = formatChannels(image->format);
+    if (channels == 0 || image->data == NULL) {
+        ImageMipmaps(image);
+        return image->mipmaps > 1 || (image->width == 1 && image->height == 1);
+    }
+
+    int levels = 1;
+    size_t size = GetPixelDataSize(image->width, image->height, image->format);
+    for (int width = image->width, height = image->height; width > 1 || height > 1; levels++) {
+        width = width / 2 > 0 ? width / 2 : 1;
+        height = height / 2 > 0 ? height / 2 : 1;
+        size += (size_t)width * height * channels;
+    }
+
+    uint8_t* pixels = (uint8_t*)malloc(size);
+    if (pixels == NULL)
+        return false;
+
+    uint8_t* level = pixels;
+    int width = image->width, height = image->height;
+    memcpy(level, image->data, GetPixelDataSize(width, height, image->format));
+
+    for (int i = 1; i < levels; i++) {
+        uint8_t* next = level + (size_t)width * height * channels;
+        pixelsHalve(level, width, height, next, channels);
+
+        level = next;
+        width = width / 2 > 0 ? width / 2 : 1;
+        height = height / 2 > 0 ? height / 2 : 1;
+    }
+
+    free(image->data);
+    image->data = pixels;
+    image->mipmaps = levels;
+    return true;
+}
+
+// Converts the base level on worker threads, rebuilding mipmaps if there were any.
+static bool convertImage(Image* image, int format)
+{
+    if (image->format == format)
+        return true;
+
+    if (image->data == NULL)
+        return false;
+
+    void* pixels = malloc(GetPixelDataSize(image->width, image->height, format));
+    if (pixels == NULL || !pixelsConvert(image->data, image->format, pixels, format, image->width, image->height)) {
+        free(pixels);
+        return false;
+    }
+
+    bool mipmaps = image->mipmaps > 1;
+
+    free(image->data);
+    image->data = pixels;
+    image->format = format;
+    image->mipmaps = 1;
+
+    if (mipmaps)
+        generateMipmaps(image);
+
+    refreshViews(image);
+    return true;
+}
+
+// Bulk pixel operations work on 32-bit RGBA, other uncompressed formats are converted in place.
+static bool ensureRGBA(WrenVM* vm, Image* image)
+{
+    if (!convertImage(image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) || image->data == NULL) {
+        VM_ABORT(vm, "Image pixels cannot be edited in this format.");
+        return false;
+    }
+
+    return true;
+}
+
+static uint32_t packColor(Color color)
+{
+    uint32_t packed;
+    memcpy(&packed, &color, sizeof(packed));
+    return packed;
+}
+
+// Clips a rectangle to 0..width and 0..height, returns false if nothing is left.
+static bool clipRect(int* x, int* y, int* w, int* h, int width, int height)
+{
+    if (*x < 0) {
+        *w += *x;
+        *x = 0;
+    }
+
+    if (*y < 0) {
+        *h += *y;
+        *y = 0;
+    }
+
+    if (*x + *w > width)
+        *w = width - *x;
+    if (*y + *h > height)
+        *h = height - *y;
+
+    return *w > 0 && *h > 0;
+}
+
+void imageAllocate(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Image));
+}
+
+void imageFinalize(void* data)
+{
+    Image* image = (Image*)data;
+    releaseViews(image);
+    UnloadImage(*image);
+}
+
+void imageNew(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+
+    if (wrenGetSlotType(vm, 1) == WREN_TYPE_STRING) {
+        const char* path = wrenGetSlotString(vm, 1);
+
+        *image = LoadImage(path);
+        if (!IsImageReady(*image)) {
+            VM_ABORT(vm, "Failed to load image.");
+            return;
+        }
+    } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_FOREIGN) {
+        Texture* texture = (Texture*)wrenGetSlotForeign(vm, 1);
+        *image = LoadImageFromTexture(*texture);
+    } else {
+        VM_ABORT(vm, "Invalid image type.");
+        return;
+    }
+}
+
+void imageNew2(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
+    ASSERT_SLOT_TYPE(vm, 3, FOREIGN, "color");
+    int width = (int)wrenGetSlotDouble(vm, 1);
+    int height = (int)wrenGetSlotDouble(vm, 2);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 3);
+    *image = GenImageColor(width, height, *color);
+}
+
+void imageNew3(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "type");
+    ASSERT_SLOT_TYPE(vm, 2, STRING, "data");
+    const char* type = wrenGetSlotString(vm, 1);
+
+    int length;
+    const char* data = wrenGetSlotBytes(vm, 2, &length);
+    *image = LoadImageFromMemory(type, data, length);
+    if (!IsImageReady(*image)) {
+        VM_ABORT(vm, "Failed to load image.");
+        return;
+    }
+}
+
+void imageNew4(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    *image = LoadImageFromScreen();
+}
+
+void imageNew5(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "image");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "height");
+    Image* other = (Image*)wrenGetSlotForeign(vm, 1);
+    int x = (int)wrenGetSlotDouble(vm, 2);
+    int y = (int)wrenGetSlotDouble(vm, 3);
+    int width = (int)wrenGetSlotDouble(vm, 4);
+    int height = (int)wrenGetSlotDouble(vm, 5);
+    *image = ImageFromImage(*other, (Rectangle) { (float)x, (float)y, (float)width, (float)height });
+}
+
+void imageNew6(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "size");
+    ASSERT_SLOT_TYPE(vm, 3, FOREIGN, "color");
+    const char* text = wrenGetSlotString(vm, 1);
+    int size = (int)wrenGetSlotDouble(vm, 2);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 3);
+
+    if (size < defaultFont.baseSize)
+        size = defaultFont.baseSize;
+
+    *image = ImageTextEx(defaultFont, text, size, size / defaultFont.baseSize, *color);
+}
+
+void imageNew7(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "direction");
+    ASSERT_SLOT_TYPE(vm, 4, FOREIGN, "startColor");
+    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "endColor");
+    int width = (int)wrenGetSlotDouble(vm, 1);
+    int height = (int)wrenGetSlotDouble(vm, 2);
+    int direction = (int)wrenGetSlotDouble(vm, 3);
+    Color* startColor = (Color*)wrenGetSlotForeign(vm, 4);
+    Color* endColor = (Color*)wrenGetSlotForeign(vm, 5);
+    *image = GenImageGradientLinear(width, height, direction, *startColor, *endColor);
+}
+
+void imageNew8(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "density");
+    ASSERT_SLOT_TYPE(vm, 4, FOREIGN, "innerColor");
+    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "outerColor");
+    int width = (int)wrenGetSlotDouble(vm, 1);
+    int height = (int)wrenGetSlotDouble(vm, 2);
+    float density = (float)wrenGetSlotDouble(vm, 3);
+    Color* innerColor = (Color*)wrenGetSlotForeign(vm, 4);
+    Color* outerColor = (Color*)wrenGetSlotForeign(vm, 5);
+    *image = GenImageGradientRadial(width, height, density, *innerColor, *outerColor);
+}
+
+void imageNew9(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "density");
+    ASSERT_SLOT_TYPE(vm, 4, FOREIGN, "innerColor");
+    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "outerColor");
+    int width = (int)wrenGetSlotDouble(vm, 1);
+    int height = (int)wrenGetSlotDouble(vm, 2);
+    float density = (float)wrenGetSlotDouble(vm, 3);
+    Color* innerColor = (Color*)wrenGetSlotForeign(vm, 4);
+    Color* outerColor = (Color*)wrenGetSlotForeign(vm, 5);
+    *image = GenImageGradientSquare(width, height, density, *innerColor, *outerColor);
+}
+
+void imageNew10(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "frequency");
+    ASSERT_SLOT_TYPE(vm, 6, NUM, "depth");
+    double x = wrenGetSlotDouble(vm, 1);
+    double y = wrenGetSlotDouble(vm, 2);
+    int width = (int)wrenGetSlotDouble(vm, 3);
+    int height = (int)wrenGetSlotDouble(vm, 4);
+    double frequency = wrenGetSlotDouble(vm, 5);
+    int depth = (int)wrenGetSlotDouble(vm, 6);
+
+    if (width <= 0 || height <= 0) {
+        VM_ABORT(vm, "Invalid image size.");
+        return;
+    }
+
+    // raylib keeps image sizes in ints.
+    if ((size_t)height > INT_MAX / (size_t)width || (size_t)width * height > SIZE_MAX / sizeof(float)) {
+        VM_ABORT(vm, "Image is too large.");
+        return;
+    }
+
+    if (depth < 1 || !(frequency > 0)) {
+        VM_ABORT(vm, "Noise needs a depth of at least 1 and a positive frequency.");
+        return;
+    }
+
+    size_t count = (size_t)width * height;
+    float* samples = (float*)malloc(count * sizeof(float));
+    unsigned char* pixels = (unsigned char*)MemAlloc((unsigned int)count);
+    if (samples == NULL || pixels == NULL) {
+        free(samples);
+        MemFree(pixels);
+        VM_ABORT(vm, "Failed to allocate memory.");
+        return;
+    }
+
+    fillNoise(samples, NOISE_VALUE, x, y, 0.0, width, height, frequency, depth);
+
+    for (size_t i = 0; i < count; i++)
+        pixels[i] = (unsigned char)(samples[i] * 255.0f + 0.5f);
+
+    free(samples);
+
+    *image = (Image) { pixels, width, height, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE };
+}
+
+void imageExport(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    const char* path = wrenGetSlotString(vm, 1);
+    wrenSetSlotBool(vm, 0, ExportImage(*image, path));
+}
+
+void imageExportToMemory(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "type");
+    const char* type = wrenGetSlotString(vm, 1);
+
+    int length;
+    unsigned char* data = ExportImageToMemory(*image, type, &length);
+    wrenSetSlotBytes(vm, 0, data, length);
+}
+
+void imageCrop(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    int width = (int)wrenGetSlotDouble(vm, 3);
+    int height = (int)wrenGetSlotDouble(vm, 4);
+    ImageCrop(image, (Rectangle) { (float)x, (float)y, (float)width, (float)height });
+    refreshViews(image);
+}
+
+void imageResize(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
+    int width = (int)wrenGetSlotDouble(vm, 1);
+    int height = (int)wrenGetSlotDouble(vm, 2);
+
+    int channels = formatChannels(image->format);
+    if (channels == 0 || image->data == NULL || width <= 0 || height <= 0) {
+        ImageResize(image, width, height);
+        refreshViews(image);
+        return;
+    }
+
+    uint8_t* pixels = (uint8_t*)malloc((size_t)width * height * channels);
+    if (pixels == NULL || !pixelsResize(image->data, image->width, image->height, pixels, width, height, channels)) {
+        free(pixels);
+        VM_ABORT(vm, "Failed to allocate image.");
+        return;
+    }
+
+    free(image->data);
+    *image = (Image) { pixels, width, height, 1, image->format };
+    refreshViews(image);
+}
+
+void imageFlipVertical(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ImageFlipVertical(image);
+    refreshViews(image);
+}
+
+void imageFlipHorizontal(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ImageFlipHorizontal(image);
+    refreshViews(image);
+}
+
+void imageRotate(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "angle");
+    int angle = (int)wrenGetSlotDouble(vm, 1);
+
+    int channels = formatChannels(image->format);
+    if (channels == 0 || image->data == NULL || angle % 360 == 0) {
+        ImageRotate(image, angle);
+        refreshViews(image);
+        return;
+    }
+
+    int width, height;
+    pixelsRotatedSize(image->width, image->height, angle, &width, &height);
+
+    uint8_t* pixels = (uint8_t*)malloc((size_t)width * height * channels);
+    if (pixels == NULL) {
+        VM_ABORT(vm, "Failed to allocate image.");
+        return;
+    }
+
+    pixelsRotate(image->data, image->width, image->height, pixels, channels, angle);
+
+    free(image->data);
+    *image = (Image) { pixels, width, height, 1, image->format };
+    refreshViews(image);
+}
+
+void imageConvert(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "format");
+    const char* name = wrenGetSlotString(vm, 1);
+
+    int format = 0;
+    for (int i = 1; i < FORMAT_NAME_COUNT; i++) {
+        if (formatNames[i] != NULL && strcmp(formatNames[i], name) == 0)
+            format = i;
+    }
+
+    if (format == 0) {
+        VM_ABORT(vm, "Unknown image format.");
+        return;
+    }
+
+    if (!convertImage(image, format)) {
+        VM_ABORT(vm, "Image cannot be converted from this format.");
+        return;
+    }
+}
+
+void imageMipmaps(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+
+    if (!generateMipmaps(image)) {
+        VM_ABORT(vm, "Failed to generate mipmaps.");
+        return;
+    }
+
+    refreshViews(image);
+}
+
+void imagePremultiplyAlpha(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+
+    if (!ensureRGBA(vm, image))
+        return;
+
+    pixelsPremultiply((uint32_t*)image->data, image->width * image->height);
+}
+
+void imageGetPixels(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 2);
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    vmData* data = (vmData*)wrenGetUserData(vm);
+
+    if (image->data == NULL) {
+        VM_ABORT(vm, "Image has no pixels.");
+        return;
+    }
+
+    wrenSetSlotHandle(vm, 1, data->bufferClass);
+    Buffer* buffer = (Buffer*)wrenSetSlotNewForeign(vm, 0, 1, sizeof(Buffer));
+    *buffer = (Buffer) { (uint8_t*)image->data, GetPixelDataSize(image->width, image->height, image->format), image };
+
+    if (!trackView(buffer)) {
+        *buffer = (Buffer) { NULL, 0, NULL };
+        VM_ABORT(vm, "Failed to allocate buffer.");
+        return;
+    }
+}
+
+void imageGetPixel(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 3);
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+
+    if (x < 0 || y < 0 || x >= image->width || y >= image->height) {
+        VM_ABORT(vm, "Pixel out of bounds.");
+        return;
+    }
+
+    Color pixel = GetImageColor(*image, x, y);
+
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    wrenSetSlotHandle(vm, 2, data->colorClass);
+    Color* color = (Color*)wrenSetSlotNewForeign(vm, 0, 2, sizeof(Color));
+    *color = pixel;
+}
+
+void imageSetPixel(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, FOREIGN, "color");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 3);
+
+    if (x < 0 || y < 0 || x >= image->width || y >= image->height) {
+        VM_ABORT(vm, "Pixel out of bounds.");
+        return;
+    }
+
+    ImageDrawPixel(image, x, y, *color);
+}
+
+void imageFillRect(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
+    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "color");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    int width = (int)wrenGetSlotDouble(vm, 3);
+    int height = (int)wrenGetSlotDouble(vm, 4);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 5);
+
+    if (!ensureRGBA(vm, image))
+        return;
+
+    if (!clipRect(&x, &y, &width, &height, image->width, image->height))
+        return;
+
+    uint32_t* pixels = (uint32_t*)image->data;
+    pixelsFill(&pixels[(size_t)y * image->width + x], image->width, width, height, packColor(*color));
+}
+
+static void blitImage(WrenVM* vm, Image* src, int srcX, int srcY, int width, int height, int x, int y)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+
+    if (src == image) {
+        VM_ABORT(vm, "Cannot blit an image onto itself.");
+        return;
+    }
+
+    if (!ensureRGBA(vm, image) || !ensureRGBA(vm, src))
+        return;
+
+    // Clip against the source, then shift the same amount on the destination and clip again.
+    int clippedX = srcX, clippedY = srcY;
+    if (!clipRect(&clippedX, &clippedY, &width, &height, src->width, src->height))
+        return;
+
+    x += clippedX - srcX;
+    y += clippedY - srcY;
+    srcX = clippedX;
+    srcY = clippedY;
+
+    int dstX = x, dstY = y;
+    if (!clipRect(&dstX, &dstY, &width, &height, image->width, image->height))
+        return;
+
+    srcX += dstX - x;
+    srcY += dstY - y;
+
+    uint32_t* dst = (uint32_t*)image->data;
+    const uint32_t* pixels = (const uint32_t*)src->data;
+    pixelsBlend(&dst[(size_t)dstY * image->width + dstX], image->width, &pixels[(size_t)srcY * src->width + srcX], src->width, width, height);
+}
+
+void imageBlit(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "image");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "y");
+    Image* src = (Image*)wrenGetSlotForeign(vm, 1);
+    int x = (int)wrenGetSlotDouble(vm, 2);
+    int y = (int)wrenGetSlotDouble(vm, 3);
+    blitImage(vm, src, 0, 0, src->width, src->height, x, y);
+}
+
+void imageBlit2(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "image");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "srcX");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "srcY");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "height");
+    ASSERT_SLOT_TYPE(vm, 6, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 7, NUM, "y");
+    Image* src = (Image*)wrenGetSlotForeign(vm, 1);
+    int srcX = (int)wrenGetSlotDouble(vm, 2);
+    int srcY = (int)wrenGetSlotDouble(vm, 3);
+    int width = (int)wrenGetSlotDouble(vm, 4);
+    int height = (int)wrenGetSlotDouble(vm, 5);
+    int x = (int)wrenGetSlotDouble(vm, 6);
+    int y = (int)wrenGetSlotDouble(vm, 7);
+    blitImage(vm, src, srcX, srcY, width, height, x, y);
+}
+
+void imageReplaceColor(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "from");
+    ASSERT_SLOT_TYPE(vm, 2, FOREIGN, "to");
+    Color* from = (Color*)wrenGetSlotForeign(vm, 1);
+    Color* to = (Color*)wrenGetSlotForeign(vm, 2);
+
+    if (!ensureRGBA(vm, image))
+        return;
+
+    int replaced = pixelsReplace((uint32_t*)image->data, image->width * image->height, packColor(*from), packColor(*to));
+    wrenSetSlotDouble(vm, 0, replaced);
+}
+
+void imageConvolve(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 3);
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, LIST, "kernel");
+    int count = wrenGetListCount(vm, 1);
+
+    int size = 1;
+    while (size * size < count)
+        size++;
+
+    if (size * size != count || size % 2 == 0 || size > 15) {
+        VM_ABORT(vm, "Kernel must be a square list with an odd side up to 15.");
+        return;
+    }
+
+    float kernel[15 * 15];
+    for (int i = 0; i < count; i++) {
+        wrenGetListElement(vm, 1, i, 2);
+        ASSERT_SLOT_TYPE(vm, 2, NUM, "kernel element");
+        kernel[i] = (float)wrenGetSlotDouble(vm, 2);
+    }
+
+    if (!ensureRGBA(vm, image))
+        return;
+
+    if (!pixelsConvolve((uint32_t*)image->data, image->width, image->height, kernel, size)) {
+        VM_ABORT(vm, "Failed to allocate image copy.");
+        return;
+    }
+}
+
+void imageGetWidth(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, image->width);
+}
+
+void imageGetHeight(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, image->height);
+}
+
+void imageGetFormat(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+
+    if (image->format > 0 && image->format < FORMAT_NAME_COUNT && formatNames[image->format] != NULL)
+        wrenSetSlotString(vm, 0, formatNames[image->format]);
+    else
+        wrenSetSlotString(vm, 0, "Unknown");
+}
+
+void imageGetMipmapCount(WrenVM* vm)
+{
+    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, image->mipmaps);
+}
+
+void textureAllocate(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Texture));
+}
+
+void textureFinalize(void* data)
+{
+    Texture* texture = (Texture*)data;
+    reloadForget(texture);
+    UnloadTexture(*texture);
+}
+
+void textureNew(WrenVM* vm)
+{
+    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
+
+    if (!IsWindowReady()) {
+        VM_ABORT(vm, "Cannot load texture before window initialization.");
+        return;
+    }
+
+    if (wrenGetSlotType(vm, 1) == WREN_TYPE_STRING) {
+        const char* path = wrenGetSlotString(vm, 1);
+
+        *texture = LoadTexture(path);
+        if (!IsTextureReady(*texture)) {
+            VM_ABORT(vm, "Failed to load texture.");
+            return;
+        }
+
+        reloadTrack(RELOAD_TEXTURE, texture, path, NULL, 0);
+    } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_FOREIGN) {
+        Image* image = (Image*)wrenGetSlotForeign(vm, 1);
+        *texture = LoadTextureFromImage(*image);
+    } else {
+        VM_ABORT(vm, "Invalid texture type.");
+        return;
+    }
+}
+
+void textureNew2(WrenVM* vm)
+{
+    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
+    int width = (int)wrenGetSlotDouble(vm, 1);
+    int height = (int)wrenGetSlotDouble(vm, 2);
+
+    if (!IsWindowReady()) {
+        VM_ABORT(vm, "Cannot load texture before window initialization.");
+        return;
+    }
+
+    if (width < 1 || height < 1) {
+        VM_ABORT(vm, "Texture must be at least 1x1.");
+        return;
+    }
+
+    Image image = GenImageColor(width, height, BLANK);
+    *texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+
+    if (!IsTextureReady(*texture)) {
+        VM_ABORT(vm, "Failed to create texture.");
+        return;
+    }
+}
+
+void textureDraw(WrenVM* vm)
+{
+    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
     ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "rx");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "ry");
-    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "color");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "r");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "sx");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "sy");
+    ASSERT_SLOT_TYPE(vm, 6, NUM, "ox");
+    ASSERT_SLOT_TYPE(vm, 7, NUM, "oy");
+    ASSERT_SLOT_TYPE(vm, 8, FOREIGN, "color");
     int x = (int)wrenGetSlotDouble(vm, 1);
     int y = (int)wrenGetSlotDouble(vm, 2);
-    float rx = (float)wrenGetSlotDouble(vm, 3);
-    float ry = (float)wrenGetSlotDouble(vm, 4);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 5);
-    DrawEllipseLines(x, y, rx, ry, *color);
+    float r = (float)wrenGetSlotDouble(vm, 3);
+    float sx = (float)wrenGetSlotDouble(vm, 4);
+    float sy = (float)wrenGetSlotDouble(vm, 5);
+    int ox = (int)wrenGetSlotDouble(vm, 6);
+    int oy = (int)wrenGetSlotDouble(vm, 7);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 8);
+
+    Rectangle source = { 0, 0, (float)texture->width, (float)texture->height };
+
+    if (sx < 0)
+        source.width = -source.width;
+
+    if (sy < 0)
+        source.height = -source.height;
+
+    float absSx = sx < 0 ? -sx : sx;
+    float absSy = sy < 0 ? -sy : sy;
+
+    DrawTexturePro(*texture, source, (Rectangle) { (float)x, (float)y, (float)texture->width * absSx, (float)texture->height * absSy }, (Vector2) { (float)ox, (float)oy }, r, *color);
+}
+
+void textureDrawRec(WrenVM* vm)
+{
+    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "srcX");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "srcY");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "srcWidth");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "srcHeight");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "dstX");
+    ASSERT_SLOT_TYPE(vm, 6, NUM, "dstY");
+    ASSERT_SLOT_TYPE(vm, 7, NUM, "r");
+    ASSERT_SLOT_TYPE(vm, 8, NUM, "sx");
+    ASSERT_SLOT_TYPE(vm, 9, NUM, "sy");
+    ASSERT_SLOT_TYPE(vm, 10, NUM, "ox");
+    ASSERT_SLOT_TYPE(vm, 11, NUM, "oy");
+    ASSERT_SLOT_TYPE(vm, 12, FOREIGN, "color");
+    int srcX = (int)wrenGetSlotDouble(vm, 1);
+    int srcY = (int)wrenGetSlotDouble(vm, 2);
+    int srcWidth = (int)wrenGetSlotDouble(vm, 3);
+    int srcHeight = (int)wrenGetSlotDouble(vm, 4);
+    int dstX = (int)wrenGetSlotDouble(vm, 5);
+    int dstY = (int)wrenGetSlotDouble(vm, 6);
+    float r = (float)wrenGetSlotDouble(vm, 7);
+    float sx = (float)wrenGetSlotDouble(vm, 8);
+    float sy = (float)wrenGetSlotDouble(vm, 9);
+    int ox = (int)wrenGetSlotDouble(vm, 10);
+    int oy = (int)wrenGetSlotDouble(vm, 11);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 12);
+
+    Rectangle source = { (float)srcX, (float)srcY, (float)srcWidth, (float)srcHeight };
+
+    if (sx < 0)
+        source.width = -source.width;
+
+    if (sy < 0)
+        source.height = -source.height;
+
+    float absSx = sx < 0 ? -sx : sx;
+    float absSy = sy < 0 ? -sy : sy;
+
+    DrawTexturePro(*texture, source, (Rectangle) { (float)dstX, (float)dstY, (float)srcWidth * absSx, (float)srcHeight * absSy }, (Vector2) { (float)ox, (float)oy }, r, *color);
+}
+
+void textureUpdateFromImage(WrenVM* vm)
+{
+    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "image");
+    Image* image = (Image*)wrenGetSlotForeign(vm, 1);
+
+    if (image->width != texture->width || image->height != texture->height) {
+        VM_ABORT(vm, "Image must be the same size as the texture.");
+        return;
+    }
+
+    // Matching formats go straight to the GPU, anything else is converted on a copy first.
+    if (image->format == texture->format) {
+        UpdateTexture(*texture, image->data);
+        return;
+    }
+
+    Image copy = ImageCopy(*image);
+    ImageFormat(&copy, texture->format);
+
+    if (copy.format != texture->format) {
+        UnloadImage(copy);
+        VM_ABORT(vm, "Image cannot be converted to the texture format.");
+        return;
+    }
+
+    UpdateTexture(*texture, copy.data);
+    UnloadImage(copy);
+}
+
+void textureUpdateRect(WrenVM* vm)
+{
+    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
+    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "buffer");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    int width = (int)wrenGetSlotDouble(vm, 3);
+    int height = (int)wrenGetSlotDouble(vm, 4);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 5);
+
+    if (x < 0 || y < 0 || width < 1 || height < 1 || x + width > texture->width || y + height > texture->height) {
+        VM_ABORT(vm, "Rectangle must be inside the texture.");
+        return;
+    }
+
+    if (buffer->size < GetPixelDataSize(width, height, texture->format)) {
+        VM_ABORT(vm, "Buffer is too small for the rectangle.");
+        return;
+    }
+
+    UpdateTextureRec(*texture, (Rectangle) { (float)x, (float)y, (float)width, (float)height }, buffer->data);
+}
+
+void textureGetWidth(WrenVM* vm)
+{
+    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, texture->width);
 }
 
-void graphicsRectangle(WrenVM* vm)
+void textureGetHeight(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "r");
-    ASSERT_SLOT_TYPE(vm, 6, NUM, "ox");
-    ASSERT_SLOT_TYPE(vm, 7, NUM, "oy");
-    ASSERT_SLOT_TYPE(vm, 8, FOREIGN, "color");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    int width = (int)wrenGetSlotDouble(vm, 3);
-    int height = (int)wrenGetSlotDouble(vm, 4);
-    float r = (float)wrenGetSlotDouble(vm, 5);
-    int ox = (int)wrenGetSlotDouble(vm, 6);
-    int oy = (int)wrenGetSlotDouble(vm, 7);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 8);
-    DrawRectanglePro((Rectangle) { (float)x, (float)y, (float)width, (float)height }, (Vector2) { (float)ox, (float)oy }, r, *color);
+    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, texture->height);
 }
 
-void graphicsRectangleLines(WrenVM* vm)
+void textureSetFilter(WrenVM* vm)
+{
+    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "filter");
+    const char* filter = wrenGetSlotString(vm, 1);
+
+    if (TextIsEqual(filter, "point"))
+        SetTextureFilter(*texture, TEXTURE_FILTER_POINT);
+    else if (TextIsEqual(filter, "bilinear"))
+        SetTextureFilter(*texture, TEXTURE_FILTER_BILINEAR);
+    else
+        VM_ABORT(vm, "Invalid texture filter.");
+}
+
+void textureSetWrap(WrenVM* vm)
+{
+    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "wrap");
+    const char* wrap = wrenGetSlotString(vm, 1);
+
+    if (TextIsEqual(wrap, "repeat"))
+        SetTextureWrap(*texture, TEXTURE_WRAP_REPEAT);
+    else if (TextIsEqual(wrap, "clamp"))
+        SetTextureWrap(*texture, TEXTURE_WRAP_CLAMP);
+    else
+        VM_ABORT(vm, "Invalid texture wrap.");
+}
+
+void renderTextureAllocate(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(RenderTexture));
+}
+
+void renderTextureFinalize(void* data)
+{
+    RenderTexture* texture = (RenderTexture*)data;
+    UnloadRenderTexture(*texture);
+}
+
+void renderTextureNew(WrenVM* vm)
+{
+    RenderTexture* texture = (RenderTexture*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
+    int width = (int)wrenGetSlotDouble(vm, 1);
+    int height = (int)wrenGetSlotDouble(vm, 2);
+
+    if (!IsWindowReady()) {
+        VM_ABORT(vm, "Cannot load texture before window initialization.");
+        return;
+    }
+
+    *texture = LoadRenderTexture(width, height);
+    if (!IsRenderTextureReady(*texture)) {
+        VM_ABORT(vm, "Failed to load texture.");
+        return;
+    }
+}
+
+void renderTextureBegin(WrenVM* vm)
+{
+    RenderTexture* texture = (RenderTexture*)wrenGetSlotForeign(vm, 0);
+    BeginTextureMode(*texture);
+}
+
+void renderTextureEnd(WrenVM* vm)
+{
+    EndTextureMode();
+    headlessResume();
+}
+
+void renderTextureGetTexture(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 2);
+    RenderTexture* texture = (RenderTexture*)wrenGetSlotForeign(vm, 0);
+
+    vmData* data = (vmData*)wrenGetUserData(vm);
+
+    wrenSetSlotHandle(vm, 1, data->textureClass);
+    Texture* tex = wrenSetSlotNewForeign(vm, 0, 1, sizeof(Texture));
+    *tex = texture->texture;
+}
+
+void fontAllocate(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Font));
+}
+
+void fontFinalize(void* data)
+{
+    Font* font = (Font*)data;
+    reloadForget(font);
+    UnloadFont(*font);
+}
+
+void fontNew(WrenVM* vm)
+{
+    Font* font = (Font*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "size");
+    const char* path = wrenGetSlotString(vm, 1);
+    int size = (int)wrenGetSlotDouble(vm, 2);
+
+    if (!IsWindowReady()) {
+        VM_ABORT(vm, "Cannot load font before window initialization.");
+        return;
+    }
+
+    *font = LoadFontEx(path, size, NULL, 250); // insert codepoint count in api
+    if (!IsFontReady(*font)) {
+        VM_ABORT(vm, "Failed to load font.");
+        return;
+    }
+
+    reloadTrack(RELOAD_FONT, font, path, NULL, size);
+}
+
+void fontNew2(WrenVM* vm)
+{
+    Font* font = (Font*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "data")
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "size");
+    int size = (int)wrenGetSlotDouble(vm, 2);
+
+    int length;
+    const char* data = wrenGetSlotBytes(vm, 1, &length);
+
+    if (!IsWindowReady()) {
+        VM_ABORT(vm, "Cannot load font before window initialization.");
+        return;
+    }
+
+    *font = LoadFontFromMemory(".ttf", data, length, size, NULL, 250);
+    if (!IsFontReady(*font)) {
+        VM_ABORT(vm, "Failed to load font.");
+        return;
+    }
+}
+
+void fontPrint(WrenVM* vm)
+{
+    Font* font = (Font*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "y");
+    ASSERT_SLOT_TYPE(vm, 4, NUM, "r");
+    ASSERT_SLOT_TYPE(vm, 5, NUM, "scale");
+    ASSERT_SLOT_TYPE(vm, 6, NUM, "spacing");
+    ASSERT_SLOT_TYPE(vm, 7, NUM, "ox");
+    ASSERT_SLOT_TYPE(vm, 8, NUM, "oy");
+    ASSERT_SLOT_TYPE(vm, 9, FOREIGN, "color");
+    const char* text = wrenGetSlotString(vm, 1);
+    int x = (int)wrenGetSlotDouble(vm, 2);
+    int y = (int)wrenGetSlotDouble(vm, 3);
+    float r = (float)wrenGetSlotDouble(vm, 4);
+    float scale = (float)wrenGetSlotDouble(vm, 5);
+    float spacing = (float)wrenGetSlotDouble(vm, 6);
+    int ox = (int)wrenGetSlotDouble(vm, 7);
+    int oy = (int)wrenGetSlotDouble(vm, 8);
+    Color* color = (Color*)wrenGetSlotForeign(vm, 9);
+    DrawTextPro(*font, text, (Vector2) { (float)x, (float)y }, (Vector2) { (float)ox, (float)oy }, r, (float)font->baseSize * scale, spacing, *color);
+}
+
+void fontMeasure(WrenVM* vm)
+{
+    Font* font = (Font*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
+    const char* text = wrenGetSlotString(vm, 1);
+    wrenSetSlotDouble(vm, 0, MeasureTextEx(*font, text, (float)font->baseSize, 0).x);
+}
+
+void fontGetSize(WrenVM* vm)
+{
+    Font* font = (Font*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, font->baseSize);
+}
+
+void cameraAllocate(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Camera2D));
+}
+
+void cameraNew(WrenVM* vm)
 {
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
     ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "thick");
-    ASSERT_SLOT_TYPE(vm, 6, FOREIGN, "color");
     int x = (int)wrenGetSlotDouble(vm, 1);
     int y = (int)wrenGetSlotDouble(vm, 2);
-    int width = (int)wrenGetSlotDouble(vm, 3);
-    int height = (int)wrenGetSlotDouble(vm, 4);
-    float thick = (float)wrenGetSlotDouble(vm, 5);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 6);
-    DrawRectangleLinesEx((Rectangle) { (float)x, (float)y, (float)width, (float)height }, thick, *color);
+    camera->target = (Vector2) { (float)x, (float)y };
+    camera->offset = (Vector2) { GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f };
+    camera->rotation = 0.0f;
+    camera->zoom = 1.0f;
 }
 
-void graphicsTriangle(WrenVM* vm)
+void cameraBegin(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x1");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y1");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "x2");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "y2");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "x3");
-    ASSERT_SLOT_TYPE(vm, 6, NUM, "y3");
-    ASSERT_SLOT_TYPE(vm, 7, FOREIGN, "color");
-    int x1 = (int)wrenGetSlotDouble(vm, 1);
-    int y1 = (int)wrenGetSlotDouble(vm, 2);
-    int x2 = (int)wrenGetSlotDouble(vm, 3);
-    int y2 = (int)wrenGetSlotDouble(vm, 4);
-    int x3 = (int)wrenGetSlotDouble(vm, 5);
-    int y3 = (int)wrenGetSlotDouble(vm, 6);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 7);
-    DrawTriangle((Vector2) { (float)x1, (float)y1 }, (Vector2) { (float)x2, (float)y2 }, (Vector2) { (float)x3, (float)y3 }, *color);
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    BeginMode2D(*camera);
 }
 
-void graphicsTriangleLines(WrenVM* vm)
+void cameraEnd(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x1");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y1");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "x2");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "y2");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "x3");
-    ASSERT_SLOT_TYPE(vm, 6, NUM, "y3");
-    ASSERT_SLOT_TYPE(vm, 7, FOREIGN, "color");
-    int x1 = (int)wrenGetSlotDouble(vm, 1);
-    int y1 = (int)wrenGetSlotDouble(vm, 2);
-    int x2 = (int)wrenGetSlotDouble(vm, 3);
-    int y2 = (int)wrenGetSlotDouble(vm, 4);
-    int x3 = (int)wrenGetSlotDouble(vm, 5);
-    int y3 = (int)wrenGetSlotDouble(vm, 6);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 7);
-    DrawTriangleLines((Vector2) { (float)x1, (float)y1 }, (Vector2) { (float)x2, (float)y2 }, (Vector2) { (float)x3, (float)y3 }, *color);
+    EndMode2D();
 }
 
-void graphicsPolygon(WrenVM* vm)
+void cameraScreenToWorld(WrenVM* vm)
 {
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
     ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "sides");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "radius");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "r");
-    ASSERT_SLOT_TYPE(vm, 6, FOREIGN, "color");
     int x = (int)wrenGetSlotDouble(vm, 1);
     int y = (int)wrenGetSlotDouble(vm, 2);
-    int sides = (int)wrenGetSlotDouble(vm, 3);
-    float radius = (float)wrenGetSlotDouble(vm, 4);
-    float r = (float)wrenGetSlotDouble(vm, 5);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 6);
-    DrawPoly((Vector2) { (float)x, (float)y }, sides, radius, r, *color);
+    Vector2 result = GetScreenToWorld2D((Vector2) { (float)x, (float)y }, *camera);
+    wrenSetSlotNewList(vm, 0);
+    wrenSetSlotDouble(vm, 1, result.x);
+    wrenSetSlotDouble(vm, 2, result.y);
+    wrenInsertInList(vm, 0, 0, 1);
+    wrenInsertInList(vm, 0, 1, 2);
 }
 
-void graphicsPolygonLines(WrenVM* vm)
+void cameraWorldToScreen(WrenVM* vm)
 {
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
     ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "sides");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "radius");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "r");
-    ASSERT_SLOT_TYPE(vm, 6, NUM, "thick");
-    ASSERT_SLOT_TYPE(vm, 7, FOREIGN, "color");
     int x = (int)wrenGetSlotDouble(vm, 1);
     int y = (int)wrenGetSlotDouble(vm, 2);
-    int sides = (int)wrenGetSlotDouble(vm, 3);
-    float radius = (float)wrenGetSlotDouble(vm, 4);
-    float r = (float)wrenGetSlotDouble(vm, 5);
-    float thick = (float)wrenGetSlotDouble(vm, 6);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 7);
-    DrawPolyLinesEx((Vector2) { (float)x, (float)y }, sides, radius, r, thick, *color);
+    Vector2 result = GetWorldToScreen2D((Vector2) { (float)x, (float)y }, *camera);
+    wrenSetSlotNewList(vm, 0);
+    wrenSetSlotDouble(vm, 1, result.x);
+    wrenSetSlotDouble(vm, 2, result.y);
+    wrenInsertInList(vm, 0, 0, 1);
+    wrenInsertInList(vm, 0, 1, 2);
 }
 
-void graphicsSetNoiseSeed(WrenVM* vm)
+void cameraGetX(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "seed");
-    int seed = (int)wrenGetSlotDouble(vm, 1);
-    setSeed(seed);
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, camera->target.x);
 }
 
-void graphicsSetLineSpacing(WrenVM* vm)
+void cameraGetY(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "spacing");
-    int spacing = (int)wrenGetSlotDouble(vm, 1);
-    SetTextLineSpacing(spacing);
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, camera->target.y);
 }
 
-struct ButtonMap {
-    MouseButton rl;
-    int mu;
-};
-
-struct KeyMap {
-    KeyboardKey rl;
-    int mu;
-};
-
-static struct ButtonMap buttonMap[] = {
-    { MOUSE_BUTTON_LEFT, MU_MOUSE_LEFT },
-    { MOUSE_BUTTON_RIGHT, MU_MOUSE_RIGHT },
-    { MOUSE_BUTTON_MIDDLE, MU_MOUSE_MIDDLE },
-    { -1, -1 }
-};
-
-static struct KeyMap keyMap[] = {
-    { KEY_LEFT_SHIFT, MU_KEY_SHIFT },
-    { KEY_RIGHT_SHIFT, MU_KEY_SHIFT },
-    { KEY_LEFT_CONTROL, MU_KEY_CTRL },
-    { KEY_RIGHT_CONTROL, MU_KEY_CTRL },
-    { KEY_LEFT_ALT, MU_KEY_ALT },
-    { KEY_RIGHT_ALT, MU_KEY_ALT },
-    { KEY_ENTER, MU_KEY_RETURN },
-    { KEY_KP_ENTER, MU_KEY_RETURN },
-    { KEY_BACKSPACE, MU_KEY_BACKSPACE },
-    { -1, -1 },
-};
-
-void uiUpdate(WrenVM* vm)
+void cameraGetOffsetX(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-
-    int x = GetMouseX();
-    int y = GetMouseY();
-    mu_input_mousemove(data->uiCtx, x, y);
-
-    Vector2 scroll = GetMouseWheelMoveV();
-    mu_input_scroll(data->uiCtx, scroll.x * -30, scroll.y * -30);
-
-    for (int i = 0;; i++) {
-        struct ButtonMap button = buttonMap[i];
-        if (button.rl == -1)
-            break;
-
-        if (IsMouseButtonPressed(button.rl))
-            mu_input_mousedown(data->uiCtx, x, y, button.mu);
-        else if (IsMouseButtonReleased(button.rl))
-            mu_input_mouseup(data->uiCtx, x, y, button.mu);
-    }
-
-    for (int i = 0;; i++) {
-        struct KeyMap key = keyMap[i];
-        if (key.rl == -1)
-            break;
-
-        if (IsKeyPressed(key.rl))
-            mu_input_keydown(data->uiCtx, key.mu);
-        else if (IsKeyReleased(key.rl))
-            mu_input_keyup(data->uiCtx, key.mu);
-    }
-
-    char buffer[512];
-    for (int i = 0; i < 512; i++) {
-        char c = GetCharPressed();
-        buffer[i] = c;
-        if (c == '\0')
-            break;
-    }
-    mu_input_text(data->uiCtx, buffer);
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, camera->offset.x);
 }
 
-void uiDraw(WrenVM* vm)
+void cameraGetOffsetY(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    BeginScissorMode(0, 0, GetScreenWidth(), GetScreenHeight());
-
-    mu_Command* cmd = NULL;
-    while (mu_next_command(data->uiCtx, &cmd)) {
-        switch (cmd->type) {
-        case MU_COMMAND_TEXT:
-            DrawTextEx(defaultFont, cmd->text.str, (Vector2) { (float)cmd->text.pos.x, (float)cmd->text.pos.y }, defaultFont.baseSize, 1, (Color) { cmd->text.color.r, cmd->text.color.g, cmd->text.color.b, cmd->text.color.a });
-            break;
-        case MU_COMMAND_RECT:
-            DrawRectangle(cmd->rect.rect.x, cmd->rect.rect.y, cmd->rect.rect.w, cmd->rect.rect.h, (Color) { cmd->rect.color.r, cmd->rect.color.g, cmd->rect.color.b, cmd->rect.color.a });
-            break;
-        case MU_COMMAND_ICON:
-            Color color = (Color) { cmd->icon.color.r, cmd->icon.color.g, cmd->icon.color.b, cmd->icon.color.a };
-
-            switch (cmd->icon.id) {
-            case MU_ICON_CLOSE:
-                DrawLine(cmd->icon.rect.x + 8, cmd->icon.rect.y + 8, cmd->icon.rect.x + cmd->icon.rect.w - 8, cmd->icon.rect.y + cmd->icon.rect.h - 8, color);
-                DrawLine(cmd->icon.rect.x + cmd->icon.rect.w - 8, cmd->icon.rect.y + 8, cmd->icon.rect.x + 8, cmd->icon.rect.y + cmd->icon.rect.h - 8, color);
-                break;
-            case MU_ICON_CHECK:
-                DrawLine(cmd->icon.rect.x + 5, cmd->icon.rect.y + 5, cmd->icon.rect.x + cmd->icon.rect.w - 5, cmd->icon.rect.y + cmd->icon.rect.h - 5, color);
-                DrawLine(cmd->icon.rect.x + cmd->icon.rect.w - 5, cmd->icon.rect.y + 5, cmd->icon.rect.x + 5, cmd->icon.rect.y + cmd->icon.rect.h - 5, color);
-                break;
-            case MU_ICON_COLLAPSED:
-                DrawLine(cmd->icon.rect.x + 6, cmd->icon.rect.y + 6, cmd->icon.rect.x + cmd->icon.rect.w / 2, cmd->icon.rect.y + cmd->icon.rect.h / 2, color);
-                DrawLine(cmd->icon.rect.x + 6, cmd->icon.rect.y + cmd->icon.rect.h - 6, cmd->icon.rect.x + cmd->icon.rect.w / 2, cmd->icon.rect.y + cmd->icon.rect.h / 2, color);
-                break;
-            case MU_ICON_EXPANDED:
-                DrawLine(cmd->icon.rect.x + 6, cmd->icon.rect.y + 6, cmd->icon.rect.x + cmd->icon.rect.w / 2, cmd->icon.rect.y + cmd->icon.rect.h / 2, color);
-                DrawLine(cmd->icon.rect.x + cmd->icon.rect.w - 6, cmd->icon.rect.y + 6, cmd->icon.rect.x + cmd->icon.rect.w / 2, cmd->icon.rect.y + cmd->icon.rect.h / 2, color);
-                break;
-            }
-
-            break;
-        case MU_COMMAND_CLIP:
-            EndScissorMode();
-            BeginScissorMode(cmd->clip.rect.x, cmd->clip.rect.y, cmd->clip.rect.w, cmd->clip.rect.h);
-            break;
-        }
-    }
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, camera->offset.y);
+}
 
-    EndScissorMode();
+void cameraGetRotation(WrenVM* vm)
+{
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, camera->rotation);
 }
 
-void uiBegin(WrenVM* vm)
+void cameraGetZoom(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    mu_begin(data->uiCtx);
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, camera->zoom);
 }
 
-void uiEnd(WrenVM* vm)
+void cameraSetX(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    mu_end(data->uiCtx);
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    camera->target.x = (float)x;
 }
 
-void uiBeginWindow(WrenVM* vm)
+void cameraSetY(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "title");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "height");
-    const char* title = wrenGetSlotString(vm, 1);
-    int x = (int)wrenGetSlotDouble(vm, 2);
-    int y = (int)wrenGetSlotDouble(vm, 3);
-    int width = (int)wrenGetSlotDouble(vm, 4);
-    int height = (int)wrenGetSlotDouble(vm, 5);
-    wrenSetSlotBool(vm, 0, mu_begin_window(data->uiCtx, title, mu_rect(x, y, width, height)));
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "y");
+    int y = (int)wrenGetSlotDouble(vm, 1);
+    camera->target.y = (float)y;
 }
 
-void uiEndWindow(WrenVM* vm)
+void cameraSetOffsetX(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    mu_end_window(data->uiCtx);
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "ox");
+    int ox = (int)wrenGetSlotDouble(vm, 1);
+    camera->offset.x = (float)ox;
 }
 
-void uiLabel(WrenVM* vm)
+void cameraSetOffsetY(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
-    const char* text = wrenGetSlotString(vm, 1);
-    mu_label(data->uiCtx, text);
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "oy");
+    int oy = (int)wrenGetSlotDouble(vm, 1);
+    camera->offset.y = (float)oy;
 }
 
-void uiHeader(WrenVM* vm)
+void cameraSetRotation(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
-    ASSERT_SLOT_TYPE(vm, 2, STRING, "option");
-    const char* text = wrenGetSlotString(vm, 1);
-    const char* option = wrenGetSlotString(vm, 2);
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "r");
+    float r = (float)wrenGetSlotDouble(vm, 1);
+    camera->rotation = r;
+}
 
-    int opt;
-    if (TextIsEqual(option, "expanded")) {
-        opt = MU_OPT_EXPANDED;
-    } else {
-        opt = 0;
-    }
+void cameraSetZoom(WrenVM* vm)
+{
+    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "zoom");
+    float zoom = (float)wrenGetSlotDouble(vm, 1);
+    camera->zoom = zoom;
+}
 
-    wrenSetSlotBool(vm, 0, mu_header_ex(data->uiCtx, text, opt));
+void shaderAllocate(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Shader));
 }
 
-void uiButton(WrenVM* vm)
+void shaderFinalize(void* data)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
-    const char* text = wrenGetSlotString(vm, 1);
-    wrenSetSlotBool(vm, 0, mu_button(data->uiCtx, text));
+    Shader* shader = (Shader*)data;
+    reloadForget(shader);
+    UnloadShader(*shader);
 }
 
-void uiRow(WrenVM* vm)
+void shaderNew(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "items");
-    ASSERT_SLOT_TYPE(vm, 2, LIST, "widths");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "height");
-    int items = (int)wrenGetSlotDouble(vm, 1);
+    Shader* shader = (Shader*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "vs");
+    ASSERT_SLOT_TYPE(vm, 2, STRING, "fs");
+    const char* vs = wrenGetSlotString(vm, 1);
+    const char* fs = wrenGetSlotString(vm, 2);
 
-    int count = wrenGetListCount(vm, 2);
-    int* widths = malloc(count * sizeof(int));
-    for (int i = 0; i < count; i++) {
-        wrenGetListElement(vm, 2, i, 1);
-        widths[i] = (int)wrenGetSlotDouble(vm, 1);
+    if (!IsWindowReady()) {
+        VM_ABORT(vm, "Cannot load shader before window initialization.");
+        return;
     }
 
-    int height = (int)wrenGetSlotDouble(vm, 3);
-    mu_layout_row(data->uiCtx, items, widths, height);
-    free(widths);
-}
+    *shader = LoadShader(vs, fs);
+    if (!IsShaderReady(*shader)) {
+        VM_ABORT(vm, "Failed to load shader.");
+        return;
+    }
 
-void uiTextbox(WrenVM* vm)
-{
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "buffer");
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
-    wrenSetSlotBool(vm, 0, mu_textbox(data->uiCtx, buffer->data, buffer->size) & MU_RES_SUBMIT);
+    reloadTrack(RELOAD_SHADER, shader, vs, fs, 0);
 }
 
-void uiGetWindowInfo(WrenVM* vm)
+void shaderNew2(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    mu_Container* win = mu_get_current_container(data->uiCtx);
-
-    wrenEnsureSlots(vm, 3);
-    wrenSetSlotNewMap(vm, 0);
+    Shader* shader = (Shader*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "fs");
+    const char* fs = wrenGetSlotString(vm, 1);
 
-    wrenSetSlotString(vm, 1, "x");
-    wrenSetSlotDouble(vm, 2, win->rect.x);
-    wrenSetMapValue(vm, 0, 1, 2);
+    if (!IsWindowReady()) {
+        VM_ABORT(vm, "Cannot load shader before window initialization.");
+        return;
+    }
 
-    wrenSetSlotString(vm, 1, "y");
-    wrenSetSlotDouble(vm, 2, win->rect.y);
-    wrenSetMapValue(vm, 0, 1, 2);
+    *shader = LoadShader(NULL, fs);
+    if (!IsShaderReady(*shader)) {
+        VM_ABORT(vm, "Failed to load shader.");
+        return;
+    }
 
-    wrenSetSlotString(vm, 1, "width");
-    wrenSetSlotDouble(vm, 2, win->rect.w);
-    wrenSetMapValue(vm, 0, 1, 2);
+    reloadTrack(RELOAD_SHADER, shader, "", fs, 0);
+}
 
-    wrenSetSlotString(vm, 1, "height");
-    wrenSetSlotDouble(vm, 2, win->rect.h);
-    wrenSetMapValue(vm, 0, 1, 2);
+void shaderNew3(WrenVM* vm)
+{
+    Shader* shader = (Shader*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "vs");
+    ASSERT_SLOT_TYPE(vm, 2, STRING, "fs");
+    const char* vs = wrenGetSlotString(vm, 1);
+    const char* fs = wrenGetSlotString(vm, 2);
 
-    wrenSetSlotString(vm, 1, "scrollX");
-    wrenSetSlotDouble(vm, 2, win->scroll.x);
-    wrenSetMapValue(vm, 0, 1, 2);
+    if (!IsWindowReady()) {
+        VM_ABORT(vm, "Cannot load shader before window initialization.");
+        return;
+    }
 
-    wrenSetSlotString(vm, 1, "scrollY");
-    wrenSetSlotDouble(vm, 2, win->scroll.y);
-    wrenSetMapValue(vm, 0, 1, 2);
+    *shader = LoadShaderFromMemory(vs, fs);
+    if (!IsShaderReady(*shader)) {
+        VM_ABORT(vm, "Failed to load shader.");
+        return;
+    }
 }
 
-void uiSetWindowSize(WrenVM* vm)
+void shaderNew4(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
-    int width = (int)wrenGetSlotDouble(vm, 1);
-    int height = (int)wrenGetSlotDouble(vm, 2);
-    mu_Container* win = mu_get_current_container(data->uiCtx);
-    win->rect.w = width;
-    win->rect.h = height;
-}
+    Shader* shader = (Shader*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "fs");
+    const char* fs = wrenGetSlotString(vm, 1);
 
-void uiOpenPopup(WrenVM* vm)
-{
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "name");
-    const char* name = wrenGetSlotString(vm, 1);
-    mu_open_popup(data->uiCtx, name);
-}
+    if (!IsWindowReady()) {
+        VM_ABORT(vm, "Cannot load shader before window initialization.");
+        return;
+    }
 
-void uiBeginPopup(WrenVM* vm)
-{
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "name");
-    const char* name = wrenGetSlotString(vm, 1);
-    wrenSetSlotBool(vm, 0, mu_begin_popup(data->uiCtx, name));
+    *shader = LoadShaderFromMemory(NULL, fs);
+    if (!IsShaderReady(*shader)) {
+        VM_ABORT(vm, "Failed to load shader.");
+        return;
+    }
 }
 
-void uiEndPopup(WrenVM* vm)
+void shaderBegin(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    mu_end_popup(data->uiCtx);
+    Shader* shader = (Shader*)wrenGetSlotForeign(vm, 0);
+    BeginShaderMode(*shader);
 }
 
-void uiBeginColumn(WrenVM* vm)
+void shaderEnd(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    mu_layout_begin_column(data->uiCtx);
+    EndShaderMode();
 }
 
-void uiEndColumn(WrenVM* vm)
+void shaderSet(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    mu_layout_end_column(data->uiCtx);
-}
+    Shader* shader = (Shader*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "name");
+    const char* name = wrenGetSlotString(vm, 1);
 
-void uiSlider(WrenVM* vm)
-{
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "buffer");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "min");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "max");
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
-    int min = (int)wrenGetSlotDouble(vm, 3);
-    int max = (int)wrenGetSlotDouble(vm, 4);
+    if (wrenGetSlotType(vm, 2) == WREN_TYPE_NUM) {
+        float value = (float)wrenGetSlotDouble(vm, 2);
+        SetShaderValue(*shader, GetShaderLocation(*shader, name), &value, SHADER_UNIFORM_FLOAT);
+    } else if (wrenGetSlotType(vm, 2) == WREN_TYPE_LIST) {
+        wrenEnsureSlots(vm, 4);
+        int count = wrenGetListCount(vm, 2);
 
-    if (offset < 0 || offset >= buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+        if (count == 2) {
+            float vec[2];
+            wrenGetListElement(vm, 2, 0, 3);
+            vec[0] = (float)wrenGetSlotDouble(vm, 3);
+            wrenGetListElement(vm, 2, 1, 3);
+            vec[1] = (float)wrenGetSlotDouble(vm, 3);
+            SetShaderValue(*shader, GetShaderLocation(*shader, name), vec, SHADER_UNIFORM_VEC2);
+        } else if (count == 3) {
+            float vec[3];
+            wrenGetListElement(vm, 2, 0, 3);
+            vec[0] = (float)wrenGetSlotDouble(vm, 3);
+            wrenGetListElement(vm, 2, 1, 3);
+            vec[1] = (float)wrenGetSlotDouble(vm, 3);
+            wrenGetListElement(vm, 2, 2, 3);
+            vec[2] = (float)wrenGetSlotDouble(vm, 3);
+            SetShaderValue(*shader, GetShaderLocation(*shader, name), vec, SHADER_UNIFORM_VEC3);
+        } else if (count == 4) {
+            float vec[4];
+            wrenGetListElement(vm, 2, 0, 3);
+            vec[0] = (float)wrenGetSlotDouble(vm, 3);
+            wrenGetListElement(vm, 2, 1, 3);
+            vec[1] = (float)wrenGetSlotDouble(vm, 3);
+            wrenGetListElement(vm, 2, 2, 3);
+            vec[2] = (float)wrenGetSlotDouble(vm, 3);
+            wrenGetListElement(vm, 2, 3, 3);
+            vec[3] = (float)wrenGetSlotDouble(vm, 3);
+            SetShaderValue(*shader, GetShaderLocation(*shader, name), vec, SHADER_UNIFORM_VEC4);
+        } else {
+            VM_ABORT(vm, "Invalid argument count.");
+            return;
+        }
+    } else if (wrenGetSlotType(vm, 2) == WREN_TYPE_FOREIGN) {
+        Texture* texture = (Texture*)wrenGetSlotForeign(vm, 2);
+        SetShaderValueTexture(*shader, GetShaderLocation(*shader, name), *texture);
+    } else {
+        VM_ABORT(vm, "Invalid argument type.");
         return;
     }
-
-    mu_slider(data->uiCtx, (float*)(&buffer->data[offset]), min, max);
 }
 
-void uiNext(WrenVM* vm)
-{
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    wrenEnsureSlots(vm, 2);
-    wrenSetSlotNewList(vm, 0);
-
-    mu_Rect r = mu_layout_next(data->uiCtx);
+#define POSTFX_MAX_TARGETS 8
 
-    wrenSetSlotDouble(vm, 1, r.x);
-    wrenInsertInList(vm, 0, 0, 1);
+// Render targets are kept across frames and only remade when the window size changes.
+typedef struct {
+    RenderTexture targets[POSTFX_MAX_TARGETS];
+    int count;
+    int width, height; // Screen size the targets were made for
+    int scene;         // Target the scene was drawn into, kept for passes that read it
+    int current;       // Target holding the latest result, -1 before begin
+} PostFX;
 
-    wrenSetSlotDouble(vm, 1, r.y);
-    wrenInsertInList(vm, 0, 1, 1);
+void postFXAllocate(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    PostFX* fx = (PostFX*)wrenSetSlotNewForeign(vm, 0, 0, sizeof(PostFX));
+    fx->scene = -1;
+    fx->current = -1;
+}
 
-    wrenSetSlotDouble(vm, 1, r.w);
-    wrenInsertInList(vm, 0, 2, 1);
+static void unloadTargets(PostFX* fx)
+{
+    for (int i = 0; i < fx->count; i++)
+        UnloadRenderTexture(fx->targets[i]);
 
-    wrenSetSlotDouble(vm, 1, r.h);
-    wrenInsertInList(vm, 0, 3, 1);
+    fx->count = 0;
+    fx->scene = -1;
+    fx->current = -1;
 }
 
-void uiDrawRect(WrenVM* vm)
+void postFXFinalize(void* data)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
-    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "color");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    int width = (int)wrenGetSlotDouble(vm, 3);
-    int height = (int)wrenGetSlotDouble(vm, 4);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 5);
-    mu_draw_rect(data->uiCtx, mu_rect(x, y, width, height), mu_color(color->r, color->g, color->b, color->a));
+    unloadTargets((PostFX*)data);
 }
 
-void uiDrawText(WrenVM* vm)
+void postFXNew(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "height");
-    const char* text = wrenGetSlotString(vm, 1);
-    int x = (int)wrenGetSlotDouble(vm, 2);
-    int y = (int)wrenGetSlotDouble(vm, 3);
-    int width = (int)wrenGetSlotDouble(vm, 4);
-    int height = (int)wrenGetSlotDouble(vm, 5);
-    mu_draw_control_text(data->uiCtx, text, mu_rect(x, y, width, height), MU_COLOR_TEXT, MU_OPT_ALIGNCENTER);
+    if (!IsWindowReady()) {
+        VM_ABORT(vm, "Cannot create post-processing before window initialization.");
+        return;
+    }
 }
 
-void uiBeginTreenode(WrenVM* vm)
+// Finds a target of the given size that holds neither the scene nor the latest result, making one if needed.
+static int acquireTarget(PostFX* fx, int width, int height)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
-    const char* text = wrenGetSlotString(vm, 1);
-    wrenSetSlotBool(vm, 0, mu_begin_treenode(data->uiCtx, text));
+    for (int i = 0; i < fx->count; i++) {
+        if (i != fx->scene && i != fx->current && fx->targets[i].texture.width == width && fx->targets[i].texture.height == height)
+            return i;
+    }
+
+    if (fx->count == POSTFX_MAX_TARGETS)
+        return -1;
+
+    RenderTexture target = LoadRenderTexture(width, height);
+    if (!IsRenderTextureReady(target))
+        return -1;
+
+    // Half resolution passes are scaled up and down, so sample between pixels.
+    SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+
+    fx->targets[fx->count] = target;
+    return fx->count++;
 }
 
-void uiEndTreenode(WrenVM* vm)
+static void endTarget()
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    mu_end_treenode(data->uiCtx);
+    EndTextureMode();
+    headlessResume();
 }
 
-void uiCheckbox(WrenVM* vm)
+// Draws the latest result through the shader, into dst or the screen if dst is NULL.
+static void runPass(PostFX* fx, Shader* shader, const char* sceneUniform, RenderTexture* dst, int width, int height)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
-    ASSERT_SLOT_TYPE(vm, 2, FOREIGN, "buffer");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "offset");
-    const char* text = wrenGetSlotString(vm, 1);
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 2);
-    int offset = (int)wrenGetSlotDouble(vm, 3);
+    Texture source = fx->targets[fx->current].texture;
 
-    if (offset < 0 || offset >= buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
-        return;
+    if (dst) {
+        BeginTextureMode(*dst);
+        ClearBackground(BLANK);
     }
 
-    wrenSetSlotBool(vm, 0, mu_checkbox(data->uiCtx, text, (int*)(&buffer->data[offset])));
+    if (shader) {
+        BeginShaderMode(*shader);
+
+        // Samplers only stay bound for the draw that follows, so this has to happen inside shader mode.
+        if (sceneUniform)
+            SetShaderValueTexture(*shader, GetShaderLocation(*shader, sceneUniform), fx->targets[fx->scene].texture);
+    }
+
+    // Render textures are stored upside down.
+    Rectangle src = { 0.0f, 0.0f, (float)source.width, (float)-source.height };
+    Rectangle dest = { 0.0f, 0.0f, (float)width, (float)height };
+    DrawTexturePro(source, src, dest, (Vector2) { 0.0f, 0.0f }, 0.0f, WHITE);
+
+    if (shader)
+        EndShaderMode();
+
+    if (dst)
+        endTarget();
 }
 
-void uiText(WrenVM* vm)
+void postFXBegin(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
+    PostFX* fx = (PostFX*)wrenGetSlotForeign(vm, 0);
+    int width = GetScreenWidth();
+    int height = GetScreenHeight();
 
-    if (wrenGetSlotType(vm, 1) == WREN_TYPE_STRING) {
-        const char* text = wrenGetSlotString(vm, 1);
-        mu_text(data->uiCtx, text);
-    } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_FOREIGN) {
-        Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
-        mu_text(data->uiCtx, (const char*)buffer->data);
+    if (width != fx->width || height != fx->height) {
+        unloadTargets(fx);
+        fx->width = width;
+        fx->height = height;
     }
+
+    // Last frame's results are free to be drawn over.
+    fx->scene = -1;
+    fx->current = -1;
+    fx->scene = acquireTarget(fx, width, height);
+
+    if (fx->scene < 0) {
+        VM_ABORT(vm, "Failed to load render target.");
+        return;
+    }
+
+    fx->current = fx->scene;
+    BeginTextureMode(fx->targets[fx->scene]);
 }
 
-void uiBeginPanel(WrenVM* vm)
+void postFXEnd(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "name");
-    const char* name = wrenGetSlotString(vm, 1);
-    mu_begin_panel(data->uiCtx, name);
+    endTarget();
 }
 
-void uiEndPanel(WrenVM* vm)
+// Reads the optional shader and scene uniform name of a pass, either may be null.
+static bool getPass(WrenVM* vm, PostFX* fx, int shaderSlot, int sceneSlot, Shader** shader, const char** sceneUniform)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    mu_end_panel(data->uiCtx);
+    if (fx->current < 0) {
+        VM_ABORT(vm, "Post-processing has not begun.");
+        return false;
+    }
+
+    *shader = NULL;
+    if (wrenGetSlotType(vm, shaderSlot) == WREN_TYPE_FOREIGN) {
+        *shader = (Shader*)wrenGetSlotForeign(vm, shaderSlot);
+    } else if (wrenGetSlotType(vm, shaderSlot) != WREN_TYPE_NULL) {
+        VM_ABORT(vm, "Expected shader to be of type FOREIGN.");
+        return false;
+    }
+
+    *sceneUniform = NULL;
+    if (wrenGetSlotType(vm, sceneSlot) == WREN_TYPE_STRING) {
+        *sceneUniform = wrenGetSlotString(vm, sceneSlot);
+    } else if (wrenGetSlotType(vm, sceneSlot) != WREN_TYPE_NULL) {
+        VM_ABORT(vm, "Expected scene to be of type STRING.");
+        return false;
+    }
+
+    return true;
 }
 
-void uiFocus(WrenVM* vm)
+void postFXApply(WrenVM* vm)
 {
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    mu_set_focus(data->uiCtx, data->uiCtx->last_id);
+    PostFX* fx = (PostFX*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "scale");
+    float scale = (float)wrenGetSlotDouble(vm, 2);
+
+    if (scale <= 0.0f || scale > 1.0f) {
+        VM_ABORT(vm, "Scale must be between 0.0 and 1.0.");
+        return;
+    }
+
+    Shader* shader;
+    const char* sceneUniform;
+    if (!getPass(vm, fx, 1, 3, &shader, &sceneUniform))
+        return;
+
+    int width = (int)(fx->width * scale) > 0 ? (int)(fx->width * scale) : 1;
+    int height = (int)(fx->height * scale) > 0 ? (int)(fx->height * scale) : 1;
+
+    int target = acquireTarget(fx, width, height);
+    if (target < 0) {
+        VM_ABORT(vm, "Failed to load render target.");
+        return;
+    }
+
+    runPass(fx, shader, sceneUniform, &fx->targets[target], width, height);
+    fx->current = target;
 }
 
-void colorAllocate(WrenVM* vm)
+void postFXDraw(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Color));
+    PostFX* fx = (PostFX*)wrenGetSlotForeign(vm, 0);
+
+    Shader* shader;
+    const char* sceneUniform;
+    if (!getPass(vm, fx, 1, 2, &shader, &sceneUniform))
+        return;
+
+    runPass(fx, shader, sceneUniform, NULL, GetScreenWidth(), GetScreenHeight());
 }
 
-void colorNew(WrenVM* vm)
+void postFXGetTargets(WrenVM* vm)
 {
-    Color* color = (Color*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "r");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "g");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "b");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "a");
-    int r = (int)wrenGetSlotDouble(vm, 1);
-    int g = (int)wrenGetSlotDouble(vm, 2);
-    int b = (int)wrenGetSlotDouble(vm, 3);
-    int a = (int)wrenGetSlotDouble(vm, 4);
-    color->r = r;
-    color->g = g;
-    color->b = b;
-    color->a = a;
+    PostFX* fx = (PostFX*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, fx->count);
 }
 
-void colorNew2(WrenVM* vm)
+// Input
+
+void keyboardPressed(WrenVM* vm)
 {
-    Color* color = (Color*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "r");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "g");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "b");
-    int r = (int)wrenGetSlotDouble(vm, 1);
-    int g = (int)wrenGetSlotDouble(vm, 2);
-    int b = (int)wrenGetSlotDouble(vm, 3);
-    color->r = r;
-    color->g = g;
-    color->b = b;
-    color->a = 255;
+    if (!IsWindowReady())
+        return;
+
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "key");
+    const char* key = wrenGetSlotString(vm, 1);
+
+    vmData* data = (vmData*)wrenGetUserData(vm);
+
+    KeyboardKey k = *map_get(&data->keys, key);
+    if (k == KEY_NULL) {
+        VM_ABORT(vm, "Invalid key.");
+        return;
+    }
+
+    wrenSetSlotBool(vm, 0, IsKeyPressed(k));
 }
 
-void colorGetIndex(WrenVM* vm)
+void keyboardPressedRepeat(WrenVM* vm)
 {
-    unsigned char* color = (unsigned char*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "index");
-    int index = (int)wrenGetSlotDouble(vm, 1);
+    if (!IsWindowReady())
+        return;
 
-    if (index < 0 || index > 3) {
-        VM_ABORT(vm, "Invalid color index.");
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "key");
+    const char* key = wrenGetSlotString(vm, 1);
+
+    vmData* data = (vmData*)wrenGetUserData(vm);
+
+    KeyboardKey k = *map_get(&data->keys, key);
+    if (k == KEY_NULL) {
+        VM_ABORT(vm, "Invalid key.");
         return;
     }
 
-    wrenSetSlotDouble(vm, 0, color[index]);
+    wrenSetSlotBool(vm, 0, IsKeyPressedRepeat(k));
 }
 
-void colorSetIndex(WrenVM* vm)
+void keyboardDown(WrenVM* vm)
 {
-    unsigned char* color = (unsigned char*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "index");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "value");
-    int index = (int)wrenGetSlotDouble(vm, 1);
-    int value = (int)wrenGetSlotDouble(vm, 2);
+    if (!IsWindowReady())
+        return;
 
-    if (index < 0 || index > 3) {
-        VM_ABORT(vm, "Invalid color index.");
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "key");
+    const char* key = wrenGetSlotString(vm, 1);
+
+    vmData* data = (vmData*)wrenGetUserData(vm);
+
+    KeyboardKey k = *map_get(&data->keys, key);
+    if (k == KEY_NULL) {
+        VM_ABORT(vm, "Invalid key.");
         return;
     }
 
-    color[index] = value;
+    wrenSetSlotBool(vm, 0, IsKeyDown(k));
 }
 
-void imageAllocate(WrenVM* vm)
+void keyboardReleased(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Image));
+    if (!IsWindowReady())
+        return;
+
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "key");
+    const char* key = wrenGetSlotString(vm, 1);
+
+    vmData* data = (vmData*)wrenGetUserData(vm);
+
+    KeyboardKey k = *map_get(&data->keys, key);
+    if (k == KEY_NULL) {
+        VM_ABORT(vm, "Invalid key.");
+        return;
+    }
+
+    wrenSetSlotBool(vm, 0, IsKeyReleased(k));
 }
 
-void imageFinalize(void* data)
+void keyboardGetKeyPressed(WrenVM* vm)
 {
-    Image* image = (Image*)data;
-    UnloadImage(*image);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetKeyPressed());
 }
 
-void imageNew(WrenVM* vm)
+void keyboardGetCharPressed(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetCharPressed());
+}
 
-    if (wrenGetSlotType(vm, 1) == WREN_TYPE_STRING) {
-        const char* path = wrenGetSlotString(vm, 1);
+void mousePressed(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "button");
+    int button = (int)wrenGetSlotDouble(vm, 1);
+    wrenSetSlotBool(vm, 0, IsMouseButtonPressed(button));
+}
 
-        *image = LoadImage(path);
-        if (!IsImageReady(*image)) {
-            VM_ABORT(vm, "Failed to load image.");
-            return;
-        }
-    } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_FOREIGN) {
-        Texture* texture = (Texture*)wrenGetSlotForeign(vm, 1);
-        *image = LoadImageFromTexture(*texture);
-    } else {
-        VM_ABORT(vm, "Invalid image type.");
-        return;
-    }
+void mouseDown(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "button");
+    int button = (int)wrenGetSlotDouble(vm, 1);
+    wrenSetSlotBool(vm, 0, IsMouseButtonDown(button));
 }
 
-void imageNew2(WrenVM* vm)
+void mouseReleased(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
-    ASSERT_SLOT_TYPE(vm, 3, FOREIGN, "color");
-    int width = (int)wrenGetSlotDouble(vm, 1);
-    int height = (int)wrenGetSlotDouble(vm, 2);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 3);
-    *image = GenImageColor(width, height, *color);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "button");
+    int button = (int)wrenGetSlotDouble(vm, 1);
+    wrenSetSlotBool(vm, 0, IsMouseButtonReleased(button));
 }
 
-void imageNew3(WrenVM* vm)
+void mouseSetPosition(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "type");
-    ASSERT_SLOT_TYPE(vm, 2, STRING, "data");
-    const char* type = wrenGetSlotString(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    SetMousePosition(x, y);
+}
 
-    int length;
-    const char* data = wrenGetSlotBytes(vm, 2, &length);
-    *image = LoadImageFromMemory(type, data, length);
-    if (!IsImageReady(*image)) {
-        VM_ABORT(vm, "Failed to load image.");
-        return;
-    }
+void mouseSetOffset(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    SetMouseOffset(x, y);
 }
 
-void imageNew4(WrenVM* vm)
+void mouseSetScale(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    *image = LoadImageFromScreen();
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    float x = (float)wrenGetSlotDouble(vm, 1);
+    float y = (float)wrenGetSlotDouble(vm, 2);
+    SetMouseScale(x, y);
 }
 
-void imageNew5(WrenVM* vm)
+void mouseGetX(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "image");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "height");
-    Image* other = (Image*)wrenGetSlotForeign(vm, 1);
-    int x = (int)wrenGetSlotDouble(vm, 2);
-    int y = (int)wrenGetSlotDouble(vm, 3);
-    int width = (int)wrenGetSlotDouble(vm, 4);
-    int height = (int)wrenGetSlotDouble(vm, 5);
-    *image = ImageFromImage(*other, (Rectangle) { (float)x, (float)y, (float)width, (float)height });
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetMouseX());
 }
 
-void imageNew6(WrenVM* vm)
+void mouseGetY(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "size");
-    ASSERT_SLOT_TYPE(vm, 3, FOREIGN, "color");
-    const char* text = wrenGetSlotString(vm, 1);
-    int size = (int)wrenGetSlotDouble(vm, 2);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 3);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetMouseY());
+}
 
-    if (size < defaultFont.baseSize)
-        size = defaultFont.baseSize;
+void mouseGetDeltaX(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetMouseDelta().x);
+}
 
-    *image = ImageTextEx(defaultFont, text, size, size / defaultFont.baseSize, *color);
+void mouseGetDeltaY(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetMouseDelta().y);
 }
 
-void imageNew7(WrenVM* vm)
+void mouseGetWheel(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "direction");
-    ASSERT_SLOT_TYPE(vm, 4, FOREIGN, "startColor");
-    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "endColor");
-    int width = (int)wrenGetSlotDouble(vm, 1);
-    int height = (int)wrenGetSlotDouble(vm, 2);
-    int direction = (int)wrenGetSlotDouble(vm, 3);
-    Color* startColor = (Color*)wrenGetSlotForeign(vm, 4);
-    Color* endColor = (Color*)wrenGetSlotForeign(vm, 5);
-    *image = GenImageGradientLinear(width, height, direction, *startColor, *endColor);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetMouseWheelMove());
 }
 
-void imageNew8(WrenVM* vm)
+void mouseSetCursor(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "density");
-    ASSERT_SLOT_TYPE(vm, 4, FOREIGN, "innerColor");
-    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "outerColor");
-    int width = (int)wrenGetSlotDouble(vm, 1);
-    int height = (int)wrenGetSlotDouble(vm, 2);
-    float density = (float)wrenGetSlotDouble(vm, 3);
-    Color* innerColor = (Color*)wrenGetSlotForeign(vm, 4);
-    Color* outerColor = (Color*)wrenGetSlotForeign(vm, 5);
-    *image = GenImageGradientRadial(width, height, density, *innerColor, *outerColor);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "cursor");
+    const char* cursor = wrenGetSlotString(vm, 1);
+
+    if (TextIsEqual(cursor, "default"))
+        SetMouseCursor(MOUSE_CURSOR_DEFAULT);
+    else if (TextIsEqual(cursor, "arrow"))
+        SetMouseCursor(MOUSE_CURSOR_ARROW);
+    else if (TextIsEqual(cursor, "ibeam"))
+        SetMouseCursor(MOUSE_CURSOR_IBEAM);
+    else if (TextIsEqual(cursor, "crosshair"))
+        SetMouseCursor(MOUSE_CURSOR_CROSSHAIR);
+    else if (TextIsEqual(cursor, "pointingHand"))
+        SetMouseCursor(MOUSE_CURSOR_POINTING_HAND);
+    else if (TextIsEqual(cursor, "resizeEW"))
+        SetMouseCursor(MOUSE_CURSOR_RESIZE_EW);
+    else if (TextIsEqual(cursor, "resizeNS"))
+        SetMouseCursor(MOUSE_CURSOR_RESIZE_NS);
+    else if (TextIsEqual(cursor, "resizeNWSE"))
+        SetMouseCursor(MOUSE_CURSOR_RESIZE_NWSE);
+    else if (TextIsEqual(cursor, "resizeNESW"))
+        SetMouseCursor(MOUSE_CURSOR_RESIZE_NESW);
+    else if (TextIsEqual(cursor, "resizeAll"))
+        SetMouseCursor(MOUSE_CURSOR_RESIZE_ALL);
+    else if (TextIsEqual(cursor, "notAllowed"))
+        SetMouseCursor(MOUSE_CURSOR_NOT_ALLOWED);
+    else
+        VM_ABORT(vm, "Invalid cursor.");
 }
 
-void imageNew9(WrenVM* vm)
+void mouseGetHidden(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "density");
-    ASSERT_SLOT_TYPE(vm, 4, FOREIGN, "innerColor");
-    ASSERT_SLOT_TYPE(vm, 5, FOREIGN, "outerColor");
-    int width = (int)wrenGetSlotDouble(vm, 1);
-    int height = (int)wrenGetSlotDouble(vm, 2);
-    float density = (float)wrenGetSlotDouble(vm, 3);
-    Color* innerColor = (Color*)wrenGetSlotForeign(vm, 4);
-    Color* outerColor = (Color*)wrenGetSlotForeign(vm, 5);
-    *image = GenImageGradientSquare(width, height, density, *innerColor, *outerColor);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotBool(vm, 0, IsCursorHidden());
 }
 
-void imageExport(WrenVM* vm)
+void mouseSetHidden(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
-    const char* path = wrenGetSlotString(vm, 1);
-    wrenSetSlotBool(vm, 0, ExportImage(*image, path));
+    ASSERT_SLOT_TYPE(vm, 1, BOOL, "hidden");
+    bool hidden = wrenGetSlotBool(vm, 1);
+
+    if (hidden)
+        HideCursor();
+    else
+        ShowCursor();
 }
 
-void imageExportToMemory(WrenVM* vm)
+void mouseSetEnabled(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "type");
-    const char* type = wrenGetSlotString(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, BOOL, "enabled");
+    bool enabled = wrenGetSlotBool(vm, 1);
 
-    int length;
-    unsigned char* data = ExportImageToMemory(*image, type, &length);
-    wrenSetSlotBytes(vm, 0, data, length);
+    if (enabled)
+        EnableCursor();
+    else
+        DisableCursor();
 }
 
-void imageCrop(WrenVM* vm)
+void mouseGetOnScreen(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "height");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    int width = (int)wrenGetSlotDouble(vm, 3);
-    int height = (int)wrenGetSlotDouble(vm, 4);
-    ImageCrop(image, (Rectangle) { (float)x, (float)y, (float)width, (float)height });
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotBool(vm, 0, IsCursorOnScreen());
 }
 
-void imageResize(WrenVM* vm)
+void gamepadAllocate(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
-    int width = (int)wrenGetSlotDouble(vm, 1);
-    int height = (int)wrenGetSlotDouble(vm, 2);
-    ImageResize(image, width, height);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Gamepad));
 }
 
-void imageFlipVertical(WrenVM* vm)
+void gamepadNew(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ImageFlipVertical(image);
+    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "id");
+    int id = (int)wrenGetSlotDouble(vm, 1);
+
+    if (!IsGamepadAvailable(id)) {
+        VM_ABORT(vm, "Gamepad not available.");
+        return;
+    }
+
+    gamepad->id = id;
 }
 
-void imageFlipHorizontal(WrenVM* vm)
+void gamepadAvailable(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ImageFlipHorizontal(image);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "id");
+    int id = (int)wrenGetSlotDouble(vm, 1);
+    wrenSetSlotBool(vm, 0, IsGamepadAvailable(id));
 }
 
-void imageRotate(WrenVM* vm)
+void gamepadPressed(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "angle");
-    int angle = (int)wrenGetSlotDouble(vm, 1);
-    ImageRotate(image, angle);
+    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "button");
+    int button = (int)wrenGetSlotDouble(vm, 1);
+    wrenSetSlotBool(vm, 0, IsGamepadButtonPressed(gamepad->id, button));
 }
 
-void imageGetWidth(WrenVM* vm)
+void gamepadDown(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, image->width);
+    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "button");
+    int button = (int)wrenGetSlotDouble(vm, 1);
+    wrenSetSlotBool(vm, 0, IsGamepadButtonDown(gamepad->id, button));
 }
 
-void imageGetHeight(WrenVM* vm)
+void gamepadReleased(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, image->height);
+    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "button");
+    int button = (int)wrenGetSlotDouble(vm, 1);
+    wrenSetSlotBool(vm, 0, IsGamepadButtonReleased(gamepad->id, button));
 }
 
-void imageGetFormat(WrenVM* vm)
+void gamepadAxis(WrenVM* vm)
 {
-    Image* image = (Image*)wrenGetSlotForeign(vm, 0);
+    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "axis");
+    int axis = (int)wrenGetSlotDouble(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetGamepadAxisMovement(gamepad->id, axis));
+}
 
-    switch (image->format) {
-    case PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:
-        wrenSetSlotString(vm, 0, "grayscale");
-        break;
-    case PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
-        wrenSetSlotString(vm, 0, "grayscaleAlpha");
-        break;
-    case PIXELFORMAT_UNCOMPRESSED_R5G6B5:
-        wrenSetSlotString(vm, 0, "R5G6B5");
-        break;
-    case PIXELFORMAT_UNCOMPRESSED_R8G8B8:
-        wrenSetSlotString(vm, 0, "R8G8B8");
-        break;
-    case PIXELFORMAT_UNCOMPRESSED_R5G5B5A1:
-        wrenSetSlotString(vm, 0, "R5G5B5A1");
-        break;
-    case PIXELFORMAT_UNCOMPRESSED_R4G4B4A4:
-        wrenSetSlotString(vm, 0, "R4G4B4A4");
-        break;
-    case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8:
-        wrenSetSlotString(vm, 0, "R8G8B8A8");
-        break;
-    case PIXELFORMAT_UNCOMPRESSED_R32:
-        wrenSetSlotString(vm, 0, "R32");
-        break;
-    case PIXELFORMAT_UNCOMPRESSED_R32G32B32:
-        wrenSetSlotString(vm, 0, "R32G32B32");
-        break;
-    case PIXELFORMAT_UNCOMPRESSED_R32G32B32A32:
-        wrenSetSlotString(vm, 0, "R32G32B32A32");
-        break;
-    case PIXELFORMAT_UNCOMPRESSED_R16:
-        wrenSetSlotString(vm, 0, "R16");
-        break;
-    case PIXELFORMAT_UNCOMPRESSED_R16G16B16:
-        wrenSetSlotString(vm, 0, "R16G16B16");
-        break;
-    case PIXELFORMAT_UNCOMPRESSED_R16G16B16A16:
-        wrenSetSlotString(vm, 0, "R16G16B16A16");
-        break;
-    default:
-        wrenSetSlotString(vm, 0, "Unknown");
-        break;
-    }
+void gamepadGetId(WrenVM* vm)
+{
+    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, gamepad->id);
 }
 
-void textureAllocate(WrenVM* vm)
+void gamepadGetName(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Texture));
+    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotString(vm, 0, GetGamepadName(gamepad->id));
 }
 
-void textureFinalize(void* data)
+void gamepadGetAxisCount(WrenVM* vm)
 {
-    Texture* texture = (Texture*)data;
-    UnloadTexture(*texture);
+    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, GetGamepadAxisCount(gamepad->id));
 }
 
-void textureNew(WrenVM* vm)
+// System
+
+void windowInit(WrenVM* vm)
 {
-    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
+    ASSERT_SLOT_TYPE(vm, 3, STRING, "title");
+    int width = (int)wrenGetSlotDouble(vm, 1);
+    int height = (int)wrenGetSlotDouble(vm, 2);
+    const char* title = wrenGetSlotString(vm, 3);
 
-    if (!IsWindowReady()) {
-        VM_ABORT(vm, "Cannot load texture before window initialization.");
+    vmData* data = (vmData*)wrenGetUserData(vm);
+
+    // After a hot reload restart the window is still open, reuse it instead of opening another.
+    if (IsWindowReady()) {
+        SetWindowSize(width, height);
+        SetWindowTitle(title);
+        data->windowInit = true;
         return;
     }
 
-    if (wrenGetSlotType(vm, 1) == WREN_TYPE_STRING) {
-        const char* path = wrenGetSlotString(vm, 1);
+    if (headlessEnabled())
+        SetConfigFlags(FLAG_WINDOW_HIDDEN | FLAG_WINDOW_ALWAYS_RUN);
 
-        *texture = LoadTexture(path);
-        if (!IsTextureReady(*texture)) {
-            VM_ABORT(vm, "Failed to load texture.");
-            return;
-        }
-    } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_FOREIGN) {
-        Image* image = (Image*)wrenGetSlotForeign(vm, 1);
-        *texture = LoadTextureFromImage(*image);
-    } else {
-        VM_ABORT(vm, "Invalid texture type.");
+    InitWindow(width, height, title);
+    if (!IsWindowReady()) {
+        VM_ABORT(vm, "Failed to initialize window.");
         return;
     }
-}
-
-void textureDraw(WrenVM* vm)
-{
-    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "r");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "sx");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "sy");
-    ASSERT_SLOT_TYPE(vm, 6, NUM, "ox");
-    ASSERT_SLOT_TYPE(vm, 7, NUM, "oy");
-    ASSERT_SLOT_TYPE(vm, 8, FOREIGN, "color");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    float r = (float)wrenGetSlotDouble(vm, 3);
-    float sx = (float)wrenGetSlotDouble(vm, 4);
-    float sy = (float)wrenGetSlotDouble(vm, 5);
-    int ox = (int)wrenGetSlotDouble(vm, 6);
-    int oy = (int)wrenGetSlotDouble(vm, 7);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 8);
 
-    Rectangle source = { 0, 0, (float)texture->width, (float)texture->height };
+    Image icon = {
+        .data = ICON_DATA,
+        .width = ICON_WIDTH,
+        .height = ICON_HEIGHT,
+        .format = ICON_FORMAT,
+        .mipmaps = 1
+    };
 
-    if (sx < 0)
-        source.width = -source.width;
+    SetWindowIcon(icon);
+    SetExitKey(KEY_NULL);
 
-    if (sy < 0)
-        source.height = -source.height;
+    Image font = {
+        .data = FONT_DATA,
+        .width = FONT_WIDTH,
+        .height = FONT_HEIGHT,
+        .format = FONT_FORMAT,
+        .mipmaps = 1
+    };
 
-    float absSx = sx < 0 ? -sx : sx;
-    float absSy = sy < 0 ? -sy : sy;
+    defaultFont = LoadFontFromImage(font, MAGENTA, 32);
 
-    DrawTexturePro(*texture, source, (Rectangle) { (float)x, (float)y, (float)texture->width * absSx, (float)texture->height * absSy }, (Vector2) { (float)ox, (float)oy }, r, *color);
+    data->windowInit = true;
 }
 
-void textureDrawRec(WrenVM* vm)
+void windowToggleFullscreen(WrenVM* vm)
 {
-    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "srcX");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "srcY");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "srcWidth");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "srcHeight");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "dstX");
-    ASSERT_SLOT_TYPE(vm, 6, NUM, "dstY");
-    ASSERT_SLOT_TYPE(vm, 7, NUM, "r");
-    ASSERT_SLOT_TYPE(vm, 8, NUM, "sx");
-    ASSERT_SLOT_TYPE(vm, 9, NUM, "sy");
-    ASSERT_SLOT_TYPE(vm, 10, NUM, "ox");
-    ASSERT_SLOT_TYPE(vm, 11, NUM, "oy");
-    ASSERT_SLOT_TYPE(vm, 12, FOREIGN, "color");
-    int srcX = (int)wrenGetSlotDouble(vm, 1);
-    int srcY = (int)wrenGetSlotDouble(vm, 2);
-    int srcWidth = (int)wrenGetSlotDouble(vm, 3);
-    int srcHeight = (int)wrenGetSlotDouble(vm, 4);
-    int dstX = (int)wrenGetSlotDouble(vm, 5);
-    int dstY = (int)wrenGetSlotDouble(vm, 6);
-    float r = (float)wrenGetSlotDouble(vm, 7);
-    float sx = (float)wrenGetSlotDouble(vm, 8);
-    float sy = (float)wrenGetSlotDouble(vm, 9);
-    int ox = (int)wrenGetSlotDouble(vm, 10);
-    int oy = (int)wrenGetSlotDouble(vm, 11);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 12);
-
-    Rectangle source = { (float)srcX, (float)srcY, (float)srcWidth, (float)srcHeight };
-
-    if (sx < 0)
-        source.width = -source.width;
-
-    if (sy < 0)
-        source.height = -source.height;
-
-    float absSx = sx < 0 ? -sx : sx;
-    float absSy = sy < 0 ? -sy : sy;
-
-    DrawTexturePro(*texture, source, (Rectangle) { (float)dstX, (float)dstY, (float)srcWidth * absSx, (float)srcHeight * absSy }, (Vector2) { (float)ox, (float)oy }, r, *color);
+    ToggleFullscreen();
 }
 
-void textureGetWidth(WrenVM* vm)
+void windowToggleBorderless(WrenVM* vm)
 {
-    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, texture->width);
+    ToggleBorderlessWindowed();
 }
 
-void textureGetHeight(WrenVM* vm)
+void windowMaximize(WrenVM* vm)
 {
-    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, texture->height);
+    MaximizeWindow();
 }
 
-void textureSetFilter(WrenVM* vm)
+void windowMinimize(WrenVM* vm)
 {
-    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "filter");
-    const char* filter = wrenGetSlotString(vm, 1);
-
-    if (TextIsEqual(filter, "point"))
-        SetTextureFilter(*texture, TEXTURE_FILTER_POINT);
-    else if (TextIsEqual(filter, "bilinear"))
-        SetTextureFilter(*texture, TEXTURE_FILTER_BILINEAR);
-    else
-        VM_ABORT(vm, "Invalid texture filter.");
+    MinimizeWindow();
 }
 
-void textureSetWrap(WrenVM* vm)
+void windowRestore(WrenVM* vm)
 {
-    Texture* texture = (Texture*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "wrap");
-    const char* wrap = wrenGetSlotString(vm, 1);
-
-    if (TextIsEqual(wrap, "repeat"))
-        SetTextureWrap(*texture, TEXTURE_WRAP_REPEAT);
-    else if (TextIsEqual(wrap, "clamp"))
-        SetTextureWrap(*texture, TEXTURE_WRAP_CLAMP);
-    else
-        VM_ABORT(vm, "Invalid texture wrap.");
+    RestoreWindow();
 }
 
-void renderTextureAllocate(WrenVM* vm)
+void windowSetPosition(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotNewForeign(vm, 0, 0, sizeof(RenderTexture));
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
+    int x = (int)wrenGetSlotDouble(vm, 1);
+    int y = (int)wrenGetSlotDouble(vm, 2);
+    SetWindowPosition(x, y);
 }
 
-void renderTextureFinalize(void* data)
+void windowSetMinSize(WrenVM* vm)
 {
-    RenderTexture* texture = (RenderTexture*)data;
-    UnloadRenderTexture(*texture);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
+    int width = (int)wrenGetSlotDouble(vm, 1);
+    int height = (int)wrenGetSlotDouble(vm, 2);
+    SetWindowMinSize(width, height);
 }
 
-void renderTextureNew(WrenVM* vm)
+void windowSetMaxSize(WrenVM* vm)
 {
-    RenderTexture* texture = (RenderTexture*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
     ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
     int width = (int)wrenGetSlotDouble(vm, 1);
     int height = (int)wrenGetSlotDouble(vm, 2);
+    SetWindowMaxSize(width, height);
+}
 
-    if (!IsWindowReady()) {
-        VM_ABORT(vm, "Cannot load texture before window initialization.");
-        return;
-    }
-
-    *texture = LoadRenderTexture(width, height);
-    if (!IsRenderTextureReady(*texture)) {
-        VM_ABORT(vm, "Failed to load texture.");
-        return;
-    }
+void windowSetSize(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
+    int width = (int)wrenGetSlotDouble(vm, 1);
+    int height = (int)wrenGetSlotDouble(vm, 2);
+    SetWindowSize(width, height);
 }
 
-void renderTextureBegin(WrenVM* vm)
+void windowFocus(WrenVM* vm)
 {
-    RenderTexture* texture = (RenderTexture*)wrenGetSlotForeign(vm, 0);
-    BeginTextureMode(*texture);
+    SetWindowFocused();
 }
 
-void renderTextureEnd(WrenVM* vm)
+void windowGetMonitorInfo(WrenVM* vm)
 {
-    EndTextureMode();
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "monitor");
+    int monitor = (int)wrenGetSlotDouble(vm, 1);
+
+    wrenEnsureSlots(vm, 3);
+    wrenSetSlotNewMap(vm, 0);
+
+    wrenSetSlotString(vm, 1, "name");
+    wrenSetSlotString(vm, 2, GetMonitorName(monitor));
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "x");
+    wrenSetSlotDouble(vm, 2, GetMonitorPosition(monitor).x);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "y");
+    wrenSetSlotDouble(vm, 2, GetMonitorPosition(monitor).y);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "width");
+    wrenSetSlotDouble(vm, 2, GetMonitorWidth(monitor));
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "height");
+    wrenSetSlotDouble(vm, 2, GetMonitorHeight(monitor));
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "physicalWidth");
+    wrenSetSlotDouble(vm, 2, GetMonitorPhysicalWidth(monitor));
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "physicalHeight");
+    wrenSetSlotDouble(vm, 2, GetMonitorPhysicalHeight(monitor));
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "refreshRate");
+    wrenSetSlotDouble(vm, 2, GetMonitorRefreshRate(monitor));
+    wrenSetMapValue(vm, 0, 1, 2);
 }
 
-void renderTextureGetTexture(WrenVM* vm)
+void windowListDropped(WrenVM* vm)
 {
+    FilePathList list = LoadDroppedFiles();
     wrenEnsureSlots(vm, 2);
-    RenderTexture* texture = (RenderTexture*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotNewList(vm, 0);
 
-    vmData* data = (vmData*)wrenGetUserData(vm);
+    for (int i = 0; i < (int)list.count; i++) {
+        wrenSetSlotString(vm, 1, list.paths[i]);
+        wrenInsertInList(vm, 0, i, 1);
+    }
 
-    wrenSetSlotHandle(vm, 1, data->textureClass);
-    Texture* tex = wrenSetSlotNewForeign(vm, 0, 1, sizeof(Texture));
-    *tex = texture->texture;
+    UnloadDroppedFiles(list);
 }
 
-void fontAllocate(WrenVM* vm)
+void windowGetClosed(WrenVM* vm)
 {
     wrenEnsureSlots(vm, 1);
-    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Font));
+    wrenSetSlotBool(vm, 0, WindowShouldClose() || headlessDone());
 }
 
-void fontFinalize(void* data)
+void windowGetFullscreen(WrenVM* vm)
 {
-    Font* font = (Font*)data;
-    UnloadFont(*font);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotBool(vm, 0, IsWindowFullscreen());
 }
 
-void fontNew(WrenVM* vm)
+void windowGetHidden(WrenVM* vm)
 {
-    Font* font = (Font*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "size");
-    const char* path = wrenGetSlotString(vm, 1);
-    int size = (int)wrenGetSlotDouble(vm, 2);
-
-    if (!IsWindowReady()) {
-        VM_ABORT(vm, "Cannot load font before window initialization.");
-        return;
-    }
-
-    *font = LoadFontEx(path, size, NULL, 250); // insert codepoint count in api
-    if (!IsFontReady(*font)) {
-        VM_ABORT(vm, "Failed to load font.");
-        return;
-    }
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotBool(vm, 0, IsWindowHidden());
 }
 
-void fontNew2(WrenVM* vm)
+void windowGetMinimized(WrenVM* vm)
 {
-    Font* font = (Font*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "data")
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "size");
-    int size = (int)wrenGetSlotDouble(vm, 2);
-
-    int length;
-    const char* data = wrenGetSlotBytes(vm, 1, &length);
-
-    if (!IsWindowReady()) {
-        VM_ABORT(vm, "Cannot load font before window initialization.");
-        return;
-    }
-
-    *font = LoadFontFromMemory(".ttf", data, length, size, NULL, 250);
-    if (!IsFontReady(*font)) {
-        VM_ABORT(vm, "Failed to load font.");
-        return;
-    }
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotBool(vm, 0, IsWindowMinimized());
 }
 
-void fontPrint(WrenVM* vm)
+void windowGetMaximized(WrenVM* vm)
 {
-    Font* font = (Font*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 3, NUM, "y");
-    ASSERT_SLOT_TYPE(vm, 4, NUM, "r");
-    ASSERT_SLOT_TYPE(vm, 5, NUM, "scale");
-    ASSERT_SLOT_TYPE(vm, 6, NUM, "spacing");
-    ASSERT_SLOT_TYPE(vm, 7, NUM, "ox");
-    ASSERT_SLOT_TYPE(vm, 8, NUM, "oy");
-    ASSERT_SLOT_TYPE(vm, 9, FOREIGN, "color");
-    const char* text = wrenGetSlotString(vm, 1);
-    int x = (int)wrenGetSlotDouble(vm, 2);
-    int y = (int)wrenGetSlotDouble(vm, 3);
-    float r = (float)wrenGetSlotDouble(vm, 4);
-    float scale = (float)wrenGetSlotDouble(vm, 5);
-    float spacing = (float)wrenGetSlotDouble(vm, 6);
-    int ox = (int)wrenGetSlotDouble(vm, 7);
-    int oy = (int)wrenGetSlotDouble(vm, 8);
-    Color* color = (Color*)wrenGetSlotForeign(vm, 9);
-    DrawTextPro(*font, text, (Vector2) { (float)x, (float)y }, (Vector2) { (float)ox, (float)oy }, r, (float)font->baseSize * scale, spacing, *color);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotBool(vm, 0, IsWindowMaximized());
 }
 
-void fontMeasure(WrenVM* vm)
+void windowGetFocused(WrenVM* vm)
 {
-    Font* font = (Font*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
-    const char* text = wrenGetSlotString(vm, 1);
-    wrenSetSlotDouble(vm, 0, MeasureTextEx(*font, text, (float)font->baseSize, 0).x);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotBool(vm, 0, IsWindowFocused());
 }
 
-void fontGetSize(WrenVM* vm)
+void windowGetResized(WrenVM* vm)
 {
-    Font* font = (Font*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, font->baseSize);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotBool(vm, 0, IsWindowResized());
 }
 
-void cameraAllocate(WrenVM* vm)
+void windowGetWidth(WrenVM* vm)
 {
     wrenEnsureSlots(vm, 1);
-    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Camera2D));
+    wrenSetSlotDouble(vm, 0, GetScreenWidth());
 }
 
-void cameraNew(WrenVM* vm)
+void windowGetHeight(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    camera->target = (Vector2) { (float)x, (float)y };
-    camera->offset = (Vector2) { GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f };
-    camera->rotation = 0.0f;
-    camera->zoom = 1.0f;
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetScreenHeight());
 }
 
-void cameraBegin(WrenVM* vm)
+void windowGetMonitorCount(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    BeginMode2D(*camera);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetMonitorCount());
 }
 
-void cameraEnd(WrenVM* vm)
+void windowGetMonitor(WrenVM* vm)
 {
-    EndMode2D();
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetCurrentMonitor());
 }
 
-void cameraScreenToWorld(WrenVM* vm)
+void windowGetX(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    Vector2 result = GetScreenToWorld2D((Vector2) { (float)x, (float)y }, *camera);
-    wrenSetSlotNewList(vm, 0);
-    wrenSetSlotDouble(vm, 1, result.x);
-    wrenSetSlotDouble(vm, 2, result.y);
-    wrenInsertInList(vm, 0, 0, 1);
-    wrenInsertInList(vm, 0, 1, 2);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetWindowPosition().x);
 }
 
-void cameraWorldToScreen(WrenVM* vm)
+void windowGetY(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    Vector2 result = GetWorldToScreen2D((Vector2) { (float)x, (float)y }, *camera);
-    wrenSetSlotNewList(vm, 0);
-    wrenSetSlotDouble(vm, 1, result.x);
-    wrenSetSlotDouble(vm, 2, result.y);
-    wrenInsertInList(vm, 0, 0, 1);
-    wrenInsertInList(vm, 0, 1, 2);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetWindowPosition().y);
 }
 
-void cameraGetX(WrenVM* vm)
+void windowGetDpi(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, camera->target.x);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetWindowScaleDPI().x);
 }
 
-void cameraGetY(WrenVM* vm)
+void windowGetFileDropped(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, camera->target.y);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotBool(vm, 0, IsFileDropped());
 }
 
-void cameraGetOffsetX(WrenVM* vm)
+void windowSetIcon(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, camera->offset.x);
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "icon");
+    Image* icon = (Image*)wrenGetSlotForeign(vm, 1);
+    ImageFormat(icon, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    SetWindowIcon(*icon);
 }
 
-void cameraGetOffsetY(WrenVM* vm)
+void windowSetTitle(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, camera->offset.y);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "title");
+    const char* title = wrenGetSlotString(vm, 1);
+    SetWindowTitle(title);
 }
 
-void cameraGetRotation(WrenVM* vm)
+void windowSetMonitor(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, camera->rotation);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "monitor");
+    int monitor = (int)wrenGetSlotDouble(vm, 1);
+    SetWindowMonitor(monitor);
 }
 
-void cameraGetZoom(WrenVM* vm)
+void windowSetOpacity(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, camera->zoom);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "opacity");
+    float opacity = (float)wrenGetSlotDouble(vm, 1);
+
+    if (opacity < 0.0f || opacity > 1.0f) {
+        VM_ABORT(vm, "Opacity must be between 0.0 and 1.0.");
+        return;
+    }
+
+    SetWindowOpacity(opacity);
 }
 
-void cameraSetX(WrenVM* vm)
+void windowSetTargetFps(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    camera->target.x = (float)x;
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "fps");
+    int fps = (int)wrenGetSlotDouble(vm, 1);
+
+    // Headless runs go as fast as they can, dt is fixed anyway.
+    if (!headlessEnabled())
+        SetTargetFPS(fps);
 }
 
-void cameraSetY(WrenVM* vm)
+void windowGetResizable(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "y");
-    int y = (int)wrenGetSlotDouble(vm, 1);
-    camera->target.y = (float)y;
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotBool(vm, 0, IsWindowState(FLAG_WINDOW_RESIZABLE));
 }
 
-void cameraSetOffsetX(WrenVM* vm)
+void windowSetResizable(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "ox");
-    int ox = (int)wrenGetSlotDouble(vm, 1);
-    camera->offset.x = (float)ox;
+    ASSERT_SLOT_TYPE(vm, 1, BOOL, "resizable");
+    bool resizable = wrenGetSlotBool(vm, 1);
+
+    if (resizable) {
+        SetWindowState(FLAG_WINDOW_RESIZABLE);
+    } else {
+        ClearWindowState(FLAG_WINDOW_RESIZABLE);
+    }
 }
 
-void cameraSetOffsetY(WrenVM* vm)
+void windowGetVSync(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "oy");
-    int oy = (int)wrenGetSlotDouble(vm, 1);
-    camera->offset.y = (float)oy;
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotBool(vm, 0, IsWindowState(FLAG_VSYNC_HINT));
 }
 
-void cameraSetRotation(WrenVM* vm)
+void windowSetVSync(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "r");
-    float r = (float)wrenGetSlotDouble(vm, 1);
-    camera->rotation = r;
+    ASSERT_SLOT_TYPE(vm, 1, BOOL, "vsync");
+    bool vsync = wrenGetSlotBool(vm, 1);
+
+    if (headlessEnabled())
+        return;
+
+    if (vsync) {
+        SetWindowState(FLAG_VSYNC_HINT);
+    } else {
+        ClearWindowState(FLAG_VSYNC_HINT);
+    }
 }
 
-void cameraSetZoom(WrenVM* vm)
+void windowGetDt(WrenVM* vm)
 {
-    Camera2D* camera = (Camera2D*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "zoom");
-    float zoom = (float)wrenGetSlotDouble(vm, 1);
-    camera->zoom = zoom;
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, headlessEnabled() ? headlessGetDt() : GetFrameTime());
 }
 
-void shaderAllocate(WrenVM* vm)
+void windowGetTime(WrenVM* vm)
 {
     wrenEnsureSlots(vm, 1);
-    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Shader));
+    wrenSetSlotDouble(vm, 0, headlessEnabled() ? headlessGetTime() : GetTime());
 }
 
-void shaderFinalize(void* data)
+void windowGetFps(WrenVM* vm)
 {
-    Shader* shader = (Shader*)data;
-    UnloadShader(*shader);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetFPS());
 }
 
-void shaderNew(WrenVM* vm)
+void osReadLine(WrenVM* vm)
 {
-    Shader* shader = (Shader*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "vs");
-    ASSERT_SLOT_TYPE(vm, 2, STRING, "fs");
-    const char* vs = wrenGetSlotString(vm, 1);
-    const char* fs = wrenGetSlotString(vm, 2);
+    wrenEnsureSlots(vm, 1);
 
-    if (!IsWindowReady()) {
-        VM_ABORT(vm, "Cannot load shader before window initialization.");
+    char* result = readLine();
+    if (result == NULL) {
+        VM_ABORT(vm, "Failed to read line.");
         return;
     }
 
-    *shader = LoadShader(vs, fs);
-    if (!IsShaderReady(*shader)) {
-        VM_ABORT(vm, "Failed to load shader.");
-        return;
-    }
+    wrenSetSlotString(vm, 0, result);
 }
 
-void shaderNew2(WrenVM* vm)
+void osWait(WrenVM* vm)
 {
-    Shader* shader = (Shader*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "fs");
-    const char* fs = wrenGetSlotString(vm, 1);
-
-    if (!IsWindowReady()) {
-        VM_ABORT(vm, "Cannot load shader before window initialization.");
-        return;
-    }
-
-    *shader = LoadShader(NULL, fs);
-    if (!IsShaderReady(*shader)) {
-        VM_ABORT(vm, "Failed to load shader.");
-        return;
-    }
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "seconds");
+    double seconds = wrenGetSlotDouble(vm, 1);
+    WaitTime(seconds);
 }
 
-void shaderNew3(WrenVM* vm)
+void osOpenUrl(WrenVM* vm)
 {
-    Shader* shader = (Shader*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "vs");
-    ASSERT_SLOT_TYPE(vm, 2, STRING, "fs");
-    const char* vs = wrenGetSlotString(vm, 1);
-    const char* fs = wrenGetSlotString(vm, 2);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "url");
+    const char* url = wrenGetSlotString(vm, 1);
+    OpenURL(url);
+}
 
-    if (!IsWindowReady()) {
-        VM_ABORT(vm, "Cannot load shader before window initialization.");
-        return;
-    }
+void osGetArgs(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 2);
+    wrenSetSlotNewList(vm, 0);
 
-    *shader = LoadShaderFromMemory(vs, fs);
-    if (!IsShaderReady(*shader)) {
-        VM_ABORT(vm, "Failed to load shader.");
-        return;
+    for (int i = 0; i < argCount; i++) {
+        wrenSetSlotString(vm, 1, args[i]);
+        wrenInsertInList(vm, 0, i, 1);
     }
 }
 
-void shaderNew4(WrenVM* vm)
+void osGetName(WrenVM* vm)
 {
-    Shader* shader = (Shader*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "fs");
-    const char* fs = wrenGetSlotString(vm, 1);
+    wrenEnsureSlots(vm, 1);
 
-    if (!IsWindowReady()) {
-        VM_ABORT(vm, "Cannot load shader before window initialization.");
-        return;
-    }
+#ifdef _WIN32
+    wrenSetSlotString(vm, 0, "windows");
+#else
+    wrenSetSlotString(vm, 0, "linux");
+#endif
+}
 
-    *shader = LoadShaderFromMemory(NULL, fs);
-    if (!IsShaderReady(*shader)) {
-        VM_ABORT(vm, "Failed to load shader.");
-        return;
-    }
+void osGetWrayVersion(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotString(vm, 0, WRAY_VERSION);
 }
 
-void shaderBegin(WrenVM* vm)
+void osGetClipboard(WrenVM* vm)
 {
-    Shader* shader = (Shader*)wrenGetSlotForeign(vm, 0);
-    BeginShaderMode(*shader);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotString(vm, 0, GetClipboardText());
 }
 
-void shaderEnd(WrenVM* vm)
+void osSetClipboard(WrenVM* vm)
 {
-    EndShaderMode();
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
+    const char* text = wrenGetSlotString(vm, 1);
+    SetClipboardText(text);
 }
 
-void shaderSet(WrenVM* vm)
+void dataCompress(WrenVM* vm)
 {
-    Shader* shader = (Shader*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "name");
-    const char* name = wrenGetSlotString(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "data");
 
-    if (wrenGetSlotType(vm, 2) == WREN_TYPE_NUM) {
-        float value = (float)wrenGetSlotDouble(vm, 2);
-        SetShaderValue(*shader, GetShaderLocation(*shader, name), &value, SHADER_UNIFORM_FLOAT);
-    } else if (wrenGetSlotType(vm, 2) == WREN_TYPE_LIST) {
-        wrenEnsureSlots(vm, 4);
-        int count = wrenGetListCount(vm, 2);
+    int length;
+    const char* data = wrenGetSlotBytes(vm, 1, &length);
 
-        if (count == 2) {
-            float vec[2];
-            wrenGetListElement(vm, 2, 0, 3);
-            vec[0] = (float)wrenGetSlotDouble(vm, 3);
-            wrenGetListElement(vm, 2, 1, 3);
-            vec[1] = (float)wrenGetSlotDouble(vm, 3);
-            SetShaderValue(*shader, GetShaderLocation(*shader, name), vec, SHADER_UNIFORM_VEC2);
-        } else if (count == 3) {
-            float vec[3];
-            wrenGetListElement(vm, 2, 0, 3);
-            vec[0] = (float)wrenGetSlotDouble(vm, 3);
-            wrenGetListElement(vm, 2, 1, 3);
-            vec[1] = (float)wrenGetSlotDouble(vm, 3);
-            wrenGetListElement(vm, 2, 2, 3);
-            vec[2] = (float)wrenGetSlotDouble(vm, 3);
-            SetShaderValue(*shader, GetShaderLocation(*shader, name), vec, SHADER_UNIFORM_VEC3);
-        } else if (count == 4) {
-            float vec[4];
-            wrenGetListElement(vm, 2, 0, 3);
-            vec[0] = (float)wrenGetSlotDouble(vm, 3);
-            wrenGetListElement(vm, 2, 1, 3);
-            vec[1] = (float)wrenGetSlotDouble(vm, 3);
-            wrenGetListElement(vm, 2, 2, 3);
-            vec[2] = (float)wrenGetSlotDouble(vm, 3);
-            wrenGetListElement(vm, 2, 3, 3);
-            vec[3] = (float)wrenGetSlotDouble(vm, 3);
-            SetShaderValue(*shader, GetShaderLocation(*shader, name), vec, SHADER_UNIFORM_VEC4);
-        } else {
-            VM_ABORT(vm, "Invalid argument count.");
-            return;
-        }
-    } else if (wrenGetSlotType(vm, 2) == WREN_TYPE_FOREIGN) {
-        Texture* texture = (Texture*)wrenGetSlotForeign(vm, 2);
-        SetShaderValueTexture(*shader, GetShaderLocation(*shader, name), *texture);
-    } else {
-        VM_ABORT(vm, "Invalid argument type.");
-        return;
-    }
-}
+    int compressedLength;
+    unsigned char* compressed = CompressData(data, length, &compressedLength);
 
-// Input
+    wrenSetSlotBytes(vm, 0, compressed, compressedLength);
+    free(compressed);
+}
 
-void keyboardPressed(WrenVM* vm)
+void dataDecompress(WrenVM* vm)
 {
-    if (!IsWindowReady())
-        return;
-
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "key");
-    const char* key = wrenGetSlotString(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "data");
 
-    vmData* data = (vmData*)wrenGetUserData(vm);
+    int length;
+    const char* data = wrenGetSlotBytes(vm, 1, &length);
 
-    KeyboardKey k = *map_get(&data->keys, key);
-    if (k == KEY_NULL) {
-        VM_ABORT(vm, "Invalid key.");
-        return;
-    }
+    int decompressedLength;
+    unsigned char* decompressed = DecompressData(data, length, &decompressedLength);
 
-    wrenSetSlotBool(vm, 0, IsKeyPressed(k));
+    wrenSetSlotBytes(vm, 0, decompressed, decompressedLength);
+    free(decompressed);
 }
 
-void keyboardPressedRepeat(WrenVM* vm)
+// Gets the bytes of a string or a buffer, aborting the fiber for anything else.
+static const uint8_t* getSlotData(WrenVM* vm, int slot, size_t* size)
 {
-    if (!IsWindowReady())
-        return;
-
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "key");
-    const char* key = wrenGetSlotString(vm, 1);
-
-    vmData* data = (vmData*)wrenGetUserData(vm);
+    if (wrenGetSlotType(vm, slot) == WREN_TYPE_STRING) {
+        int length;
+        const char* data = wrenGetSlotBytes(vm, slot, &length);
+        *size = (size_t)length;
+        return (const uint8_t*)data;
+    }
 
-    KeyboardKey k = *map_get(&data->keys, key);
-    if (k == KEY_NULL) {
-        VM_ABORT(vm, "Invalid key.");
-        return;
+    if (wrenGetSlotType(vm, slot) == WREN_TYPE_FOREIGN) {
+        Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, slot);
+        *size = (size_t)buffer->size;
+        return buffer->data != NULL ? buffer->data : (const uint8_t*)"";
     }
 
-    wrenSetSlotBool(vm, 0, IsKeyPressedRepeat(k));
+    VM_ABORT(vm, "Expected data to be a string or a buffer.");
+    return NULL;
 }
 
-void keyboardDown(WrenVM* vm)
+// Gets where to write size bytes in the buffer at slot, aborting the fiber if it doesn't fit.
+static uint8_t* getSlotOutput(WrenVM* vm, int slot, size_t size)
 {
-    if (!IsWindowReady())
-        return;
-
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "key");
-    const char* key = wrenGetSlotString(vm, 1);
+    if (wrenGetSlotType(vm, slot) != WREN_TYPE_FOREIGN || wrenGetSlotType(vm, slot + 1) != WREN_TYPE_NUM) {
+        VM_ABORT(vm, "Expected a buffer and an offset.");
+        return NULL;
+    }
 
-    vmData* data = (vmData*)wrenGetUserData(vm);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, slot);
+    int offset = (int)wrenGetSlotDouble(vm, slot + 1);
 
-    KeyboardKey k = *map_get(&data->keys, key);
-    if (k == KEY_NULL) {
-        VM_ABORT(vm, "Invalid key.");
-        return;
+    if (offset < 0 || offset > buffer->size || size > (size_t)(buffer->size - offset)) {
+        VM_ABORT(vm, "Buffer is too small.");
+        return NULL;
     }
 
-    wrenSetSlotBool(vm, 0, IsKeyDown(k));
+    return &buffer->data[offset];
 }
 
-void keyboardReleased(WrenVM* vm)
+// Encodes into a temporary string, or straight into a buffer when one is passed.
+static void encodeData(WrenVM* vm, bool base64, bool toBuffer)
 {
-    if (!IsWindowReady())
+    size_t length;
+    const uint8_t* data = getSlotData(vm, 1, &length);
+    if (data == NULL)
         return;
 
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "key");
-    const char* key = wrenGetSlotString(vm, 1);
+    size_t (*encode)(const unsigned char*, size_t, char*) = base64 ? base64Encode : hexEncode;
+    size_t size = base64 ? base64EncodedSize(length) : length * 2;
 
-    vmData* data = (vmData*)wrenGetUserData(vm);
+    if (toBuffer) {
+        uint8_t* output = getSlotOutput(vm, 2, size);
+        if (output == NULL)
+            return;
 
-    KeyboardKey k = *map_get(&data->keys, key);
-    if (k == KEY_NULL) {
-        VM_ABORT(vm, "Invalid key.");
+        wrenSetSlotDouble(vm, 0, (double)encode(data, length, (char*)output));
         return;
     }
 
-    wrenSetSlotBool(vm, 0, IsKeyReleased(k));
-}
+    char* encoded = (char*)malloc(size > 0 ? size : 1);
+    if (encoded == NULL) {
+        VM_ABORT(vm, "Failed to allocate memory.");
+        return;
+    }
 
-void keyboardGetKeyPressed(WrenVM* vm)
-{
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetKeyPressed());
+    wrenSetSlotBytes(vm, 0, encoded, encode(data, length, encoded));
+    free(encoded);
 }
 
-void keyboardGetCharPressed(WrenVM* vm)
+static void decodeBase64(WrenVM* vm, bool toBuffer)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetCharPressed());
-}
+    size_t length;
+    const uint8_t* data = getSlotData(vm, 1, &length);
+    if (data == NULL)
+        return;
 
-void mousePressed(WrenVM* vm)
-{
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "button");
-    int button = (int)wrenGetSlotDouble(vm, 1);
-    wrenSetSlotBool(vm, 0, IsMouseButtonPressed(button));
-}
+    size_t size = base64DecodedSize((const char*)data, length);
+    uint8_t* decoded = toBuffer ? getSlotOutput(vm, 2, size) : (uint8_t*)malloc(size > 0 ? size : 1);
+    if (decoded == NULL) {
+        if (!toBuffer)
+            VM_ABORT(vm, "Failed to allocate memory.");
+        return;
+    }
+
+    if (!base64Decode((const char*)data, length, decoded, &size)) {
+        if (!toBuffer)
+            free(decoded);
+        VM_ABORT(vm, "Invalid base64 data.");
+        return;
+    }
 
-void mouseDown(WrenVM* vm)
-{
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "button");
-    int button = (int)wrenGetSlotDouble(vm, 1);
-    wrenSetSlotBool(vm, 0, IsMouseButtonDown(button));
+    if (toBuffer) {
+        wrenSetSlotDouble(vm, 0, (double)size);
+    } else {
+        wrenSetSlotBytes(vm, 0, (const char*)decoded, size);
+        free(decoded);
+    }
 }
 
-void mouseReleased(WrenVM* vm)
+static void decodeHex(WrenVM* vm, bool toBuffer)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "button");
-    int button = (int)wrenGetSlotDouble(vm, 1);
-    wrenSetSlotBool(vm, 0, IsMouseButtonReleased(button));
+    size_t length;
+    const uint8_t* data = getSlotData(vm, 1, &length);
+    if (data == NULL)
+        return;
+
+    size_t size = hexDecodedSize((const char*)data, length);
+    uint8_t* decoded = toBuffer ? getSlotOutput(vm, 2, size) : (uint8_t*)malloc(size > 0 ? size : 1);
+    if (decoded == NULL) {
+        if (!toBuffer)
+            VM_ABORT(vm, "Failed to allocate memory.");
+        return;
+    }
+
+    if (!hexDecode((const char*)data, length, decoded, &size)) {
+        if (!toBuffer)
+            free(decoded);
+        VM_ABORT(vm, "Invalid hex data.");
+        return;
+    }
+
+    if (toBuffer) {
+        wrenSetSlotDouble(vm, 0, (double)size);
+    } else {
+        wrenSetSlotBytes(vm, 0, (const char*)decoded, size);
+        free(decoded);
+    }
 }
 
-void mouseSetPosition(WrenVM* vm)
+void dataEncodeBase64(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    SetMousePosition(x, y);
+    encodeData(vm, true, false);
 }
 
-void mouseSetOffset(WrenVM* vm)
+void dataEncodeBase64Into(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    SetMouseOffset(x, y);
+    encodeData(vm, true, true);
 }
 
-void mouseSetScale(WrenVM* vm)
+void dataDecodeBase64(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    float x = (float)wrenGetSlotDouble(vm, 1);
-    float y = (float)wrenGetSlotDouble(vm, 2);
-    SetMouseScale(x, y);
+    decodeBase64(vm, false);
 }
 
-void mouseGetX(WrenVM* vm)
+void dataDecodeBase64Into(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetMouseX());
+    decodeBase64(vm, true);
 }
 
-void mouseGetY(WrenVM* vm)
+void dataEncodeHex(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetMouseY());
+    encodeData(vm, false, false);
 }
 
-void mouseGetDeltaX(WrenVM* vm)
+void dataEncodeHexInto(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetMouseDelta().x);
+    encodeData(vm, false, true);
 }
 
-void mouseGetDeltaY(WrenVM* vm)
+void dataDecodeHex(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetMouseDelta().y);
+    decodeHex(vm, false);
 }
 
-void mouseGetWheel(WrenVM* vm)
+void dataDecodeHexInto(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetMouseWheelMove());
+    decodeHex(vm, true);
 }
 
-void mouseSetCursor(WrenVM* vm)
+void dataHash(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "cursor");
-    const char* cursor = wrenGetSlotString(vm, 1);
+    size_t size;
+    const uint8_t* data = getSlotData(vm, 1, &size);
+    if (data == NULL)
+        return;
 
-    if (TextIsEqual(cursor, "default"))
-        SetMouseCursor(MOUSE_CURSOR_DEFAULT);
-    else if (TextIsEqual(cursor, "arrow"))
-        SetMouseCursor(MOUSE_CURSOR_ARROW);
-    else if (TextIsEqual(cursor, "ibeam"))
-        SetMouseCursor(MOUSE_CURSOR_IBEAM);
-    else if (TextIsEqual(cursor, "crosshair"))
-        SetMouseCursor(MOUSE_CURSOR_CROSSHAIR);
-    else if (TextIsEqual(cursor, "pointingHand"))
-        SetMouseCursor(MOUSE_CURSOR_POINTING_HAND);
-    else if (TextIsEqual(cursor, "resizeEW"))
-        SetMouseCursor(MOUSE_CURSOR_RESIZE_EW);
-    else if (TextIsEqual(cursor, "resizeNS"))
-        SetMouseCursor(MOUSE_CURSOR_RESIZE_NS);
-    else if (TextIsEqual(cursor, "resizeNWSE"))
-        SetMouseCursor(MOUSE_CURSOR_RESIZE_NWSE);
-    else if (TextIsEqual(cursor, "resizeNESW"))
-        SetMouseCursor(MOUSE_CURSOR_RESIZE_NESW);
-    else if (TextIsEqual(cursor, "resizeAll"))
-        SetMouseCursor(MOUSE_CURSOR_RESIZE_ALL);
-    else if (TextIsEqual(cursor, "notAllowed"))
-        SetMouseCursor(MOUSE_CURSOR_NOT_ALLOWED);
-    else
-        VM_ABORT(vm, "Invalid cursor.");
-}
+    BYTE buf[SHA256_BLOCK_SIZE];
+    SHA256_CTX ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, data, size);
+    sha256_final(&ctx, buf);
 
-void mouseGetHidden(WrenVM* vm)
-{
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotBool(vm, 0, IsCursorHidden());
+    wrenSetSlotBytes(vm, 0, buf, SHA256_BLOCK_SIZE);
 }
 
-void mouseSetHidden(WrenVM* vm)
+void dataHash64(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, BOOL, "hidden");
-    bool hidden = wrenGetSlotBool(vm, 1);
+    size_t size;
+    const uint8_t* data = getSlotData(vm, 1, &size);
+    if (data == NULL)
+        return;
 
-    if (hidden)
-        HideCursor();
-    else
-        ShowCursor();
+    uint64_t hash = hash64(data, size, 0);
+    wrenSetSlotString(vm, 0, TextFormat("%08x%08x", (unsigned int)(hash >> 32), (unsigned int)hash));
 }
 
-void mouseSetEnabled(WrenVM* vm)
+void dataCrc32(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, BOOL, "enabled");
-    bool enabled = wrenGetSlotBool(vm, 1);
+    size_t size;
+    const uint8_t* data = getSlotData(vm, 1, &size);
+    if (data == NULL)
+        return;
 
-    if (enabled)
-        EnableCursor();
-    else
-        DisableCursor();
+    wrenSetSlotDouble(vm, 0, (double)mz_crc32(MZ_CRC32_INIT, data, size));
 }
 
-void mouseGetOnScreen(WrenVM* vm)
+void hasherAllocate(WrenVM* vm)
 {
     wrenEnsureSlots(vm, 1);
-    wrenSetSlotBool(vm, 0, IsCursorOnScreen());
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Hasher));
 }
 
-void gamepadAllocate(WrenVM* vm)
+static void resetHasher(Hasher* hasher)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Gamepad));
+    if (hasher->sha256)
+        sha256_init(&hasher->ctx);
+    else
+        hasher->crc = MZ_CRC32_INIT;
 }
 
-void gamepadNew(WrenVM* vm)
+void hasherNew(WrenVM* vm)
 {
-    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "id");
-    int id = (int)wrenGetSlotDouble(vm, 1);
+    Hasher* hasher = (Hasher*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "algorithm");
+    const char* algorithm = wrenGetSlotString(vm, 1);
 
-    if (!IsGamepadAvailable(id)) {
-        VM_ABORT(vm, "Gamepad not available.");
+    if (TextIsEqual(algorithm, "sha256")) {
+        hasher->sha256 = true;
+    } else if (TextIsEqual(algorithm, "crc32")) {
+        hasher->sha256 = false;
+    } else {
+        VM_ABORT(vm, "Invalid algorithm, expected \"sha256\" or \"crc32\".");
         return;
     }
 
-    gamepad->id = id;
+    resetHasher(hasher);
 }
 
-void gamepadAvailable(WrenVM* vm)
+static void updateHasher(Hasher* hasher, const uint8_t* data, size_t size)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "id");
-    int id = (int)wrenGetSlotDouble(vm, 1);
-    wrenSetSlotBool(vm, 0, IsGamepadAvailable(id));
+    if (hasher->sha256)
+        sha256_update(&hasher->ctx, data, size);
+    else
+        hasher->crc = (uint32_t)mz_crc32(hasher->crc, data, size);
 }
 
-void gamepadPressed(WrenVM* vm)
+void hasherUpdate(WrenVM* vm)
 {
-    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "button");
-    int button = (int)wrenGetSlotDouble(vm, 1);
-    wrenSetSlotBool(vm, 0, IsGamepadButtonPressed(gamepad->id, button));
-}
+    Hasher* hasher = (Hasher*)wrenGetSlotForeign(vm, 0);
 
-void gamepadDown(WrenVM* vm)
-{
-    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "button");
-    int button = (int)wrenGetSlotDouble(vm, 1);
-    wrenSetSlotBool(vm, 0, IsGamepadButtonDown(gamepad->id, button));
-}
+    size_t size;
+    const uint8_t* data = getSlotData(vm, 1, &size);
+    if (data == NULL)
+        return;
 
-void gamepadReleased(WrenVM* vm)
-{
-    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "button");
-    int button = (int)wrenGetSlotDouble(vm, 1);
-    wrenSetSlotBool(vm, 0, IsGamepadButtonReleased(gamepad->id, button));
+    updateHasher(hasher, data, size);
 }
 
-void gamepadAxis(WrenVM* vm)
+void hasherUpdate2(WrenVM* vm)
 {
-    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "axis");
-    int axis = (int)wrenGetSlotDouble(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetGamepadAxisMovement(gamepad->id, axis));
-}
+    Hasher* hasher = (Hasher*)wrenGetSlotForeign(vm, 0);
 
-void gamepadGetId(WrenVM* vm)
-{
-    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, gamepad->id);
-}
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "buffer");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "size");
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
+    int size = (int)wrenGetSlotDouble(vm, 3);
 
-void gamepadGetName(WrenVM* vm)
-{
-    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotString(vm, 0, GetGamepadName(gamepad->id));
-}
+    if (offset < 0 || size < 0 || offset + size > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
 
-void gamepadGetAxisCount(WrenVM* vm)
-{
-    Gamepad* gamepad = (Gamepad*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, GetGamepadAxisCount(gamepad->id));
+    updateHasher(hasher, &buffer->data[offset], size);
 }
 
-// System
-
-void windowInit(WrenVM* vm)
+void hasherDigest(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
-    ASSERT_SLOT_TYPE(vm, 3, STRING, "title");
-    int width = (int)wrenGetSlotDouble(vm, 1);
-    int height = (int)wrenGetSlotDouble(vm, 2);
-    const char* title = wrenGetSlotString(vm, 3);
+    Hasher* hasher = (Hasher*)wrenGetSlotForeign(vm, 0);
 
-    InitWindow(width, height, title);
-    if (!IsWindowReady()) {
-        VM_ABORT(vm, "Failed to initialize window.");
+    if (!hasher->sha256) {
+        wrenSetSlotDouble(vm, 0, (double)hasher->crc);
         return;
     }
 
-    Image icon = {
-        .data = ICON_DATA,
-        .width = ICON_WIDTH,
-        .height = ICON_HEIGHT,
-        .format = ICON_FORMAT,
-        .mipmaps = 1
-    };
-
-    SetWindowIcon(icon);
-    SetExitKey(KEY_NULL);
-
-    Image font = {
-        .data = FONT_DATA,
-        .width = FONT_WIDTH,
-        .height = FONT_HEIGHT,
-        .format = FONT_FORMAT,
-        .mipmaps = 1
-    };
-
-    defaultFont = LoadFontFromImage(font, MAGENTA, 32);
+    // Finish a copy so more data can still be added afterwards.
+    SHA256_CTX ctx = hasher->ctx;
+    BYTE buf[SHA256_BLOCK_SIZE];
+    sha256_final(&ctx, buf);
 
-    vmData* data = (vmData*)wrenGetUserData(vm);
-    data->windowInit = true;
+    wrenSetSlotBytes(vm, 0, buf, SHA256_BLOCK_SIZE);
 }
 
-void windowToggleFullscreen(WrenVM* vm)
+void hasherReset(WrenVM* vm)
 {
-    ToggleFullscreen();
+    Hasher* hasher = (Hasher*)wrenGetSlotForeign(vm, 0);
+    resetHasher(hasher);
 }
 
-void windowToggleBorderless(WrenVM* vm)
+void zstreamAllocate(WrenVM* vm)
 {
-    ToggleBorderlessWindowed();
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(ZStream));
 }
 
-void windowMaximize(WrenVM* vm)
+void zstreamFinalize(void* data)
 {
-    MaximizeWindow();
+    ZStream* z = (ZStream*)data;
+
+    if (z->stream) {
+        if (z->deflate)
+            mz_deflateEnd(z->stream);
+        else
+            mz_inflateEnd(z->stream);
+
+        free(z->stream);
+    }
+
+    free(z->output);
 }
 
-void windowMinimize(WrenVM* vm)
+static int getWindowBits(WrenVM* vm, int slot)
 {
-    MinimizeWindow();
+    if (wrenGetSlotType(vm, slot) != WREN_TYPE_STRING) {
+        VM_ABORT(vm, "Expected format to be a string.");
+        return 0;
+    }
+
+    // Raw deflate is what Data.compress produces, zlib adds a header and an adler32 trailer.
+    const char* format = wrenGetSlotString(vm, slot);
+    if (TextIsEqual(format, "deflate"))
+        return -MZ_DEFAULT_WINDOW_BITS;
+    if (TextIsEqual(format, "zlib"))
+        return MZ_DEFAULT_WINDOW_BITS;
+
+    VM_ABORT(vm, "Invalid format, expected \"deflate\" or \"zlib\".");
+    return 0;
 }
 
-void windowRestore(WrenVM* vm)
+static void initZStream(WrenVM* vm, bool deflate, int level, int windowBits)
 {
-    RestoreWindow();
+    ZStream* z = (ZStream*)wrenGetSlotForeign(vm, 0);
+    z->deflate = deflate;
+
+    z->stream = (mz_stream*)calloc(1, sizeof(mz_stream));
+    if (z->stream == NULL) {
+        VM_ABORT(vm, "Failed to allocate memory.");
+        return;
+    }
+
+    int status = deflate
+        ? mz_deflateInit2(z->stream, level, MZ_DEFLATED, windowBits, 9, MZ_DEFAULT_STRATEGY)
+        : mz_inflateInit2(z->stream, windowBits);
+
+    if (status != MZ_OK) {
+        free(z->stream);
+        z->stream = NULL;
+        VM_ABORT(vm, "Failed to initialize stream.");
+        return;
+    }
 }
 
-void windowSetPosition(WrenVM* vm)
+static void newDeflater(WrenVM* vm, int windowBits)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "x");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "y");
-    int x = (int)wrenGetSlotDouble(vm, 1);
-    int y = (int)wrenGetSlotDouble(vm, 2);
-    SetWindowPosition(x, y);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "level");
+    int level = (int)wrenGetSlotDouble(vm, 1);
+
+    if (level < 0 || level > 9) {
+        VM_ABORT(vm, "Compression level must be between 0 and 9.");
+        return;
+    }
+
+    initZStream(vm, true, level, windowBits);
+}
+
+void deflaterNew(WrenVM* vm)
+{
+    newDeflater(vm, -MZ_DEFAULT_WINDOW_BITS);
 }
 
-void windowSetMinSize(WrenVM* vm)
+void deflaterNew2(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
-    int width = (int)wrenGetSlotDouble(vm, 1);
-    int height = (int)wrenGetSlotDouble(vm, 2);
-    SetWindowMinSize(width, height);
+    int windowBits = getWindowBits(vm, 2);
+    if (windowBits == 0)
+        return;
+
+    newDeflater(vm, windowBits);
 }
 
-void windowSetMaxSize(WrenVM* vm)
+void inflaterNew(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
-    int width = (int)wrenGetSlotDouble(vm, 1);
-    int height = (int)wrenGetSlotDouble(vm, 2);
-    SetWindowMaxSize(width, height);
+    initZStream(vm, false, 0, -MZ_DEFAULT_WINDOW_BITS);
 }
 
-void windowSetSize(WrenVM* vm)
+void inflaterNew2(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "width");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "height");
-    int width = (int)wrenGetSlotDouble(vm, 1);
-    int height = (int)wrenGetSlotDouble(vm, 2);
-    SetWindowSize(width, height);
+    int windowBits = getWindowBits(vm, 1);
+    if (windowBits == 0)
+        return;
+
+    initZStream(vm, false, 0, windowBits);
 }
 
-void windowFocus(WrenVM* vm)
+static bool reserveOutput(ZStream* z, size_t size)
 {
-    SetWindowFocused();
+    // Slide unread output to the front before growing.
+    if (z->outputStart > 0) {
+        memmove(z->output, z->output + z->outputStart, z->outputSize);
+        z->outputStart = 0;
+    }
+
+    if (z->outputSize + size <= z->outputCapacity)
+        return true;
+
+    size_t capacity = z->outputCapacity > 0 ? z->outputCapacity : ZSTREAM_CHUNK;
+    while (capacity < z->outputSize + size)
+        capacity *= 2;
+
+    uint8_t* output = (uint8_t*)realloc(z->output, capacity);
+    if (output == NULL)
+        return false;
+
+    z->output = output;
+    z->outputCapacity = capacity;
+    return true;
 }
 
-void windowGetMonitorInfo(WrenVM* vm)
+// Feeds input through the stream, appending whatever it produces to the pending output.
+static void runZStream(WrenVM* vm, ZStream* z, const uint8_t* data, size_t size, int flush)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "monitor");
-    int monitor = (int)wrenGetSlotDouble(vm, 1);
+    mz_stream* stream = z->stream;
+    stream->next_in = data;
+    stream->avail_in = (unsigned int)size;
 
-    wrenEnsureSlots(vm, 3);
-    wrenSetSlotNewMap(vm, 0);
+    for (;;) {
+        if (!reserveOutput(z, ZSTREAM_CHUNK)) {
+            VM_ABORT(vm, "Failed to allocate memory.");
+            return;
+        }
 
-    wrenSetSlotString(vm, 1, "name");
-    wrenSetSlotString(vm, 2, GetMonitorName(monitor));
-    wrenSetMapValue(vm, 0, 1, 2);
+        size_t space = z->outputCapacity - z->outputSize;
+        stream->next_out = z->output + z->outputSize;
+        stream->avail_out = (unsigned int)space;
 
-    wrenSetSlotString(vm, 1, "x");
-    wrenSetSlotDouble(vm, 2, GetMonitorPosition(monitor).x);
-    wrenSetMapValue(vm, 0, 1, 2);
+        unsigned int available = stream->avail_in;
+        int status = z->deflate ? mz_deflate(stream, flush) : mz_inflate(stream, flush);
 
-    wrenSetSlotString(vm, 1, "y");
-    wrenSetSlotDouble(vm, 2, GetMonitorPosition(monitor).y);
-    wrenSetMapValue(vm, 0, 1, 2);
+        z->totalIn += available - stream->avail_in;
+        z->totalOut += space - stream->avail_out;
+        z->outputSize += space - stream->avail_out;
 
-    wrenSetSlotString(vm, 1, "width");
-    wrenSetSlotDouble(vm, 2, GetMonitorWidth(monitor));
-    wrenSetMapValue(vm, 0, 1, 2);
+        if (status == MZ_STREAM_END) {
+            z->finished = true;
+            return;
+        }
 
-    wrenSetSlotString(vm, 1, "height");
-    wrenSetSlotDouble(vm, 2, GetMonitorHeight(monitor));
-    wrenSetMapValue(vm, 0, 1, 2);
+        // No progress possible until more input arrives.
+        if (status == MZ_BUF_ERROR)
+            return;
 
-    wrenSetSlotString(vm, 1, "physicalWidth");
-    wrenSetSlotDouble(vm, 2, GetMonitorPhysicalWidth(monitor));
-    wrenSetMapValue(vm, 0, 1, 2);
+        if (status != MZ_OK) {
+            VM_ABORT(vm, z->deflate ? "Failed to compress data." : "Invalid compressed data.");
+            return;
+        }
 
-    wrenSetSlotString(vm, 1, "physicalHeight");
-    wrenSetSlotDouble(vm, 2, GetMonitorPhysicalHeight(monitor));
-    wrenSetMapValue(vm, 0, 1, 2);
+        if (flush != MZ_FINISH && stream->avail_in == 0 && stream->avail_out > 0)
+            return;
+    }
+}
 
-    wrenSetSlotString(vm, 1, "refreshRate");
-    wrenSetSlotDouble(vm, 2, GetMonitorRefreshRate(monitor));
-    wrenSetMapValue(vm, 0, 1, 2);
+static void writeZStream(WrenVM* vm, const uint8_t* data, size_t size)
+{
+    ZStream* z = (ZStream*)wrenGetSlotForeign(vm, 0);
+
+    if (z->finished) {
+        // Trailing bytes after the end of a compressed stream are ignored.
+        if (z->deflate)
+            VM_ABORT(vm, "Deflater is already finished.");
+        return;
+    }
+
+    runZStream(vm, z, data, size, MZ_NO_FLUSH);
 }
 
-void windowListDropped(WrenVM* vm)
+void zstreamWrite(WrenVM* vm)
 {
-    FilePathList list = LoadDroppedFiles();
-    wrenEnsureSlots(vm, 2);
-    wrenSetSlotNewList(vm, 0);
+    size_t size;
+    const uint8_t* data = getSlotData(vm, 1, &size);
+    if (data == NULL)
+        return;
 
-    for (int i = 0; i < (int)list.count; i++) {
-        wrenSetSlotString(vm, 1, list.paths[i]);
-        wrenInsertInList(vm, 0, i, 1);
+    writeZStream(vm, data, size);
+}
+
+void zstreamWrite2(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "buffer");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "size");
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
+    int size = (int)wrenGetSlotDouble(vm, 3);
+
+    if (offset < 0 || size < 0 || offset + size > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
     }
 
-    UnloadDroppedFiles(list);
+    writeZStream(vm, &buffer->data[offset], size);
 }
 
-void windowGetClosed(WrenVM* vm)
+void deflaterFinish(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotBool(vm, 0, WindowShouldClose());
+    ZStream* z = (ZStream*)wrenGetSlotForeign(vm, 0);
+
+    if (!z->finished)
+        runZStream(vm, z, NULL, 0, MZ_FINISH);
 }
 
-void windowGetFullscreen(WrenVM* vm)
+void zstreamRead(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotBool(vm, 0, IsWindowFullscreen());
+    ZStream* z = (ZStream*)wrenGetSlotForeign(vm, 0);
+
+    wrenSetSlotBytes(vm, 0, z->outputSize > 0 ? (const char*)&z->output[z->outputStart] : "", z->outputSize);
+    z->outputStart = 0;
+    z->outputSize = 0;
 }
 
-void windowGetHidden(WrenVM* vm)
+void zstreamReadInto(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotBool(vm, 0, IsWindowHidden());
+    ZStream* z = (ZStream*)wrenGetSlotForeign(vm, 0);
+
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "buffer");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
+
+    if (offset < 0 || offset > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
+
+    size_t size = (size_t)(buffer->size - offset);
+    if (size > z->outputSize)
+        size = z->outputSize;
+
+    memcpy(&buffer->data[offset], &z->output[z->outputStart], size);
+    z->outputStart += size;
+    z->outputSize -= size;
+
+    wrenSetSlotDouble(vm, 0, (double)size);
 }
 
-void windowGetMinimized(WrenVM* vm)
+void zstreamGetPending(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotBool(vm, 0, IsWindowMinimized());
+    ZStream* z = (ZStream*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, (double)z->outputSize);
 }
 
-void windowGetMaximized(WrenVM* vm)
+void zstreamGetTotalIn(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotBool(vm, 0, IsWindowMaximized());
+    ZStream* z = (ZStream*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, (double)z->totalIn);
 }
 
-void windowGetFocused(WrenVM* vm)
+void zstreamGetTotalOut(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotBool(vm, 0, IsWindowFocused());
+    ZStream* z = (ZStream*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotDouble(vm, 0, (double)z->totalOut);
 }
 
-void windowGetResized(WrenVM* vm)
+void zstreamGetFinished(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotBool(vm, 0, IsWindowResized());
+    ZStream* z = (ZStream*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotBool(vm, 0, z->finished);
 }
 
-void windowGetWidth(WrenVM* vm)
+void directoryExists(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetScreenWidth());
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    const char* path = wrenGetSlotString(vm, 1);
+    wrenSetSlotBool(vm, 0, DirectoryExists(path));
 }
 
-void windowGetHeight(WrenVM* vm)
+void directoryList(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetScreenHeight());
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    const char* path = wrenGetSlotString(vm, 1);
+    FilePathList list = LoadDirectoryFiles(path);
+
+    wrenEnsureSlots(vm, 2);
+    wrenSetSlotNewList(vm, 0);
+
+    for (int i = 0; i < (int)list.count; i++) {
+        wrenSetSlotString(vm, 1, list.paths[i]);
+        wrenInsertInList(vm, 0, i, 1);
+    }
+
+    UnloadDirectoryFiles(list);
 }
 
-void windowGetMonitorCount(WrenVM* vm)
+typedef struct {
+    WrenVM* vm;
+    bool directories;
+    const char* pattern;
+    const char* extensions;
+} DirectoryWalk;
+
+static void setMapString(WrenVM* vm, const char* key, const char* value)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetMonitorCount());
+    wrenSetSlotString(vm, 2, key);
+    wrenSetSlotString(vm, 3, value);
+    wrenSetMapValue(vm, 1, 2, 3);
 }
 
-void windowGetMonitor(WrenVM* vm)
+static void setMapDouble(WrenVM* vm, const char* key, double value)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetCurrentMonitor());
+    wrenSetSlotString(vm, 2, key);
+    wrenSetSlotDouble(vm, 3, value);
+    wrenSetMapValue(vm, 1, 2, 3);
 }
 
-void windowGetX(WrenVM* vm)
+static bool directoryWalkEntry(const WalkEntry* entry, void* user)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetWindowPosition().x);
+    DirectoryWalk* walk = (DirectoryWalk*)user;
+    WrenVM* vm = walk->vm;
+
+    if (entry->directory && !walk->directories)
+        return true;
+
+    if (!entry->directory && walk->extensions && !IsFileExtension(entry->relative, walk->extensions))
+        return true;
+
+    if (walk->pattern) {
+        // Like nest.cfg, patterns without a '/' match the name alone.
+        const char* name = strrchr(entry->relative, '/');
+        const char* subject = strchr(walk->pattern, '/') ? entry->relative : (name ? name + 1 : entry->relative);
+
+        if (!globMatch(walk->pattern, subject))
+            return true;
+    }
+
+    wrenSetSlotNewMap(vm, 1);
+    setMapString(vm, "path", entry->path);
+    setMapString(vm, "type", entry->directory ? "directory" : "file");
+    setMapDouble(vm, "size", (double)entry->size);
+    setMapDouble(vm, "mtime", (double)entry->modified);
+
+    wrenInsertInList(vm, 0, -1, 1);
+
+    return true;
 }
 
-void windowGetY(WrenVM* vm)
+static bool getMapOption(WrenVM* vm, int map, const char* key, int slot)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetWindowPosition().y);
+    wrenSetSlotString(vm, slot, key);
+    if (!wrenGetMapContainsKey(vm, map, slot))
+        return false;
+
+    wrenGetMapValue(vm, map, slot, slot);
+
+    return wrenGetSlotType(vm, slot) != WREN_TYPE_NULL;
 }
 
-void windowGetDpi(WrenVM* vm)
+static void walkDirectoryOptions(WrenVM* vm, bool hasOptions)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetWindowScaleDPI().x);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+
+    char path[4096];
+    char pattern[512];
+    char extensions[512];
+
+    if (TextLength(wrenGetSlotString(vm, 1)) >= sizeof(path)) {
+        VM_ABORT(vm, "Path is too long.");
+        return;
+    }
+
+    TextCopy(path, wrenGetSlotString(vm, 1));
+
+    DirectoryWalk walk = { vm, false, NULL, NULL };
+    bool recursive = true;
+
+    wrenEnsureSlots(vm, 4);
+
+    if (hasOptions) {
+        ASSERT_SLOT_TYPE(vm, 2, MAP, "options");
+
+        if (getMapOption(vm, 2, "recursive", 3)) {
+            ASSERT_SLOT_TYPE(vm, 3, BOOL, "recursive");
+            recursive = wrenGetSlotBool(vm, 3);
+        }
+
+        if (getMapOption(vm, 2, "directories", 3)) {
+            ASSERT_SLOT_TYPE(vm, 3, BOOL, "directories");
+            walk.directories = wrenGetSlotBool(vm, 3);
+        }
+
+        if (getMapOption(vm, 2, "pattern", 3)) {
+            ASSERT_SLOT_TYPE(vm, 3, STRING, "pattern");
+            snprintf(pattern, sizeof(pattern), "%s", wrenGetSlotString(vm, 3));
+            walk.pattern = pattern;
+        }
+
+        if (getMapOption(vm, 2, "extensions", 3)) {
+            ASSERT_SLOT_TYPE(vm, 3, STRING, "extensions");
+            snprintf(extensions, sizeof(extensions), "%s", wrenGetSlotString(vm, 3));
+            walk.extensions = extensions;
+        }
+    }
+
+    wrenSetSlotNewList(vm, 0);
+
+    if (!walkDirectory(path, recursive, directoryWalkEntry, &walk)) {
+        VM_ABORT(vm, "Failed to open directory.");
+        return;
+    }
 }
 
-void windowGetFileDropped(WrenVM* vm)
+void directoryWalk(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotBool(vm, 0, IsFileDropped());
+    walkDirectoryOptions(vm, false);
 }
 
-void windowSetIcon(WrenVM* vm)
+void directoryWalk2(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "icon");
-    Image* icon = (Image*)wrenGetSlotForeign(vm, 1);
-    ImageFormat(icon, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
-    SetWindowIcon(*icon);
+    walkDirectoryOptions(vm, true);
 }
 
-void windowSetTitle(WrenVM* vm)
+void fileExists(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "title");
-    const char* title = wrenGetSlotString(vm, 1);
-    SetWindowTitle(title);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    const char* path = wrenGetSlotString(vm, 1);
+    wrenSetSlotBool(vm, 0, FileExists(path));
 }
 
-void windowSetMonitor(WrenVM* vm)
+void fileSize(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "monitor");
-    int monitor = (int)wrenGetSlotDouble(vm, 1);
-    SetWindowMonitor(monitor);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    const char* path = wrenGetSlotString(vm, 1);
+    wrenSetSlotDouble(vm, 0, GetFileLength(path));
 }
 
-void windowSetOpacity(WrenVM* vm)
+void fileRead(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "opacity");
-    float opacity = (float)wrenGetSlotDouble(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    const char* path = wrenGetSlotString(vm, 1);
 
-    if (opacity < 0.0f || opacity > 1.0f) {
-        VM_ABORT(vm, "Opacity must be between 0.0 and 1.0.");
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        VM_ABORT(vm, "Failed to open file.");
         return;
     }
 
-    SetWindowOpacity(opacity);
-}
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
 
-void windowSetTargetFps(WrenVM* vm)
-{
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "fps");
-    int fps = (int)wrenGetSlotDouble(vm, 1);
-    SetTargetFPS(fps);
-}
+    char* data = (char*)malloc(size);
+    if (data == NULL) {
+        fclose(file);
+        VM_ABORT(vm, "Failed to allocate memory.");
+        return;
+    }
 
-void windowGetResizable(WrenVM* vm)
-{
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotBool(vm, 0, IsWindowState(FLAG_WINDOW_RESIZABLE));
+    fread(data, 1, size, file);
+    fclose(file);
+
+    wrenSetSlotBytes(vm, 0, data, size);
+    free(data);
 }
 
-void windowSetResizable(WrenVM* vm)
+void fileReadEmbedded(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, BOOL, "resizable");
-    bool resizable = wrenGetSlotBool(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    const char* path = wrenGetSlotString(vm, 1);
 
-    if (resizable) {
-        SetWindowState(FLAG_WINDOW_RESIZABLE);
-    } else {
-        ClearWindowState(FLAG_WINDOW_RESIZABLE);
+    // Stored entries are copied straight out of the mapped egg.
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    if (data->egg) {
+        size_t size;
+        const unsigned char* view = eggView(data->egg, path, &size);
+        if (view) {
+            wrenSetSlotBytes(vm, 0, (const char*)view, size);
+            return;
+        }
     }
-}
 
-void windowGetVSync(WrenVM* vm)
-{
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotBool(vm, 0, IsWindowState(FLAG_VSYNC_HINT));
+    int length;
+    unsigned char* file = LoadFileData(path, &length);
+    wrenSetSlotBytes(vm, 0, file, length);
+    UnloadFileData(file);
 }
 
-void windowSetVSync(WrenVM* vm)
+void fileWrite(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, BOOL, "vsync");
-    bool vsync = wrenGetSlotBool(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    ASSERT_SLOT_TYPE(vm, 2, STRING, "data");
+    const char* path = wrenGetSlotString(vm, 1);
 
-    if (vsync) {
-        SetWindowState(FLAG_VSYNC_HINT);
-    } else {
-        ClearWindowState(FLAG_VSYNC_HINT);
-    }
+    int length;
+    const char* data = wrenGetSlotBytes(vm, 2, &length);
+    SaveFileData(path, (void*)data, length);
 }
 
-void windowGetDt(WrenVM* vm)
+void bufferAllocate(WrenVM* vm)
 {
     wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetFrameTime());
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Buffer));
 }
 
-void windowGetTime(WrenVM* vm)
+void bufferFinalize(void* data)
 {
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetTime());
-}
+    Buffer* buffer = (Buffer*)data;
 
-void windowGetFps(WrenVM* vm)
-{
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetFPS());
+    if (buffer->image)
+        untrackView(buffer);
+    else
+        free(buffer->data);
 }
 
-void osReadLine(WrenVM* vm)
+void bufferNew(WrenVM* vm)
 {
-    wrenEnsureSlots(vm, 1);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "size");
+    int size = (int)wrenGetSlotDouble(vm, 1);
 
-    char* result = readLine();
-    if (result == NULL) {
-        VM_ABORT(vm, "Failed to read line.");
+    buffer->data = calloc(size, sizeof(uint8_t));
+    if (buffer->data == NULL) {
+        VM_ABORT(vm, "Failed to allocate buffer.");
         return;
     }
 
-    wrenSetSlotString(vm, 0, result);
+    buffer->size = size;
 }
 
-void osWait(WrenVM* vm)
+void bufferNew2(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "seconds");
-    double seconds = wrenGetSlotDouble(vm, 1);
-    WaitTime(seconds);
-}
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
 
-void osOpenUrl(WrenVM* vm)
-{
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "url");
-    const char* url = wrenGetSlotString(vm, 1);
-    OpenURL(url);
-}
+    if (wrenGetSlotType(vm, 1) == WREN_TYPE_LIST) {
+        int size = wrenGetListCount(vm, 1);
+        buffer->data = calloc(size, sizeof(uint8_t));
+        if (buffer->data == NULL) {
+            VM_ABORT(vm, "Failed to allocate buffer.");
+            return;
+        }
 
-void osGetArgs(WrenVM* vm)
-{
-    wrenEnsureSlots(vm, 2);
-    wrenSetSlotNewList(vm, 0);
+        wrenEnsureSlots(vm, 3);
+        for (int i = 0; i < size; i++) {
+            wrenGetListElement(vm, 1, i, 2);
 
-    for (int i = 0; i < argCount; i++) {
-        wrenSetSlotString(vm, 1, args[i]);
-        wrenInsertInList(vm, 0, i, 1);
-    }
-}
+            if (wrenGetSlotType(vm, 2) != WREN_TYPE_NUM) {
+                VM_ABORT(vm, "Invalid buffer data.");
+                return;
+            }
 
-void osGetName(WrenVM* vm)
-{
-    wrenEnsureSlots(vm, 1);
+            buffer->data[i] = (uint8_t)wrenGetSlotDouble(vm, 2);
+        }
 
-#ifdef _WIN32
-    wrenSetSlotString(vm, 0, "windows");
-#else
-    wrenSetSlotString(vm, 0, "linux");
-#endif
-}
+        buffer->size = size;
+    } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_STRING) {
+        int length;
+        const char* data = wrenGetSlotBytes(vm, 1, &length);
 
-void osGetWrayVersion(WrenVM* vm)
-{
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotString(vm, 0, WRAY_VERSION);
-}
+        buffer->data = calloc(length, sizeof(uint8_t));
+        if (buffer->data == NULL) {
+            VM_ABORT(vm, "Failed to allocate buffer.");
+            return;
+        }
 
-void osGetClipboard(WrenVM* vm)
-{
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotString(vm, 0, GetClipboardText());
-}
+        memcpy(buffer->data, data, length);
+        buffer->size = length;
+    } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_FOREIGN) {
+        Buffer* other = (Buffer*)wrenGetSlotForeign(vm, 1);
 
-void osSetClipboard(WrenVM* vm)
-{
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "text");
-    const char* text = wrenGetSlotString(vm, 1);
-    SetClipboardText(text);
+        buffer->data = calloc(other->size, sizeof(uint8_t));
+        if (buffer->data == NULL) {
+            VM_ABORT(vm, "Failed to allocate buffer.");
+            return;
+        }
+
+        memcpy(buffer->data, other->data, other->size);
+        buffer->size = other->size;
+    } else {
+        VM_ABORT(vm, "Invalid buffer data.");
+        return;
+    }
 }
 
-void dataCompress(WrenVM* vm)
+void bufferGetIndex(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "data");
-
-    int length;
-    const char* data = wrenGetSlotBytes(vm, 1, &length);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "index");
+    int index = (int)wrenGetSlotDouble(vm, 1);
 
-    int compressedLength;
-    unsigned char* compressed = CompressData(data, length, &compressedLength);
+    if (index < 0 || index >= buffer->size) {
+        VM_ABORT(vm, "Invalid buffer index.");
+        return;
+    }
 
-    wrenSetSlotBytes(vm, 0, compressed, compressedLength);
-    free(compressed);
+    wrenSetSlotDouble(vm, 0, buffer->data[index]);
 }
 
-void dataDecompress(WrenVM* vm)
+void bufferSetIndex(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "data");
-
-    int length;
-    const char* data = wrenGetSlotBytes(vm, 1, &length);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "index");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "value");
+    int index = (int)wrenGetSlotDouble(vm, 1);
+    uint8_t value = (uint8_t)wrenGetSlotDouble(vm, 2);
 
-    int decompressedLength;
-    unsigned char* decompressed = DecompressData(data, length, &decompressedLength);
+    if (index < 0 || index >= buffer->size) {
+        VM_ABORT(vm, "Invalid buffer index.");
+        return;
+    }
 
-    wrenSetSlotBytes(vm, 0, decompressed, decompressedLength);
-    free(decompressed);
+    buffer->data[index] = value;
 }
 
-void dataEncodeBase64(WrenVM* vm)
+void bufferFill(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "data");
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
+    uint8_t value = (uint8_t)wrenGetSlotDouble(vm, 1);
+    memset(buffer->data, value, buffer->size);
+}
 
-    int length;
-    const char* data = wrenGetSlotBytes(vm, 1, &length);
+void bufferReadInt8(WrenVM* vm)
+{
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
+    int offset = (int)wrenGetSlotDouble(vm, 1);
 
-    int encodedLength;
-    char* encoded = EncodeDataBase64(data, length, &encodedLength);
+    if (offset < 0 || offset + 1 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
 
-    wrenSetSlotBytes(vm, 0, encoded, encodedLength);
-    free(encoded);
+    wrenSetSlotDouble(vm, 0, *(int8_t*)(&buffer->data[offset]));
 }
 
-void dataDecodeBase64(WrenVM* vm)
+void bufferReadUint8(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "data");
-
-    int length;
-    const char* data = wrenGetSlotBytes(vm, 1, &length);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
+    int offset = (int)wrenGetSlotDouble(vm, 1);
 
-    int decodedLength;
-    unsigned char* decoded = DecodeDataBase64(data, &decodedLength);
+    if (offset < 0 || offset + 1 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
 
-    wrenSetSlotBytes(vm, 0, decoded, decodedLength);
-    free(decoded);
+    wrenSetSlotDouble(vm, 0, *(uint8_t*)(&buffer->data[offset]));
 }
 
-void dataEncodeHex(WrenVM* vm)
+void bufferReadInt16(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "data");
-
-    int length;
-    const char* data = wrenGetSlotBytes(vm, 1, &length);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
+    int offset = (int)wrenGetSlotDouble(vm, 1);
 
-    size_t encodedLength;
-    char* encoded = bytesToHex(data, length, &encodedLength);
+    if (offset < 0 || offset + 2 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
 
-    wrenSetSlotBytes(vm, 0, encoded, encodedLength);
-    free(encoded);
+    wrenSetSlotDouble(vm, 0, *(int16_t*)(&buffer->data[offset]));
 }
 
-void dataDecodeHex(WrenVM* vm)
+void bufferReadUint16(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "data");
-
-    int length;
-    const char* data = wrenGetSlotBytes(vm, 1, &length);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
+    int offset = (int)wrenGetSlotDouble(vm, 1);
 
-    size_t decodedLength;
-    unsigned char* decoded = hexToBytes(data, length, &decodedLength);
+    if (offset < 0 || offset + 2 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
 
-    wrenSetSlotBytes(vm, 0, decoded, decodedLength);
-    free(decoded);
+    wrenSetSlotDouble(vm, 0, *(uint16_t*)(&buffer->data[offset]));
 }
 
-void dataHash(WrenVM* vm)
+void bufferReadInt32(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "data");
-
-    int length;
-    const char* data = wrenGetSlotBytes(vm, 1, &length);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
+    int offset = (int)wrenGetSlotDouble(vm, 1);
 
-    BYTE buf[SHA256_BLOCK_SIZE];
-    SHA256_CTX ctx;
-    sha256_init(&ctx);
-    sha256_update(&ctx, data, length);
-    sha256_final(&ctx, buf);
+    if (offset < 0 || offset + 4 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
 
-    wrenSetSlotBytes(vm, 0, buf, SHA256_BLOCK_SIZE);
+    wrenSetSlotDouble(vm, 0, *(int32_t*)(&buffer->data[offset]));
 }
 
-void directoryExists(WrenVM* vm)
+void bufferReadUint32(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
-    const char* path = wrenGetSlotString(vm, 1);
-    wrenSetSlotBool(vm, 0, DirectoryExists(path));
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
+    int offset = (int)wrenGetSlotDouble(vm, 1);
+
+    if (offset < 0 || offset + 4 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
+
+    wrenSetSlotDouble(vm, 0, *(uint32_t*)(&buffer->data[offset]));
 }
 
-void directoryList(WrenVM* vm)
+void bufferReadInt64(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
-    const char* path = wrenGetSlotString(vm, 1);
-    FilePathList list = LoadDirectoryFiles(path);
-
-    wrenEnsureSlots(vm, 2);
-    wrenSetSlotNewList(vm, 0);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
+    int offset = (int)wrenGetSlotDouble(vm, 1);
 
-    for (int i = 0; i < (int)list.count; i++) {
-        wrenSetSlotString(vm, 1, list.paths[i]);
-        wrenInsertInList(vm, 0, i, 1);
+    if (offset < 0 || offset + 8 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
     }
 
-    UnloadDirectoryFiles(list);
+    wrenSetSlotDouble(vm, 0, *(int64_t*)(&buffer->data[offset]));
 }
 
-void fileExists(WrenVM* vm)
+void bufferReadUint64(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
-    const char* path = wrenGetSlotString(vm, 1);
-    wrenSetSlotBool(vm, 0, FileExists(path));
-}
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
+    int offset = (int)wrenGetSlotDouble(vm, 1);
 
-void fileSize(WrenVM* vm)
-{
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
-    const char* path = wrenGetSlotString(vm, 1);
-    wrenSetSlotDouble(vm, 0, GetFileLength(path));
+    if (offset < 0 || offset + 8 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
+
+    wrenSetSlotDouble(vm, 0, *(uint64_t*)(&buffer->data[offset]));
 }
 
-void fileRead(WrenVM* vm)
+void bufferReadFloat(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
-    const char* path = wrenGetSlotString(vm, 1);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
+    int offset = (int)wrenGetSlotDouble(vm, 1);
 
-    FILE* file = fopen(path, "rb");
-    if (file == NULL) {
-        VM_ABORT(vm, "Failed to open file.");
+    if (offset < 0 || offset + 4 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
 
-    fseek(file, 0, SEEK_END);
-    long size = ftell(file);
-    rewind(file);
+    wrenSetSlotDouble(vm, 0, *(float*)(&buffer->data[offset]));
+}
 
-    char* data = (char*)malloc(size);
-    if (data == NULL) {
-        fclose(file);
-        VM_ABORT(vm, "Failed to allocate memory.");
+void bufferReadDouble(WrenVM* vm)
+{
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
+    int offset = (int)wrenGetSlotDouble(vm, 1);
+
+    if (offset < 0 || offset + 8 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
 
-    fread(data, 1, size, file);
-    fclose(file);
-
-    wrenSetSlotBytes(vm, 0, data, size);
-    free(data);
+    wrenSetSlotDouble(vm, 0, *(double*)(&buffer->data[offset]));
 }
 
-void fileReadEmbedded(WrenVM* vm)
+void bufferReadBool(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
-    const char* path = wrenGetSlotString(vm, 1);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
+    int offset = (int)wrenGetSlotDouble(vm, 1);
 
-    int length;
-    unsigned char* file = LoadFileData(path, &length);
-    wrenSetSlotBytes(vm, 0, file, length);
-    UnloadFileData(file);
+    if (offset < 0 || offset + 1 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
+
+    wrenSetSlotBool(vm, 0, *(bool*)(&buffer->data[offset]));
 }
 
-void fileWrite(WrenVM* vm)
+void bufferReadString(WrenVM* vm)
 {
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
-    ASSERT_SLOT_TYPE(vm, 2, STRING, "data");
-    const char* path = wrenGetSlotString(vm, 1);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "size");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    int size = (int)wrenGetSlotDouble(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
 
-    int length;
-    const char* data = wrenGetSlotBytes(vm, 2, &length);
-    SaveFileData(path, (void*)data, length);
-}
+    if (offset < 0 || offset + size > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
 
-void bufferAllocate(WrenVM* vm)
-{
-    wrenEnsureSlots(vm, 1);
-    wrenSetSlotNewForeign(vm, 0, 0, sizeof(Buffer));
+    char* str = malloc(size + 1);
+    memcpy(str, &buffer->data[offset], size);
+    str[size] = '\0';
+    wrenSetSlotString(vm, 0, str);
+    free(str);
 }
 
-void bufferFinalize(void* data)
+void bufferWriteInt8(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)data;
-    free(buffer->data);
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    int8_t value = (int8_t)wrenGetSlotDouble(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
+
+    if (offset < 0 || offset + 1 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
+
+    *(int8_t*)(&buffer->data[offset]) = value;
+    wrenSetSlotDouble(vm, 0, offset + 1);
 }
 
-void bufferNew(WrenVM* vm)
+void bufferWriteUint8(WrenVM* vm)
 {
     Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "size");
-    int size = (int)wrenGetSlotDouble(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    uint8_t value = (uint8_t)wrenGetSlotDouble(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
 
-    buffer->data = calloc(size, sizeof(uint8_t));
-    if (buffer->data == NULL) {
-        VM_ABORT(vm, "Failed to allocate buffer.");
+    if (offset < 0 || offset + 1 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
 
-    buffer->size = size;
+    *(uint8_t*)(&buffer->data[offset]) = value;
+    wrenSetSlotDouble(vm, 0, offset + 1);
 }
 
-void bufferNew2(WrenVM* vm)
+void bufferWriteInt16(WrenVM* vm)
 {
     Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    int16_t value = (int16_t)wrenGetSlotDouble(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
 
-    if (wrenGetSlotType(vm, 1) == WREN_TYPE_LIST) {
-        int size = wrenGetListCount(vm, 1);
-        buffer->data = calloc(size, sizeof(uint8_t));
-        if (buffer->data == NULL) {
-            VM_ABORT(vm, "Failed to allocate buffer.");
-            return;
-        }
-
-        wrenEnsureSlots(vm, 3);
-        for (int i = 0; i < size; i++) {
-            wrenGetListElement(vm, 1, i, 2);
-
-            if (wrenGetSlotType(vm, 2) != WREN_TYPE_NUM) {
-                VM_ABORT(vm, "Invalid buffer data.");
-                return;
-            }
+    if (offset < 0 || offset + 2 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
 
-            buffer->data[i] = (uint8_t)wrenGetSlotDouble(vm, 2);
-        }
+    *(int16_t*)(&buffer->data[offset]) = value;
+    wrenSetSlotDouble(vm, 0, offset + 2);
+}
 
-        buffer->size = size;
-    } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_STRING) {
-        int length;
-        const char* data = wrenGetSlotBytes(vm, 1, &length);
+void bufferWriteUint16(WrenVM* vm)
+{
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    uint16_t value = (uint16_t)wrenGetSlotDouble(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
 
-        buffer->data = calloc(length, sizeof(uint8_t));
-        if (buffer->data == NULL) {
-            VM_ABORT(vm, "Failed to allocate buffer.");
-            return;
-        }
+    if (offset < 0 || offset + 2 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
 
-        memcpy(buffer->data, data, length);
-        buffer->size = length;
-    } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_FOREIGN) {
-        Buffer* other = (Buffer*)wrenGetSlotForeign(vm, 1);
+    *(uint16_t*)(&buffer->data[offset]) = value;
+    wrenSetSlotDouble(vm, 0, offset + 2);
+}
 
-        buffer->data = calloc(other->size, sizeof(uint8_t));
-        if (buffer->data == NULL) {
-            VM_ABORT(vm, "Failed to allocate buffer.");
-            return;
-        }
+void bufferWriteInt32(WrenVM* vm)
+{
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    int32_t value = (int32_t)wrenGetSlotDouble(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
 
-        memcpy(buffer->data, other->data, other->size);
-        buffer->size = other->size;
-    } else {
-        VM_ABORT(vm, "Invalid buffer data.");
+    if (offset < 0 || offset + 4 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
+
+    *(int32_t*)(&buffer->data[offset]) = value;
+    wrenSetSlotDouble(vm, 0, offset + 4);
 }
 
-void bufferGetIndex(WrenVM* vm)
+void bufferWriteUint32(WrenVM* vm)
 {
     Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "index");
-    int index = (int)wrenGetSlotDouble(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    uint32_t value = (uint32_t)wrenGetSlotDouble(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
 
-    if (index < 0 || index >= buffer->size) {
-        VM_ABORT(vm, "Invalid buffer index.");
+    if (offset < 0 || offset + 4 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
 
-    wrenSetSlotDouble(vm, 0, buffer->data[index]);
+    *(uint32_t*)(&buffer->data[offset]) = value;
+    wrenSetSlotDouble(vm, 0, offset + 4);
 }
 
-void bufferSetIndex(WrenVM* vm)
+void bufferWriteInt64(WrenVM* vm)
 {
     Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "index");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "value");
-    int index = (int)wrenGetSlotDouble(vm, 1);
-    uint8_t value = (uint8_t)wrenGetSlotDouble(vm, 2);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    int64_t value = (int64_t)wrenGetSlotDouble(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
 
-    if (index < 0 || index >= buffer->size) {
-        VM_ABORT(vm, "Invalid buffer index.");
+    if (offset < 0 || offset + 8 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
 
-    buffer->data[index] = value;
+    *(int64_t*)(&buffer->data[offset]) = value;
+    wrenSetSlotDouble(vm, 0, offset + 8);
 }
 
-void bufferFill(WrenVM* vm)
+void bufferWriteUint64(WrenVM* vm)
 {
     Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
-    uint8_t value = (uint8_t)wrenGetSlotDouble(vm, 1);
-    memset(buffer->data, value, buffer->size);
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    uint64_t value = (uint64_t)wrenGetSlotDouble(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
+
+    if (offset < 0 || offset + 8 > buffer->size) {
+        VM_ABORT(vm, "Invalid buffer offset.");
+        return;
+    }
+
+    *(uint64_t*)(&buffer->data[offset]) = value;
+    wrenSetSlotDouble(vm, 0, offset + 8);
 }
 
-void bufferReadInt8(WrenVM* vm)
+void bufferWriteFloat(WrenVM* vm)
 {
     Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
-    int offset = (int)wrenGetSlotDouble(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    float value = (float)wrenGetSlotDouble(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
 
-    if (offset < 0 || offset + 1 > buffer->size) {
+    if (offset < 0 || offset + 4 > buffer->size) {
         VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
 
-    wrenSetSlotDouble(vm, 0, *(int8_t*)(&buffer->data[offset]));
+    *(float*)(&buffer->data[offset]) = value;
+    wrenSetSlotDouble(vm, 0, offset + 4);
 }
 
-void bufferReadUint8(WrenVM* vm)
+void bufferWriteDouble(WrenVM* vm)
 {
     Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
-    int offset = (int)wrenGetSlotDouble(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    double value = wrenGetSlotDouble(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
 
-    if (offset < 0 || offset + 1 > buffer->size) {
+    if (offset < 0 || offset + 8 > buffer->size) {
         VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
 
-    wrenSetSlotDouble(vm, 0, *(uint8_t*)(&buffer->data[offset]));
+    *(double*)(&buffer->data[offset]) = value;
+    wrenSetSlotDouble(vm, 0, offset + 8);
 }
 
-void bufferReadInt16(WrenVM* vm)
+void bufferWriteBool(WrenVM* vm)
 {
     Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
-    int offset = (int)wrenGetSlotDouble(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, BOOL, "value");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    bool value = wrenGetSlotBool(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
 
-    if (offset < 0 || offset + 2 > buffer->size) {
+    if (offset < 0 || offset + 1 > buffer->size) {
         VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
 
-    wrenSetSlotDouble(vm, 0, *(int16_t*)(&buffer->data[offset]));
+    *(bool*)(&buffer->data[offset]) = value;
+    wrenSetSlotDouble(vm, 0, offset + 1);
 }
 
-void bufferReadUint16(WrenVM* vm)
+void bufferWriteString(WrenVM* vm)
 {
     Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
-    int offset = (int)wrenGetSlotDouble(vm, 1);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "value");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    const char* value = wrenGetSlotString(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
 
-    if (offset < 0 || offset + 2 > buffer->size) {
+    int size = TextLength(value);
+
+    if (offset < 0 || offset + size > buffer->size) {
         VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
 
-    wrenSetSlotDouble(vm, 0, *(uint16_t*)(&buffer->data[offset]));
+    memcpy(&buffer->data[offset], value, size);
+    wrenSetSlotDouble(vm, 0, offset + size);
 }
 
-void bufferReadInt32(WrenVM* vm)
+void bufferGetSize(WrenVM* vm)
 {
     Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
-    int offset = (int)wrenGetSlotDouble(vm, 1);
+    wrenSetSlotDouble(vm, 0, buffer->size);
+}
 
-    if (offset < 0 || offset + 4 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+void bufferGetToString(WrenVM* vm)
+{
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotBytes(vm, 0, buffer->data, buffer->size);
+}
+
+void bufferGetToList(WrenVM* vm)
+{
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+
+    wrenEnsureSlots(vm, 2);
+    wrenSetSlotNewList(vm, 0);
+
+    for (int i = 0; i < buffer->size; i++) {
+        wrenSetSlotDouble(vm, 1, buffer->data[i]);
+        wrenInsertInList(vm, 0, i, 1);
+    }
+}
+
+void fileHandleAllocate(WrenVM* vm)
+{
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(FileHandle));
+}
+
+void fileHandleFinalize(void* data)
+{
+    FileHandle* handle = (FileHandle*)data;
+
+    if (handle->file)
+        fclose(handle->file);
+
+    free(handle->scratch);
+}
+
+static FileHandle* getOpenFileHandle(WrenVM* vm)
+{
+    FileHandle* handle = (FileHandle*)wrenGetSlotForeign(vm, 0);
+
+    if (handle->file == NULL) {
+        VM_ABORT(vm, "File is closed.");
+        return NULL;
+    }
+
+    return handle;
+}
+
+// Grows the per handle scratch buffer used by read and readLine, so reading doesn't allocate every call.
+#define FILE_LINE_BLOCK 4096
+
+static bool reserveScratch(FileHandle* handle, size_t size)
+{
+    if (size <= handle->scratchSize)
+        return true;
+
+    size_t capacity = handle->scratchSize ? handle->scratchSize : 256;
+    while (capacity < size)
+        capacity *= 2;
+
+    char* scratch = (char*)realloc(handle->scratch, capacity);
+    if (scratch == NULL)
+        return false;
+
+    handle->scratch = scratch;
+    handle->scratchSize = capacity;
+
+    return true;
+}
+
+void fileHandleOpen(WrenVM* vm)
+{
+    FileHandle* handle = (FileHandle*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    ASSERT_SLOT_TYPE(vm, 2, STRING, "mode");
+    const char* path = wrenGetSlotString(vm, 1);
+    const char* mode = wrenGetSlotString(vm, 2);
+
+    // Always binary, so positions and sizes match the bytes on disk on every platform.
+    const char* modes[] = { "r", "w", "a", "r+", "w+", "a+" };
+    const char* binaryModes[] = { "rb", "wb", "ab", "r+b", "w+b", "a+b" };
+
+    const char* openMode = NULL;
+    for (int i = 0; i < 6; i++) {
+        if (TextIsEqual(mode, modes[i]))
+            openMode = binaryModes[i];
+    }
+
+    if (openMode == NULL) {
+        VM_ABORT(vm, "Invalid file mode.");
         return;
     }
 
-    wrenSetSlotDouble(vm, 0, *(int32_t*)(&buffer->data[offset]));
+    handle->file = fopen(path, openMode);
+    if (handle->file == NULL) {
+        VM_ABORT(vm, "Failed to open file.");
+        return;
+    }
 }
 
-void bufferReadUint32(WrenVM* vm)
+void fileHandleRead(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
-    int offset = (int)wrenGetSlotDouble(vm, 1);
+    FileHandle* handle = getOpenFileHandle(vm);
+    if (handle == NULL)
+        return;
 
-    if (offset < 0 || offset + 4 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "size");
+    int size = (int)wrenGetSlotDouble(vm, 1);
+
+    if (size < 0) {
+        VM_ABORT(vm, "Invalid read size.");
         return;
     }
 
-    wrenSetSlotDouble(vm, 0, *(uint32_t*)(&buffer->data[offset]));
+    if (!reserveScratch(handle, size > 0 ? size : 1)) {
+        VM_ABORT(vm, "Failed to allocate memory.");
+        return;
+    }
+
+    size_t read = fread(handle->scratch, 1, size, handle->file);
+    if (read == 0 && size > 0) {
+        wrenSetSlotNull(vm, 0);
+        return;
+    }
+
+    wrenSetSlotBytes(vm, 0, handle->scratch, read);
 }
 
-void bufferReadInt64(WrenVM* vm)
+void fileHandleReadInto(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
-    int offset = (int)wrenGetSlotDouble(vm, 1);
+    FileHandle* handle = getOpenFileHandle(vm);
+    if (handle == NULL)
+        return;
 
-    if (offset < 0 || offset + 8 > buffer->size) {
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "buffer");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "size");
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
+    int size = (int)wrenGetSlotDouble(vm, 3);
+
+    if (offset < 0 || size < 0 || offset + size > buffer->size) {
         VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
 
-    wrenSetSlotDouble(vm, 0, *(int64_t*)(&buffer->data[offset]));
+    wrenSetSlotDouble(vm, 0, fread(&buffer->data[offset], 1, size, handle->file));
 }
 
-void bufferReadUint64(WrenVM* vm)
+void fileHandleReadLine(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
-    int offset = (int)wrenGetSlotDouble(vm, 1);
+    FileHandle* handle = getOpenFileHandle(vm);
+    if (handle == NULL)
+        return;
 
-    if (offset < 0 || offset + 8 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+    size_t length = 0;
+    bool newline = false;
+
+    // Reads a block at a time with fgets. The block is prefilled with '\n' so the end of the
+    // line can be told apart from the terminator fgets writes, even if the line holds NUL bytes.
+    for (;;) {
+        if (!reserveScratch(handle, length + FILE_LINE_BLOCK)) {
+            VM_ABORT(vm, "Failed to allocate memory.");
+            return;
+        }
+
+        char* block = handle->scratch + length;
+        memset(block, '\n', FILE_LINE_BLOCK);
+
+        if (fgets(block, FILE_LINE_BLOCK, handle->file) == NULL)
+            break;
+
+        char* end = (char*)memchr(block, '\n', FILE_LINE_BLOCK);
+
+        // Filled without reaching the end of the line.
+        if (end == NULL) {
+            length += FILE_LINE_BLOCK - 1;
+            continue;
+        }
+
+        // A newline read from the file is followed by the terminator, a prefilled one follows it.
+        if (end + 1 < block + FILE_LINE_BLOCK && end[1] == '\0') {
+            length += end - block;
+            newline = true;
+        } else {
+            length += end - 1 - block;
+        }
+
+        break;
+    }
+
+    if (!newline && length == 0) {
+        wrenSetSlotNull(vm, 0);
         return;
     }
 
-    wrenSetSlotDouble(vm, 0, *(uint64_t*)(&buffer->data[offset]));
+    if (length > 0 && handle->scratch[length - 1] == '\r')
+        length--;
+
+    wrenSetSlotBytes(vm, 0, handle->scratch, length);
 }
 
-void bufferReadFloat(WrenVM* vm)
+void fileHandleWrite(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
-    int offset = (int)wrenGetSlotDouble(vm, 1);
+    FileHandle* handle = getOpenFileHandle(vm);
+    if (handle == NULL)
+        return;
 
-    if (offset < 0 || offset + 4 > buffer->size) {
+    const char* data;
+    int length;
+
+    if (wrenGetSlotType(vm, 1) == WREN_TYPE_STRING) {
+        data = wrenGetSlotBytes(vm, 1, &length);
+    } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_FOREIGN) {
+        Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
+        data = (const char*)buffer->data;
+        length = buffer->size;
+    } else {
+        VM_ABORT(vm, "Expected data to be a string or a buffer.");
+        return;
+    }
+
+    if (fwrite(data, 1, length, handle->file) != (size_t)length) {
+        VM_ABORT(vm, "Failed to write file.");
+        return;
+    }
+}
+
+void fileHandleWrite2(WrenVM* vm)
+{
+    FileHandle* handle = getOpenFileHandle(vm);
+    if (handle == NULL)
+        return;
+
+    ASSERT_SLOT_TYPE(vm, 1, FOREIGN, "buffer");
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
+    ASSERT_SLOT_TYPE(vm, 3, NUM, "size");
+    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 1);
+    int offset = (int)wrenGetSlotDouble(vm, 2);
+    int size = (int)wrenGetSlotDouble(vm, 3);
+
+    if (offset < 0 || size < 0 || offset + size > buffer->size) {
         VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
-
-    wrenSetSlotDouble(vm, 0, *(float*)(&buffer->data[offset]));
+
+    if (fwrite(&buffer->data[offset], 1, size, handle->file) != (size_t)size) {
+        VM_ABORT(vm, "Failed to write file.");
+        return;
+    }
 }
 
-void bufferReadDouble(WrenVM* vm)
+static void seekFileHandle(WrenVM* vm, FileHandle* handle, int whence)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
-    int offset = (int)wrenGetSlotDouble(vm, 1);
+    int64_t offset = (int64_t)wrenGetSlotDouble(vm, 1);
 
-    if (offset < 0 || offset + 8 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+    if (fileSeek(handle->file, offset, whence) != 0) {
+        VM_ABORT(vm, "Failed to seek file.");
         return;
     }
 
-    wrenSetSlotDouble(vm, 0, *(double*)(&buffer->data[offset]));
+    wrenSetSlotDouble(vm, 0, (double)fileTell(handle->file));
 }
 
-void bufferReadBool(WrenVM* vm)
+void fileHandleSeek(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "offset");
-    int offset = (int)wrenGetSlotDouble(vm, 1);
-
-    if (offset < 0 || offset + 1 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+    FileHandle* handle = getOpenFileHandle(vm);
+    if (handle == NULL)
         return;
-    }
 
-    wrenSetSlotBool(vm, 0, *(bool*)(&buffer->data[offset]));
+    seekFileHandle(vm, handle, SEEK_SET);
 }
 
-void bufferReadString(WrenVM* vm)
+void fileHandleSeek2(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "size");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    int size = (int)wrenGetSlotDouble(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
+    FileHandle* handle = getOpenFileHandle(vm);
+    if (handle == NULL)
+        return;
 
-    if (offset < 0 || offset + size > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+    ASSERT_SLOT_TYPE(vm, 2, STRING, "whence");
+    const char* whence = wrenGetSlotString(vm, 2);
+
+    if (TextIsEqual(whence, "set")) {
+        seekFileHandle(vm, handle, SEEK_SET);
+    } else if (TextIsEqual(whence, "cur")) {
+        seekFileHandle(vm, handle, SEEK_CUR);
+    } else if (TextIsEqual(whence, "end")) {
+        seekFileHandle(vm, handle, SEEK_END);
+    } else {
+        VM_ABORT(vm, "Invalid seek origin.");
         return;
     }
-
-    char* str = malloc(size + 1);
-    memcpy(str, &buffer->data[offset], size);
-    str[size] = '\0';
-    wrenSetSlotString(vm, 0, str);
-    free(str);
 }
 
-void bufferWriteInt8(WrenVM* vm)
+void fileHandleFlush(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    int8_t value = (int8_t)wrenGetSlotDouble(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
-
-    if (offset < 0 || offset + 1 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+    FileHandle* handle = getOpenFileHandle(vm);
+    if (handle == NULL)
         return;
-    }
 
-    *(int8_t*)(&buffer->data[offset]) = value;
-    wrenSetSlotDouble(vm, 0, offset + 1);
+    fflush(handle->file);
 }
 
-void bufferWriteUint8(WrenVM* vm)
+void fileHandleClose(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    uint8_t value = (uint8_t)wrenGetSlotDouble(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
+    FileHandle* handle = (FileHandle*)wrenGetSlotForeign(vm, 0);
 
-    if (offset < 0 || offset + 1 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
-        return;
+    if (handle->file) {
+        fclose(handle->file);
+        handle->file = NULL;
     }
 
-    *(uint8_t*)(&buffer->data[offset]) = value;
-    wrenSetSlotDouble(vm, 0, offset + 1);
+    free(handle->scratch);
+    handle->scratch = NULL;
+    handle->scratchSize = 0;
 }
 
-void bufferWriteInt16(WrenVM* vm)
+void fileHandleGetPosition(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    int16_t value = (int16_t)wrenGetSlotDouble(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
-
-    if (offset < 0 || offset + 2 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+    FileHandle* handle = getOpenFileHandle(vm);
+    if (handle == NULL)
         return;
-    }
 
-    *(int16_t*)(&buffer->data[offset]) = value;
-    wrenSetSlotDouble(vm, 0, offset + 2);
+    wrenSetSlotDouble(vm, 0, (double)fileTell(handle->file));
 }
 
-void bufferWriteUint16(WrenVM* vm)
+void fileHandleGetSize(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    uint16_t value = (uint16_t)wrenGetSlotDouble(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
+    FileHandle* handle = getOpenFileHandle(vm);
+    if (handle == NULL)
+        return;
 
-    if (offset < 0 || offset + 2 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+    int64_t position = fileTell(handle->file);
+    fileSeek(handle->file, 0, SEEK_END);
+    int64_t size = fileTell(handle->file);
+    fileSeek(handle->file, position, SEEK_SET);
+
+    wrenSetSlotDouble(vm, 0, (double)size);
+}
+
+void fileHandleGetEof(WrenVM* vm)
+{
+    FileHandle* handle = getOpenFileHandle(vm);
+    if (handle == NULL)
         return;
-    }
 
-    *(uint16_t*)(&buffer->data[offset]) = value;
-    wrenSetSlotDouble(vm, 0, offset + 2);
+    wrenSetSlotBool(vm, 0, feof(handle->file) != 0);
 }
 
-void bufferWriteInt32(WrenVM* vm)
+void fileHandleGetIsOpen(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    int32_t value = (int32_t)wrenGetSlotDouble(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
+    FileHandle* handle = (FileHandle*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotBool(vm, 0, handle->file != NULL);
+}
 
-    if (offset < 0 || offset + 4 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+enum { FILE_JOB_READ, FILE_JOB_READ_EMBEDDED, FILE_JOB_WRITE };
+
+struct FileJob {
+    int type;
+    char* path;
+    Egg* egg;
+    unsigned char* data; // Read result, or the bytes to write
+    size_t size;
+    const char* error;
+};
+
+static void runFileJob(void* arg)
+{
+    FileJob* job = (FileJob*)arg;
+
+    if (job->type == FILE_JOB_READ_EMBEDDED && job->egg) {
+        job->data = eggLoad(job->egg, job->path, &job->size);
+        if (job->data == NULL)
+            job->error = "Failed to read embedded file.";
         return;
     }
 
-    *(int32_t*)(&buffer->data[offset]) = value;
-    wrenSetSlotDouble(vm, 0, offset + 4);
-}
+    if (job->type == FILE_JOB_WRITE) {
+        FILE* file = fopen(job->path, "wb");
+        if (file == NULL) {
+            job->error = "Failed to open file.";
+            return;
+        }
 
-void bufferWriteUint32(WrenVM* vm)
-{
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    uint32_t value = (uint32_t)wrenGetSlotDouble(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
+        if (fwrite(job->data, 1, job->size, file) != job->size)
+            job->error = "Failed to write file.";
+        if (fclose(file) != 0 && job->error == NULL)
+            job->error = "Failed to write file.";
 
-    if (offset < 0 || offset + 4 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
         return;
     }
 
-    *(uint32_t*)(&buffer->data[offset]) = value;
-    wrenSetSlotDouble(vm, 0, offset + 4);
+    FILE* file = fopen(job->path, "rb");
+    if (file == NULL) {
+        job->error = "Failed to open file.";
+        return;
+    }
+
+    fileSeek(file, 0, SEEK_END);
+    int64_t size = fileTell(file);
+    fileSeek(file, 0, SEEK_SET);
+
+    job->data = size >= 0 ? (unsigned char*)malloc(size > 0 ? (size_t)size : 1) : NULL;
+    if (job->data == NULL) {
+        job->error = "Failed to allocate memory.";
+    } else {
+        job->size = fread(job->data, 1, (size_t)size, file);
+        if (job->size != (size_t)size)
+            job->error = "Failed to read file.";
+    }
+
+    fclose(file);
 }
 
-void bufferWriteInt64(WrenVM* vm)
+void fileTaskAllocate(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    int64_t value = (int64_t)wrenGetSlotDouble(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
+    wrenEnsureSlots(vm, 1);
+    wrenSetSlotNewForeign(vm, 0, 0, sizeof(FileTask));
+}
 
-    if (offset < 0 || offset + 8 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
-        return;
-    }
+void fileTaskFinalize(void* data)
+{
+    FileTask* task = (FileTask*)data;
 
-    *(int64_t*)(&buffer->data[offset]) = value;
-    wrenSetSlotDouble(vm, 0, offset + 8);
+    // Dropping a task doesn't cancel it, wait for the worker to let go of the job first.
+    if (task->task)
+        poolTaskFree(task->task);
+
+    if (task->job) {
+        free(task->job->path);
+        free(task->job->data);
+        free(task->job);
+    }
 }
 
-void bufferWriteUint64(WrenVM* vm)
+static void startFileTask(WrenVM* vm, int type, const char* path, const char* data, size_t size)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    uint64_t value = (uint64_t)wrenGetSlotDouble(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
+    FileTask* task = (FileTask*)wrenGetSlotForeign(vm, 0);
 
-    if (offset < 0 || offset + 8 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+    FileJob* job = (FileJob*)calloc(1, sizeof(FileJob));
+    if (job == NULL) {
+        VM_ABORT(vm, "Failed to allocate memory.");
         return;
     }
 
-    *(uint64_t*)(&buffer->data[offset]) = value;
-    wrenSetSlotDouble(vm, 0, offset + 8);
-}
+    job->type = type;
+    job->egg = ((vmData*)wrenGetUserData(vm))->egg;
 
-void bufferWriteFloat(WrenVM* vm)
-{
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    float value = (float)wrenGetSlotDouble(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
+    size_t length = strlen(path);
+    job->path = (char*)malloc(length + 1);
+    if (job->path)
+        memcpy(job->path, path, length + 1);
 
-    if (offset < 0 || offset + 4 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+    if (data) {
+        job->data = (unsigned char*)malloc(size > 0 ? size : 1);
+        if (job->data)
+            memcpy(job->data, data, size);
+        job->size = size;
+    }
+
+    task->job = job;
+
+    if (job->path == NULL || (data && job->data == NULL)) {
+        VM_ABORT(vm, "Failed to allocate memory.");
         return;
     }
 
-    *(float*)(&buffer->data[offset]) = value;
-    wrenSetSlotDouble(vm, 0, offset + 4);
+    task->task = poolSubmit(runFileJob, job);
+
+    // No worker threads, do it now rather than never.
+    if (task->task == NULL)
+        runFileJob(job);
 }
 
-void bufferWriteDouble(WrenVM* vm)
+void fileTaskRead(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, NUM, "value");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    double value = wrenGetSlotDouble(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    startFileTask(vm, FILE_JOB_READ, wrenGetSlotString(vm, 1), NULL, 0);
+}
 
-    if (offset < 0 || offset + 8 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+void fileTaskReadEmbedded(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    startFileTask(vm, FILE_JOB_READ_EMBEDDED, wrenGetSlotString(vm, 1), NULL, 0);
+}
+
+void fileTaskWrite(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    const char* path = wrenGetSlotString(vm, 1);
+
+    if (wrenGetSlotType(vm, 2) == WREN_TYPE_STRING) {
+        int length;
+        const char* data = wrenGetSlotBytes(vm, 2, &length);
+        startFileTask(vm, FILE_JOB_WRITE, path, data, length);
+    } else if (wrenGetSlotType(vm, 2) == WREN_TYPE_FOREIGN) {
+        Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 2);
+        startFileTask(vm, FILE_JOB_WRITE, path, (const char*)buffer->data, buffer->size);
+    } else {
+        VM_ABORT(vm, "Expected data to be a string or a buffer.");
         return;
     }
+}
 
-    *(double*)(&buffer->data[offset]) = value;
-    wrenSetSlotDouble(vm, 0, offset + 8);
+void fileTaskGetComplete(WrenVM* vm)
+{
+    FileTask* task = (FileTask*)wrenGetSlotForeign(vm, 0);
+    wrenSetSlotBool(vm, 0, task->task == NULL || poolTaskDone(task->task));
 }
 
-void bufferWriteBool(WrenVM* vm)
+void fileTaskGetResult(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, BOOL, "value");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    bool value = wrenGetSlotBool(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
+    FileTask* task = (FileTask*)wrenGetSlotForeign(vm, 0);
 
-    if (offset < 0 || offset + 1 > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+    if (task->task && !poolTaskDone(task->task)) {
+        VM_ABORT(vm, "File task is not complete.");
         return;
     }
 
-    *(bool*)(&buffer->data[offset]) = value;
-    wrenSetSlotDouble(vm, 0, offset + 1);
+    if (task->job->error) {
+        VM_ABORT(vm, task->job->error);
+        return;
+    }
+
+    if (task->job->type == FILE_JOB_WRITE)
+        wrenSetSlotNull(vm, 0);
+    else
+        wrenSetSlotBytes(vm, 0, (const char*)task->job->data, task->job->size);
 }
 
-void bufferWriteString(WrenVM* vm)
+void fileTaskGetError(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    ASSERT_SLOT_TYPE(vm, 1, STRING, "value");
-    ASSERT_SLOT_TYPE(vm, 2, NUM, "offset");
-    const char* value = wrenGetSlotString(vm, 1);
-    int offset = (int)wrenGetSlotDouble(vm, 2);
+    FileTask* task = (FileTask*)wrenGetSlotForeign(vm, 0);
 
-    int size = TextLength(value);
+    if ((task->task && !poolTaskDone(task->task)) || task->job->error == NULL)
+        wrenSetSlotNull(vm, 0);
+    else
+        wrenSetSlotString(vm, 0, task->job->error);
+}
 
-    if (offset < 0 || offset + size > buffer->size) {
-        VM_ABORT(vm, "Invalid buffer offset.");
+void hotWatch(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    const char* path = wrenGetSlotString(vm, 1);
+
+    // Nothing to watch when running from an egg.
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    if (data->egg) {
+        wrenSetSlotBool(vm, 0, false);
         return;
     }
 
-    memcpy(&buffer->data[offset], value, size);
-    wrenSetSlotDouble(vm, 0, offset + size);
+    if (!reloadWatch(path)) {
+        VM_ABORT(vm, "Failed to watch directory.");
+        return;
+    }
+
+    wrenSetSlotBool(vm, 0, true);
 }
 
-void bufferGetSize(WrenVM* vm)
+void hotGetState(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotDouble(vm, 0, buffer->size);
+    size_t length;
+    const char* state = reloadGetState(&length);
+
+    if (state)
+        wrenSetSlotBytes(vm, 0, state, length);
+    else
+        wrenSetSlotNull(vm, 0);
 }
 
-void bufferGetToString(WrenVM* vm)
+void hotSetState(WrenVM* vm)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
-    wrenSetSlotBytes(vm, 0, buffer->data, buffer->size);
+    if (wrenGetSlotType(vm, 1) == WREN_TYPE_NULL) {
+        reloadSetState(NULL, 0);
+        return;
+    }
+
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "state");
+
+    int length;
+    const char* state = wrenGetSlotBytes(vm, 1, &length);
+    reloadSetState(state, length);
 }
 
-void bufferGetToList(WrenVM* vm)
+static void hotAddChanged(const char* path, void* user)
 {
-    Buffer* buffer = (Buffer*)wrenGetSlotForeign(vm, 0);
+    WrenVM* vm = (WrenVM*)user;
+    wrenSetSlotString(vm, 1, path);
+    wrenInsertInList(vm, 0, -1, 1);
+}
 
+void hotPoll(WrenVM* vm)
+{
     wrenEnsureSlots(vm, 2);
     wrenSetSlotNewList(vm, 0);
+    reloadPoll(hotAddChanged, vm);
+}
 
-    for (int i = 0; i < buffer->size; i++) {
-        wrenSetSlotDouble(vm, 1, buffer->data[i]);
-        wrenInsertInList(vm, 0, i, 1);
-    }
+void hotGetScriptChanged(WrenVM* vm)
+{
+    wrenSetSlotBool(vm, 0, reloadScriptChanged());
+}
+
+void hotRestart(WrenVM* vm)
+{
+    vmData* data = (vmData*)wrenGetUserData(vm);
+    data->restart = true;
 }
 
 void requestAllocate(WrenVM* vm)
@@ -2,12 +2,17 @@
 #define API_H
 
 #include <stdint.h>
+#include <stdio.h>
 
 #include "lib/map/map.h"
 #include "lib/microui/microui.h"
 #include "lib/naett/naett.h"
 #include "lib/wren/wren.h"
 
+#include "egg.h"
+#include "pool.h"
+#include "util.h"
+
 #define VM_ABORT(vm, error)              \
     do {                                 \
         wrenSetSlotString(vm, 0, error); \
@@ -29,7 +34,11 @@ typedef struct vmData {
     mu_Context* uiCtx;
     map_int_t keys;
     WrenHandle* textureClass;
+    WrenHandle* colorClass;
+    WrenHandle* bufferClass;
     WrenHandle* peerClass;
+    Egg* egg;
+    bool restart; // Set by Hot.update when a script changed
 } vmData;
 
 void setArgs(int argc, char** argv);
@@ -42,6 +51,9 @@ int uiTextHeight(mu_Font font);
 void audioInit(WrenVM* vm);
 void audioGetVolume(WrenVM* vm);
 void audioSetVolume(WrenVM* vm);
+void audioGetMaxVoices(WrenVM* vm);
+void audioSetMaxVoices(WrenVM* vm);
+void audioGetActiveVoices(WrenVM* vm);
 
 void soundAllocate(WrenVM* vm);
 void soundFinalize(void* data);
@@ -54,10 +66,60 @@ void soundGetPlaying(WrenVM* vm);
 void soundSetVolume(WrenVM* vm);
 void soundSetPitch(WrenVM* vm);
 void soundSetPan(WrenVM* vm);
+void soundPlayVoice(WrenVM* vm);
+void soundPlayVoice2(WrenVM* vm);
+void soundStopVoices(WrenVM* vm);
+void soundSetVoices(WrenVM* vm);
+void soundSetBus(WrenVM* vm);
 
 void soundAliasFinalize(void* data);
 void soundAliasNew(WrenVM* vm);
 
+void musicAllocate(WrenVM* vm);
+void musicFinalize(void* data);
+void musicNew(WrenVM* vm);
+void musicPlay(WrenVM* vm);
+void musicStop(WrenVM* vm);
+void musicPause(WrenVM* vm);
+void musicResume(WrenVM* vm);
+void musicSeek(WrenVM* vm);
+void musicGetPlaying(WrenVM* vm);
+void musicGetLength(WrenVM* vm);
+void musicGetPosition(WrenVM* vm);
+void musicGetLooping(WrenVM* vm);
+void musicSetLooping(WrenVM* vm);
+void musicSetVolume(WrenVM* vm);
+void musicSetPitch(WrenVM* vm);
+void musicSetPan(WrenVM* vm);
+void musicSetBus(WrenVM* vm);
+
+void audioStreamAllocate(WrenVM* vm);
+void audioStreamFinalize(void* data);
+void audioStreamNew(WrenVM* vm);
+void audioStreamNew2(WrenVM* vm);
+void audioStreamWrite(WrenVM* vm);
+void audioStreamWrite2(WrenVM* vm);
+void audioStreamPlay(WrenVM* vm);
+void audioStreamStop(WrenVM* vm);
+void audioStreamPause(WrenVM* vm);
+void audioStreamResume(WrenVM* vm);
+void audioStreamGetPlaying(WrenVM* vm);
+void audioStreamGetQueued(WrenVM* vm);
+void audioStreamGetSpace(WrenVM* vm);
+void audioStreamGetLatency(WrenVM* vm);
+void audioStreamGetUnderruns(WrenVM* vm);
+void audioStreamSetVolume(WrenVM* vm);
+void audioStreamSetPitch(WrenVM* vm);
+void audioStreamSetPan(WrenVM* vm);
+void audioStreamSetBus(WrenVM* vm);
+
+void mixerGain(WrenVM* vm);
+void mixerSetGain(WrenVM* vm);
+void mixerDuck(WrenVM* vm);
+void mixerSetLowPass(WrenVM* vm);
+void mixerReverb(WrenVM* vm);
+void mixerCompressor(WrenVM* vm);
+
 // Graphics
 
 void graphicsBegin(WrenVM* vm);
@@ -67,6 +129,11 @@ void graphicsEndBlend(WrenVM* vm);
 void graphicsBeginScissor(WrenVM* vm);
 void graphicsEndScissor(WrenVM* vm);
 void graphicsScreenshot(WrenVM* vm);
+void graphicsStartRecording(WrenVM* vm);
+void graphicsStopRecording(WrenVM* vm);
+void graphicsGetRecording(WrenVM* vm);
+void graphicsGetRecordedFrames(WrenVM* vm);
+void graphicsGetCaptureFailures(WrenVM* vm);
 void graphicsMeasure(WrenVM* vm);
 void graphicsNoise(WrenVM* vm);
 void graphicsClear(WrenVM* vm);
@@ -87,6 +154,12 @@ void graphicsPolygonLines(WrenVM* vm);
 void graphicsSetNoiseSeed(WrenVM* vm);
 void graphicsSetLineSpacing(WrenVM* vm);
 
+void noiseFill(WrenVM* vm);
+void noiseFillSimplex(WrenVM* vm);
+void noiseFillSimplex2(WrenVM* vm);
+void noiseSimplex(WrenVM* vm);
+void noiseSimplex2(WrenVM* vm);
+
 void uiUpdate(WrenVM* vm);
 void uiDraw(WrenVM* vm);
 void uiBegin(WrenVM* vm);
@@ -134,6 +207,7 @@ void imageNew6(WrenVM* vm);
 void imageNew7(WrenVM* vm);
 void imageNew8(WrenVM* vm);
 void imageNew9(WrenVM* vm);
+void imageNew10(WrenVM* vm);
 void imageExport(WrenVM* vm);
 void imageExportToMemory(WrenVM* vm);
 void imageCrop(WrenVM* vm);
@@ -141,15 +215,30 @@ void imageResize(WrenVM* vm);
 void imageFlipVertical(WrenVM* vm);
 void imageFlipHorizontal(WrenVM* vm);
 void imageRotate(WrenVM* vm);
+void imageConvert(WrenVM* vm);
+void imageMipmaps(WrenVM* vm);
+void imagePremultiplyAlpha(WrenVM* vm);
+void imageGetPixels(WrenVM* vm);
+void imageGetPixel(WrenVM* vm);
+void imageSetPixel(WrenVM* vm);
+void imageFillRect(WrenVM* vm);
+void imageBlit(WrenVM* vm);
+void imageBlit2(WrenVM* vm);
+void imageReplaceColor(WrenVM* vm);
+void imageConvolve(WrenVM* vm);
 void imageGetWidth(WrenVM* vm);
 void imageGetHeight(WrenVM* vm);
 void imageGetFormat(WrenVM* vm);
+void imageGetMipmapCount(WrenVM* vm);
 
 void textureAllocate(WrenVM* vm);
 void textureFinalize(void* data);
 void textureNew(WrenVM* vm);
+void textureNew2(WrenVM* vm);
 void textureDraw(WrenVM* vm);
 void textureDrawRec(WrenVM* vm);
+void textureUpdateFromImage(WrenVM* vm);
+void textureUpdateRect(WrenVM* vm);
 void textureGetWidth(WrenVM* vm);
 void textureGetHeight(WrenVM* vm);
 void textureSetFilter(WrenVM* vm);
@@ -199,6 +288,15 @@ void shaderBegin(WrenVM* vm);
 void shaderEnd(WrenVM* vm);
 void shaderSet(WrenVM* vm);
 
+void postFXAllocate(WrenVM* vm);
+void postFXFinalize(void* data);
+void postFXNew(WrenVM* vm);
+void postFXBegin(WrenVM* vm);
+void postFXEnd(WrenVM* vm);
+void postFXApply(WrenVM* vm);
+void postFXDraw(WrenVM* vm);
+void postFXGetTargets(WrenVM* vm);
+
 // Input
 
 void keyboardPressed(WrenVM* vm);
@@ -295,13 +393,62 @@ void osSetClipboard(WrenVM* vm);
 void dataCompress(WrenVM* vm);
 void dataDecompress(WrenVM* vm);
 void dataEncodeBase64(WrenVM* vm);
+void dataEncodeBase64Into(WrenVM* vm);
 void dataDecodeBase64(WrenVM* vm);
+void dataDecodeBase64Into(WrenVM* vm);
 void dataEncodeHex(WrenVM* vm);
+void dataEncodeHexInto(WrenVM* vm);
 void dataDecodeHex(WrenVM* vm);
+void dataDecodeHexInto(WrenVM* vm);
 void dataHash(WrenVM* vm);
+void dataHash64(WrenVM* vm);
+void dataCrc32(WrenVM* vm);
+
+typedef struct {
+    bool sha256;
+    SHA256_CTX ctx;
+    uint32_t crc;
+} Hasher;
+
+void hasherAllocate(WrenVM* vm);
+void hasherNew(WrenVM* vm);
+void hasherUpdate(WrenVM* vm);
+void hasherUpdate2(WrenVM* vm);
+void hasherDigest(WrenVM* vm);
+void hasherReset(WrenVM* vm);
+
+typedef struct {
+    struct mz_stream_s* stream;
+    bool deflate;
+    bool finished;
+    uint8_t* output;
+    size_t outputStart;
+    size_t outputSize;
+    size_t outputCapacity;
+    uint64_t totalIn;
+    uint64_t totalOut;
+} ZStream;
+
+void zstreamAllocate(WrenVM* vm);
+void zstreamFinalize(void* data);
+void deflaterNew(WrenVM* vm);
+void deflaterNew2(WrenVM* vm);
+void deflaterFinish(WrenVM* vm);
+void inflaterNew(WrenVM* vm);
+void inflaterNew2(WrenVM* vm);
+void zstreamWrite(WrenVM* vm);
+void zstreamWrite2(WrenVM* vm);
+void zstreamRead(WrenVM* vm);
+void zstreamReadInto(WrenVM* vm);
+void zstreamGetPending(WrenVM* vm);
+void zstreamGetTotalIn(WrenVM* vm);
+void zstreamGetTotalOut(WrenVM* vm);
+void zstreamGetFinished(WrenVM* vm);
 
 void directoryExists(WrenVM* vm);
 void directoryList(WrenVM* vm);
+void directoryWalk(WrenVM* vm);
+void directoryWalk2(WrenVM* vm);
 
 void fileExists(WrenVM* vm);
 void fileSize(WrenVM* vm);
@@ -312,6 +459,7 @@ void fileWrite(WrenVM* vm);
 typedef struct {
     uint8_t* data;
     int size;
+    void* image; // Image whose pixels this views, NULL if the buffer owns its data
 } Buffer;
 
 void bufferAllocate(WrenVM* vm);
@@ -349,6 +497,52 @@ void bufferGetSize(WrenVM* vm);
 void bufferGetToString(WrenVM* vm);
 void bufferGetToList(WrenVM* vm);
 
+typedef struct {
+    FILE* file;
+    char* scratch;
+    size_t scratchSize;
+} FileHandle;
+
+void fileHandleAllocate(WrenVM* vm);
+void fileHandleFinalize(void* data);
+void fileHandleOpen(WrenVM* vm);
+void fileHandleRead(WrenVM* vm);
+void fileHandleReadInto(WrenVM* vm);
+void fileHandleReadLine(WrenVM* vm);
+void fileHandleWrite(WrenVM* vm);
+void fileHandleWrite2(WrenVM* vm);
+void fileHandleSeek(WrenVM* vm);
+void fileHandleSeek2(WrenVM* vm);
+void fileHandleFlush(WrenVM* vm);
+void fileHandleClose(WrenVM* vm);
+void fileHandleGetPosition(WrenVM* vm);
+void fileHandleGetSize(WrenVM* vm);
+void fileHandleGetEof(WrenVM* vm);
+void fileHandleGetIsOpen(WrenVM* vm);
+
+typedef struct FileJob FileJob;
+
+typedef struct {
+    PoolTask* task;
+    FileJob* job;
+} FileTask;
+
+void fileTaskAllocate(WrenVM* vm);
+void fileTaskFinalize(void* data);
+void fileTaskRead(WrenVM* vm);
+void fileTaskReadEmbedded(WrenVM* vm);
+void fileTaskWrite(WrenVM* vm);
+void fileTaskGetComplete(WrenVM* vm);
+void fileTaskGetResult(WrenVM* vm);
+void fileTaskGetError(WrenVM* vm);
+
+void hotWatch(WrenVM* vm);
+void hotGetState(WrenVM* vm);
+void hotSetState(WrenVM* vm);
+void hotPoll(WrenVM* vm);
+void hotGetScriptChanged(WrenVM* vm);
+void hotRestart(WrenVM* vm);
+
 typedef struct {
     naettReq* req;
     naettRes* res;
@@ -371,6 +565,8 @@ void hostAllocate(WrenVM* vm);
 void hostFinalize(void* data);
 void hostNew(WrenVM* vm);
 void hostNew2(WrenVM* vm);
+void hostLoopback(WrenVM* vm);
+void hostLoopback2(WrenVM* vm);
 void hostConnect(WrenVM* vm);
 void hostService(WrenVM* vm);
 void hostCheckEvents(WrenVM* vm);
@@ -384,6 +580,7 @@ void hostGetTotalReceived(WrenVM* vm);
 void hostGetServiceTime(WrenVM* vm);
 void hostGetPeerCount(WrenVM* vm);
 void hostGetAddress(WrenVM* vm);
+void hostDumpStats(WrenVM* vm);
 void hostSetChannelLimit(WrenVM* vm);
 
 void peerDisconnect(WrenVM* vm);
@@ -401,9 +598,20 @@ void peerGetState(WrenVM* vm);
 void peerGetRtt(WrenVM* vm);
 void peerGetLastRtt(WrenVM* vm);
 void peerGetTimeout(WrenVM* vm);
+void peerGetStats(WrenVM* vm);
 void peerGetToString(WrenVM* vm);
 void peerSetPingInterval(WrenVM* vm);
 void peerSetRtt(WrenVM* vm);
 void peerSetLastRtt(WrenVM* vm);
 
+void loopbackSetLatency(WrenVM* vm);
+void loopbackSetJitter(WrenVM* vm);
+void loopbackSetLoss(WrenVM* vm);
+void loopbackSetBandwidth(WrenVM* vm);
+void loopbackSetSeed(WrenVM* vm);
+void loopbackSetDeterministic(WrenVM* vm);
+void loopbackAdvance(WrenVM* vm);
+void loopbackGetTime(WrenVM* vm);
+void loopbackGetStats(WrenVM* vm);
+
 #endif
@@ -5,10 +5,13 @@ static const char* apiModuleSource =
 "//------------------------------\n"
 "\n"
 "class Audio {\n"
-"    foreign static init()        // Initialize audio device\n"
+"    foreign static init()            // Initialize audio device\n"
 "\n"
-"    foreign static volume        // Get master volume\n"
-"    foreign static volume=(v)    // Set master volume\n"
+"    foreign static volume            // Get master volume\n"
+"    foreign static volume=(v)        // Set master volume\n"
+"    foreign static maxVoices         // Get limit of voices playing at once across all sounds\n"
+"    foreign static maxVoices=(v)     // Set voice limit (default 64)\n"
+"    foreign static activeVoices      // Get number of voices playing\n"
 "}\n"
 "\n"
 "foreign class Sound {\n"
@@ -23,6 +26,19 @@ static const char* apiModuleSource =
 "    foreign volume=(v)             // Set sound volume (1.0 = max volume)\n"
 "    foreign pitch=(v)              // Set sound pitch (1.0 = normal)\n"
 "    foreign pan=(v)                // Set sound pan (0.5 = middle)\n"
+"\n"
+"    // Overlapping playback from a pool of voices sharing the sound data. When the pool or\n"
+"    // Audio.maxVoices is full the lowest priority, oldest voice is cut off; returns false\n"
+"    // if every candidate has a higher priority.\n"
+"    foreign playVoice(volume, pitch, pan)\n"
+"    foreign playVoice(volume, pitch, pan, priority)\n"
+"    foreign stopVoices()           // Stop all voices of this sound\n"
+"    foreign voices=(v)             // Set number of voices for this sound (default 8)\n"
+"    foreign bus=(v)                // Set mixer bus: \"music\", \"sfx\" or \"voice\" (default \"sfx\")\n"
+"\n"
+"    playVoice() {\n"
+"        return playVoice(1, 1, 0.5)\n"
+"    }\n"
 "}\n"
 "\n"
 "foreign class SoundAlias {\n"
@@ -37,6 +53,66 @@ static const char* apiModuleSource =
 "    foreign volume=(v)              // Set sound volume (1.0 = max volume)\n"
 "    foreign pitch=(v)               // Set sound pitch (1.0 = normal)\n"
 "    foreign pan=(v)                 // Set sound pan (0.5 = middle)\n"
+"    foreign bus=(v)                 // Set mixer bus (default is the bus of the sound)\n"
+"}\n"
+"\n"
+"// Music is decoded a little at a time as it plays instead of all at once like Sound, a\n"
+"// background thread keeps it fed so there is no need to update it every frame.\n"
+"foreign class Music {\n"
+"    foreign construct new(path)    // Load music stream from file (WAV, OGG, MP3, FLAC, QOA, XM, MOD)\n"
+"\n"
+"    foreign play()                 // Play music from the start\n"
+"    foreign stop()                 // Stop playing music\n"
+"    foreign pause()                // Pause music\n"
+"    foreign resume()               // Resume paused music\n"
+"    foreign seek(position)         // Seek to position in seconds\n"
+"\n"
+"    foreign playing                // Check if music is playing\n"
+"    foreign length                 // Get music length in seconds\n"
+"    foreign position               // Get current position in seconds\n"
+"    foreign looping                // Check if music loops\n"
+"    foreign looping=(v)            // Set if music loops (default true)\n"
+"    foreign volume=(v)             // Set music volume (1.0 = max volume)\n"
+"    foreign pitch=(v)              // Set music pitch (1.0 = normal)\n"
+"    foreign pan=(v)                // Set music pan (0.5 = middle)\n"
+"    foreign bus=(v)                // Set mixer bus: \"music\", \"sfx\" or \"voice\" (default \"music\")\n"
+"}\n"
+"\n"
+"// PCM written from Buffers is queued in a lock-free ring the audio thread plays from, so\n"
+"// writing never blocks. Sample size is 8 (unsigned), 16 (signed) or 32 (float), channels\n"
+"// are interleaved. Queue capacity defaults to a tenth of a second.\n"
+"foreign class AudioStream {\n"
+"    foreign construct new(sampleRate, sampleSize, channels)\n"
+"    foreign construct new(sampleRate, sampleSize, channels, frames)\n"
+"\n"
+"    foreign write(buffer)                 // Queue whole frames from buffer, returns frames queued (less when full)\n"
+"    foreign write(buffer, offset, size)   // Queue whole frames from part of buffer\n"
+"\n"
+"    foreign play()                        // Play stream\n"
+"    foreign stop()                        // Stop stream and drop queued frames\n"
+"    foreign pause()                       // Pause stream\n"
+"    foreign resume()                      // Resume paused stream\n"
+"\n"
+"    foreign playing                       // Check if stream is playing\n"
+"    foreign queued                        // Get frames waiting to be played\n"
+"    foreign space                         // Get frames that can be written without dropping\n"
+"    foreign latency                       // Get seconds of audio queued\n"
+"    foreign underruns                     // Get times the audio thread ran out of frames\n"
+"    foreign volume=(v)                    // Set stream volume (1.0 = max volume)\n"
+"    foreign pitch=(v)                     // Set stream pitch (1.0 = normal)\n"
+"    foreign pan=(v)                       // Set stream pan (0.5 = middle)\n"
+"    foreign bus=(v)                       // Set mixer bus (default \"sfx\")\n"
+"}\n"
+"\n"
+"// Buses and effects run natively on the audio thread. Every sound and music goes through\n"
+"// a bus; low-pass, reverb and compressor apply to the final mix.\n"
+"class Mixer {\n"
+"    foreign static gain(bus)                      // Get bus gain\n"
+"    foreign static setGain(bus, gain)             // Set bus gain (1.0 = unchanged)\n"
+"    foreign static duck(bus, by, amount)          // Lower bus by amount (0.0-1.0) while bus `by` plays, 0 turns it off\n"
+"    foreign static lowPass=(cutoff)               // Set low-pass cutoff in Hz (0 = off)\n"
+"    foreign static reverb(mix, roomSize, damping) // Set reverb, all 0.0-1.0 (mix 0 = off)\n"
+"    foreign static compressor(threshold, ratio)   // Set compressor, threshold in dB (ratio 1 = off)\n"
 "}\n"
 "\n"
 "//------------------------------\n"
@@ -50,7 +126,12 @@ static const char* apiModuleSource =
 "    foreign static endBlend()                                            // End blending mode (returns to \"alpha\")\n"
 "    foreign static beginScissor(x, y, width, height)                     // Begin scissor mode\n"
 "    foreign static endScissor()                                          // End scissor mode\n"
-"    foreign static screenshot(path)                                      // Save screenshot to file\n"
+"    foreign static screenshot(path)                                      // Save screenshot to file at the end of the frame, .png and .qoi are written in the background\n"
+"    foreign static startRecording(directory, type)                       // Save every frame to directory as 00000.png... type is \".png\" or the faster \".qoi\"\n"
+"    foreign static stopRecording()                                       // Stop saving frames\n"
+"    foreign static recording                                             // Get whether frames are being saved\n"
+"    foreign static recordedFrames                                        // Get number of frames saved since recording started\n"
+"    foreign static captureFailures                                       // Get number of screenshots and frames that failed to write\n"
 "    foreign static measure(text, size)                                   // Measure text width using default font\n"
 "    foreign static noise(x, y, frequency, depth)                         // Get perlin noise value\n"
 "\n"
@@ -90,10 +171,24 @@ static const char* apiModuleSource =
 "        polygonLines(x, y, sides, radius, r, 1, color)\n"
 "    }\n"
 "\n"
+"    static startRecording(directory) {\n"
+"        startRecording(directory, \".png\")\n"
+"    }\n"
+"\n"
 "    foreign static noiseSeed=(v)                                         // Set noise seed\n"
 "    foreign static lineSpacing=(v)                                       // Set vertical line spacing for text\n"
 "}\n"
 "\n"
+"// Whole noise grids in one call. Buffers receive width * height floats in [0, 1], row by row,\n"
+"// for the points (x + column, y + row). Large grids are generated on worker threads.\n"
+"class Noise {\n"
+"    foreign static fill(buffer, x, y, width, height, frequency, depth)                // Fill buffer with the same noise as Graphics.noise\n"
+"    foreign static fillSimplex(buffer, x, y, width, height, frequency, depth)         // Fill buffer with simplex noise\n"
+"    foreign static fillSimplex(buffer, x, y, z, width, height, frequency, depth)      // Fill buffer with a slice of 3D simplex noise\n"
+"    foreign static simplex(x, y)                                                      // Get simplex noise value in [-1, 1]\n"
+"    foreign static simplex(x, y, z)                                                   // Get 3D simplex noise value in [-1, 1]\n"
+"}\n"
+"\n"
 "class UI {\n"
 "    foreign static update()\n"
 "    foreign static draw()\n"
@@ -176,6 +271,7 @@ static const char* apiModuleSource =
 "    foreign construct fromGradientLinear(width, height, direction, startColor, endColor)    // New image from linear gradient, direction is in degrees\n"
 "    foreign construct fromGradientRadial(width, height, density, innerColor, outerColor)    // New image from radial gradient\n"
 "    foreign construct fromGradientSquare(width, height, density, innerColor, outerColor)    // New image from square gradient\n"
+"    foreign construct fromNoise(x, y, width, height, frequency, depth)                      // New grayscale image from Graphics.noise values\n"
 "\n"
 "    foreign export(path)                                                                    // Save image to file, return true on success\n"
 "    foreign exportToMemory(type)                                                            // Save image data to memory, type is: \".png\", \".bmp\", \".jpg\"\n"
@@ -184,17 +280,42 @@ static const char* apiModuleSource =
 "    foreign flipVertical()                                                                  // Flip image vertically\n"
 "    foreign flipHorizontal()                                                                // Flip image horizontally\n"
 "    foreign rotate(angle)                                                                   // Rotate image by angle in degrees\n"
+"    foreign convert(format)                                                                 // Convert pixels to a format named as returned by format\n"
+"    foreign mipmaps()                                                                       // Generate mipmaps down to 1x1, uploaded along with the image by Texture.new\n"
+"    foreign premultiplyAlpha()                                                              // Multiply color by alpha, converting to R8G8B8A8\n"
+"\n"
+"    // fillRect, blit, replaceColor and convolve work on 32-bit RGBA and convert the image first.\n"
+"    foreign pixels                                                                          // Get a buffer viewing the pixel data, emptied when the image is freed\n"
+"    foreign getPixel(x, y)                                                                  // Get pixel color\n"
+"    foreign setPixel(x, y, color)                                                           // Set pixel color\n"
+"    foreign fillRect(x, y, width, height, color)                                            // Fill rectangle with color\n"
+"    foreign blit(image, x, y)                                                               // Draw image over this one using its alpha\n"
+"    foreign blit(image, srcX, srcY, width, height, x, y)                                    // Draw part of image over this one using its alpha\n"
+"    foreign replaceColor(from, to)                                                          // Replace every pixel of one color, returns the count\n"
+"    foreign convolve(kernel)                                                                // Apply a square kernel given as a flat list (3x3, 5x5...)\n"
+"    blur() { convolve([1/16, 2/16, 1/16, 2/16, 4/16, 2/16, 1/16, 2/16, 1/16]) }             // Gaussian blur with a 3x3 kernel\n"
+"    sharpen() { convolve([0, -1, 0, -1, 5, -1, 0, -1, 0]) }                                 // Sharpen with a 3x3 kernel\n"
 "\n"
 "    foreign width                                                                           // Get image width\n"
 "    foreign height                                                                          // Get image height\n"
 "    foreign format                                                                          // Get image pixel format\n"
+"    foreign mipmapCount                                                                     // Get number of mipmap levels, 1 without mipmaps\n"
 "}\n"
 "\n"
 "foreign class Texture {\n"
 "    foreign construct new(pathOrImage)                                                        // Load texture from file (PNG, BMP, JPG) or image\n"
+"    foreign construct new(width, height)                                                      // New blank RGBA texture, for streaming into with update\n"
 "\n"
 "    foreign draw(x, y, r, sx, sy, ox, oy, color)                                              // Draw texture\n"
 "    foreign drawRec(srcX, srcY, srcWidth, srcHeight, dstX, dstY, r, sx, sy, ox, oy, color)    // Draw part of texture\n"
+"    foreign updateFromImage(image)                                                            // Upload image of the same size, converted if its format differs\n"
+"    foreign updateRect(x, y, width, height, buffer)                                           // Upload buffer pixels, in the texture format, to part of the texture\n"
+"\n"
+"    // Replace the pixels in place, without allocating a new texture.\n"
+"    update(imageOrBuffer) {\n"
+"        if (imageOrBuffer is Image) return updateFromImage(imageOrBuffer)\n"
+"        updateRect(0, 0, width, height, imageOrBuffer)\n"
+"    }\n"
 "\n"
 "    draw(x, y) {\n"
 "        draw(x, y, 0, 1, 1, 0, 0, Color.white)\n"
@@ -275,6 +396,25 @@ static const char* apiModuleSource =
 "    foreign set(name, value)                // Set uniform value\n"
 "}\n"
 "\n"
+"// Chains shader passes over the scene. Render targets are pooled, reused every frame and remade\n"
+"// when the window is resized. Each pass reads the previous result, pass a scale of 0.5 for half\n"
+"// resolution passes such as blur. A scene uniform name binds the untouched scene to that sampler,\n"
+"// for passes that combine it with the result, like bloom.\n"
+"foreign class PostFX {\n"
+"    foreign construct new()                // New post-processing chain sized to the window\n"
+"\n"
+"    foreign begin()                        // Begin rendering the scene into the chain\n"
+"    foreign end()                          // End rendering the scene\n"
+"    foreign apply(shader, scale, scene)    // Run a pass at scale into the next target\n"
+"    foreign draw(shader, scene)            // Run a last pass onto the screen\n"
+"    foreign targets                        // Get number of pooled render targets\n"
+"\n"
+"    apply(shader) { apply(shader, 1, null) }\n"
+"    apply(shader, scale) { apply(shader, scale, null) }\n"
+"    draw() { draw(null, null) }\n"
+"    draw(shader) { draw(shader, null) }\n"
+"}\n"
+"\n"
 "//------------------------------\n"
 "// Input\n"
 "//------------------------------\n"
@@ -389,16 +529,75 @@ static const char* apiModuleSource =
 "class Data {\n"
 "    foreign static compress(data)        // Compress data using deflate algorithm\n"
 "    foreign static decompress(data)      // Decompress data using deflate algorithm\n"
-"    foreign static encodeBase64(data)    // Encode data using base64\n"
-"    foreign static decodeBase64(data)    // Decode data using base64\n"
-"    foreign static encodeHex(data)       // Encode data using hex\n"
-"    foreign static decodeHex(data)       // Decode data using hex\n"
-"    foreign static hash(data)            // Hash data using SHA256\n"
+"    foreign static encodeBase64(data)    // Encode string or buffer using base64\n"
+"    foreign static decodeBase64(data)    // Decode string or buffer using base64, padding optional\n"
+"    foreign static encodeHex(data)       // Encode string or buffer using hex\n"
+"    foreign static decodeHex(data)       // Decode string or buffer using hex\n"
+"\n"
+"    // Same as above but written into buffer at offset, returning the number of bytes written.\n"
+"    foreign static encodeBase64(data, buffer, offset)\n"
+"    foreign static decodeBase64(data, buffer, offset)\n"
+"    foreign static encodeHex(data, buffer, offset)\n"
+"    foreign static decodeHex(data, buffer, offset)\n"
+"\n"
+"    foreign static hash(data)            // Hash string or buffer using SHA256\n"
+"    foreign static hash64(data)          // Hash string or buffer using a fast non-cryptographic hash, returns 16 hex digits\n"
+"    foreign static crc32(data)           // Get CRC32 checksum of string or buffer\n"
+"}\n"
+"\n"
+"// Incremental hashing, for data that arrives in pieces.\n"
+"foreign class Hasher {\n"
+"    foreign construct new(algorithm)          // Create hasher, algorithm is \"sha256\" or \"crc32\"\n"
+"\n"
+"    foreign update(data)                      // Add string or buffer\n"
+"    foreign update(buffer, offset, size)      // Add part of buffer\n"
+"    foreign digest()                          // Get hash so far, same as Data.hash or Data.crc32 would return\n"
+"    foreign reset()                           // Start over\n"
+"}\n"
+"\n"
+"// Streaming deflate compression, for data too large to compress in one go. Output is\n"
+"// kept until read, by default it is raw deflate like Data.compress.\n"
+"foreign class Deflater {\n"
+"    foreign construct new(level)              // Create compressor, level is 0 (store) to 9 (smallest)\n"
+"    foreign construct new(level, format)      // Create compressor, format is \"deflate\" or \"zlib\"\n"
+"\n"
+"    foreign write(data)                       // Compress string or buffer\n"
+"    foreign write(buffer, offset, size)       // Compress part of buffer\n"
+"    foreign finish()                          // Flush remaining output, no writes allowed after this\n"
+"    foreign read()                            // Take pending output as string\n"
+"    foreign read(buffer, offset)              // Move pending output into buffer, returns bytes moved\n"
+"\n"
+"    foreign pending                           // Get size of output waiting to be read\n"
+"    foreign totalIn                           // Get total bytes written\n"
+"    foreign totalOut                          // Get total bytes produced\n"
+"    foreign finished                          // Check if finish() was called\n"
+"}\n"
+"\n"
+"// Streaming deflate decompression, the counterpart of Deflater.\n"
+"foreign class Inflater {\n"
+"    foreign construct new()                   // Create decompressor for raw deflate\n"
+"    foreign construct new(format)             // Create decompressor, format is \"deflate\" or \"zlib\"\n"
+"\n"
+"    foreign write(data)                       // Decompress string or buffer\n"
+"    foreign write(buffer, offset, size)       // Decompress part of buffer\n"
+"    foreign read()                            // Take pending output as string\n"
+"    foreign read(buffer, offset)              // Move pending output into buffer, returns bytes moved\n"
+"\n"
+"    foreign pending                           // Get size of output waiting to be read\n"
+"    foreign totalIn                           // Get total bytes written\n"
+"    foreign totalOut                          // Get total bytes produced\n"
+"    foreign finished                          // Check if the end of the compressed stream was reached\n"
 "}\n"
 "\n"
 "class Directory {\n"
 "    foreign static exists(path)    // Check if directory exists\n"
 "    foreign static list(path)      // Get list of directory items\n"
+"\n"
+"    // Walk a directory, returning a list of maps with path, type (\"file\" or \"directory\"), size and mtime.\n"
+"    // Options: recursive (true), directories (false), pattern (glob, \"**\" crosses directories) and\n"
+"    // extensions (e.g. \".png;.jpg\").\n"
+"    foreign static walk(path)\n"
+"    foreign static walk(path, options)\n"
 "}\n"
 "\n"
 "class File {\n"
@@ -407,6 +606,91 @@ static const char* apiModuleSource =
 "    foreign static read(path)            // Read data from file\n"
 "    foreign static readEmbedded(path)    // Read data from egg file\n"
 "    foreign static write(path, data)     // Write data to file\n"
+"\n"
+"    // The async variants run on a worker thread. Call them from a fiber: it is suspended\n"
+"    // until File.update() sees the operation finish and resumes it with the result.\n"
+"    static readAsync(path) { await_(FileTask.read(path)) }\n"
+"    static readEmbeddedAsync(path) { await_(FileTask.readEmbedded(path)) }\n"
+"    static writeAsync(path, data) { await_(FileTask.write(path, data)) }\n"
+"\n"
+"    // Resume fibers whose file operations finished, call once per frame.\n"
+"    static update() {\n"
+"        if (__pending == null || __pending.isEmpty) return\n"
+"\n"
+"        // Each entry leaves __pending only right before its fiber resumes, so if that fiber\n"
+"        // aborts the others are still waiting for the next update.\n"
+"        for (entry in __pending.toList) {\n"
+"            if (entry[0].complete) {\n"
+"                __pending.remove(entry)\n"
+"                entry[1].call()\n"
+"            }\n"
+"        }\n"
+"    }\n"
+"\n"
+"    static await_(task) {\n"
+"        if (__pending == null) __pending = []\n"
+"        __pending.add([task, Fiber.current])\n"
+"        Fiber.yield()\n"
+"        return task.result\n"
+"    }\n"
+"}\n"
+"\n"
+"// Live reload while developing. After Hot.watch, textures, sounds, fonts and shaders loaded from files\n"
+"// are reloaded in place when their file changes, and saving a .wren file restarts the script in a fresh VM.\n"
+"class Hot {\n"
+"    foreign static watch(path)       // Start watching directory for changes, returns false when running from an egg\n"
+"    foreign static state             // Get state string kept from before the last restart, null on first run\n"
+"    foreign static state=(value)     // Set state string to keep across restarts\n"
+"\n"
+"    static onReload(fn) { __onReload = fn }    // Set function called before a restart, its result becomes the state\n"
+"\n"
+"    // Check for changes, call once per frame. Returns list of changed paths.\n"
+"    static update() {\n"
+"        var changed = poll_()\n"
+"\n"
+"        if (scriptChanged_) {\n"
+"            if (__onReload != null) Hot.state = __onReload.call()\n"
+"            restart_()\n"
+"            Fiber.suspend()\n"
+"        }\n"
+"\n"
+"        return changed\n"
+"    }\n"
+"\n"
+"    foreign static poll_()\n"
+"    foreign static scriptChanged_\n"
+"    foreign static restart_()\n"
+"}\n"
+"\n"
+"// A file operation running on a worker thread, for polling instead of waiting in a fiber.\n"
+"foreign class FileTask {\n"
+"    foreign construct read(path)              // Start reading file\n"
+"    foreign construct readEmbedded(path)      // Start reading file from egg\n"
+"    foreign construct write(path, data)       // Start writing string or buffer to file\n"
+"\n"
+"    foreign complete                          // Check if operation is complete\n"
+"    foreign result                            // Get data read, aborts if the operation failed\n"
+"    foreign error                             // Get error message, null if none\n"
+"}\n"
+"\n"
+"// Streaming access to a file, for files too large to read at once.\n"
+"foreign class FileHandle {\n"
+"    foreign construct open(path, mode)     // Open file, mode is \"r\", \"w\", \"a\", \"r+\", \"w+\" or \"a+\"\n"
+"\n"
+"    foreign read(size)                     // Read up to size bytes as a string, null at end of file\n"
+"    foreign read(buffer, offset, size)     // Read up to size bytes into buffer at offset, returns bytes read\n"
+"    foreign readLine()                     // Read next line without the line ending, null at end of file\n"
+"    foreign write(data)                    // Write string or buffer\n"
+"    foreign write(buffer, offset, size)    // Write size bytes of buffer starting at offset\n"
+"    foreign seek(offset)                   // Seek to offset from the start, returns new position\n"
+"    foreign seek(offset, whence)           // Seek to offset from \"set\", \"cur\" or \"end\", returns new position\n"
+"    foreign flush()                        // Flush buffered writes to disk\n"
+"    foreign close()                        // Close file, also done when the handle is collected\n"
+"\n"
+"    foreign position                       // Get current position\n"
+"    foreign size                           // Get file size\n"
+"    foreign eof                            // Check if a read hit the end of file\n"
+"    foreign isOpen                         // Check if file is still open\n"
 "}\n"
 "\n"
 "foreign class Buffer {\n"
@@ -476,6 +760,10 @@ static const char* apiModuleSource =
 "    foreign construct new(address, peerCount, channelCount, inBandwidth, outBandwidth)\n"
 "    foreign construct new(address)\n"
 "\n"
+"    // Same as new, but the host talks over the in-process loopback transport configured by Loopback.\n"
+"    foreign construct loopback(address, peerCount, channelCount, inBandwidth, outBandwidth)\n"
+"    foreign construct loopback(address)\n"
+"\n"
 "    foreign connect(address, channelCount, data)\n"
 "    foreign service(timeout)\n"
 "    foreign checkEvents()\n"
@@ -485,6 +773,9 @@ static const char* apiModuleSource =
 "    foreign setBandwidthLimit(incoming, outgoing)\n"
 "    foreign getPeer(index)\n"
 "\n"
+"    // Write a CSV line of stats for every connected peer each interval milliseconds. Pass null to stop.\n"
+"    foreign dumpStats(path, interval)\n"
+"\n"
 "    connect(address) { connect(address, 1, 0) }\n"
 "\n"
 "    service() { service(0) }\n"
@@ -534,8 +825,30 @@ static const char* apiModuleSource =
 "    foreign rtt\n"
 "    foreign lastRtt\n"
 "    foreign timeout\n"
+"\n"
+"    // Map of packetLoss, packetThrottle, queueDepth, maxQueueDepth, inTransit,\n"
+"    // bytesIn and bytesOut (lists, one entry per channel), rttMin, rttMax, rttP50, rttP90, rttP99 and rttSamples.\n"
+"    // RTT is sampled once per host service tick and reset when the peer connects.\n"
+"    foreign stats\n"
+"\n"
 "    foreign toString\n"
 "    foreign pingInterval=(v)\n"
 "    foreign rtt=(v)\n"
 "    foreign lastRtt=(v)\n"
+"}\n"
+"\n"
+"// Simulated network used by hosts created with Host.loopback.\n"
+"// Loopback hosts only see each other and are addressed by port, e.g. \"127.0.0.1:6789\".\n"
+"\n"
+"class Loopback {\n"
+"    foreign static advance(ms)          // Advance the virtual clock by given milliseconds\n"
+"\n"
+"    foreign static time                 // Get current transport time in milliseconds\n"
+"    foreign static stats                // Get map of sent, delivered, dropped, bytes and queued datagrams\n"
+"    foreign static latency=(v)          // Set one-way latency in milliseconds\n"
+"    foreign static jitter=(v)           // Set maximum random extra latency in milliseconds\n"
+"    foreign static loss=(v)             // Set packet loss probability (0 to 1)\n"
+"    foreign static bandwidth=(v)        // Set bytes per second each host can send (0 is unlimited)\n"
+"    foreign static seed=(v)             // Set seed used for jitter and loss\n"
+"    foreign static deterministic=(v)    // Use a virtual clock that only moves with advance and service timeouts\n"
 "}\n";
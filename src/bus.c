@@ -0,0 +1,444 @@
+#include "bus.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "thread.h"
+
+// raylib hands processors interleaved float frames in the device format. It doesn't expose
+// the device rate, so time constants assume the usual 48kHz.
+#define MIXER_CHANNELS 2
+#define MIXER_SAMPLE_RATE 48000.0f
+
+#define MIXER_SMOOTHING 0.002f    // Per frame gain glide, about 10ms
+#define MIXER_DUCK_THRESHOLD 0.01f // About -40dB
+#define MIXER_DUCK_HOLD 12000     // Frames a bus counts as audible after its last loud sample
+
+#define COMB_COUNT 4
+#define ALLPASS_COUNT 2
+#define COMB_MAX 1400
+#define ALLPASS_MAX 600
+#define STEREO_SPREAD 23
+
+typedef struct {
+    void* buffer; // The stream's rAudioBuffer, unique while it is loaded
+    int bus;
+} Route;
+
+// Written by the main thread under the lock, copied by the audio thread.
+typedef struct {
+    float gain;
+    int duckBy;
+    float duckAmount;
+} BusSettings;
+
+typedef struct {
+    float lowPass;
+    float reverbMix, roomSize, damping;
+    float threshold, ratio; // Threshold as linear amplitude
+} MasterSettings;
+
+// Only touched by the audio thread, like the effect state below. raylib runs a bus processor
+// once for every stream on the bus, so the glide advances once per period in processMaster
+// and every stream in a period gets the same ramp.
+typedef struct {
+    float from, to; // Gain ramp for the current period, gliding towards the target
+    unsigned long long heard; // Frames mixed when the bus was last audible
+} BusState;
+
+typedef struct {
+    float buffer[COMB_MAX];
+    int length, index;
+    float store;
+} Comb;
+
+typedef struct {
+    float buffer[ALLPASS_MAX];
+    int length, index;
+} Allpass;
+
+static Mutex* lock = NULL;
+static bool started = false;
+
+static Route* routes = NULL;
+static int routeCount = 0;
+static int routeCapacity = 0;
+
+static BusSettings settings[BUS_COUNT] = {
+    { 1.0f, -1, 0.0f },
+    { 1.0f, -1, 0.0f },
+    { 1.0f, -1, 0.0f },
+};
+
+static MasterSettings master = { 0.0f, 0.0f, 0.5f, 0.5f, 1.0f, 1.0f };
+
+static BusState states[BUS_COUNT] = {
+    { 1.0f, 1.0f, 0 },
+    { 1.0f, 1.0f, 0 },
+    { 1.0f, 1.0f, 0 },
+};
+
+static unsigned long long mixed = MIXER_DUCK_HOLD; // Frames mixed, starts past the hold so nothing ducks at first
+static float lowPassState[MIXER_CHANNELS];
+static Comb combs[MIXER_CHANNELS][COMB_COUNT];
+static Allpass allpasses[MIXER_CHANNELS][ALLPASS_COUNT];
+static bool reverbActive = false;
+static float envelope = 0.0f;
+
+// Freeverb's tunings, in frames at 44.1kHz.
+static const int combLengths[COMB_COUNT] = { 1116, 1188, 1277, 1356 };
+static const int allpassLengths[ALLPASS_COUNT] = { 556, 441 };
+
+static const char* busNames[BUS_COUNT] = { "music", "sfx", "voice" };
+
+static void processBus(int bus, float* samples, unsigned int frames)
+{
+    BusState* state = &states[bus];
+    unsigned int count = frames * MIXER_CHANNELS;
+
+    for (unsigned int i = 0; i < count; i++) {
+        if (fabsf(samples[i]) > MIXER_DUCK_THRESHOLD) {
+            state->heard = mixed;
+            break;
+        }
+    }
+
+    float from = state->from;
+    float to = state->to;
+    if (from == 1.0f && to == 1.0f)
+        return;
+
+    // A stream read in several chunks repeats the ramp for each, which only spans one period's glide.
+    float step = (to - from) / frames;
+
+    for (unsigned int i = 0; i < frames; i++) {
+        float gain = from + step * (i + 1);
+        samples[i * MIXER_CHANNELS] *= gain;
+        samples[i * MIXER_CHANNELS + 1] *= gain;
+    }
+}
+
+// Moves every bus's ramp on by one period, assuming the next one is as long as this one.
+static void advanceGains(const BusSettings* current, unsigned int frames)
+{
+    float decay = powf(1.0f - MIXER_SMOOTHING, (float)frames);
+
+    for (int bus = 0; bus < BUS_COUNT; bus++) {
+        BusState* state = &states[bus];
+
+        float target = current[bus].gain;
+        if (current[bus].duckBy >= 0 && mixed - states[current[bus].duckBy].heard < MIXER_DUCK_HOLD)
+            target *= 1.0f - current[bus].duckAmount;
+
+        float gain = target + (state->to - target) * decay;
+
+        // Snap once close enough, so a bus back at unity stops costing anything.
+        state->from = state->to;
+        state->to = fabsf(target - gain) < 0.0001f ? target : gain;
+    }
+}
+
+// raylib processors get no user data, so each bus needs its own callback.
+static void processMusic(void* buffer, unsigned int frames)
+{
+    processBus(BUS_MUSIC, (float*)buffer, frames);
+}
+
+static void processSfx(void* buffer, unsigned int frames)
+{
+    processBus(BUS_SFX, (float*)buffer, frames);
+}
+
+static void processVoice(void* buffer, unsigned int frames)
+{
+    processBus(BUS_VOICE, (float*)buffer, frames);
+}
+
+static const AudioCallback busProcessors[BUS_COUNT] = { processMusic, processSfx, processVoice };
+
+static void applyLowPass(float* samples, unsigned int frames, float cutoff)
+{
+    if (cutoff > MIXER_SAMPLE_RATE * 0.45f)
+        cutoff = MIXER_SAMPLE_RATE * 0.45f;
+
+    float a = 1.0f - expf(-2.0f * PI * cutoff / MIXER_SAMPLE_RATE);
+
+    for (unsigned int i = 0; i < frames; i++) {
+        for (int c = 0; c < MIXER_CHANNELS; c++) {
+            float* y = &lowPassState[c];
+            *y += a * (samples[i * MIXER_CHANNELS + c] - *y);
+            samples[i * MIXER_CHANNELS + c] = *y;
+        }
+    }
+}
+
+static float processComb(Comb* comb, float input, float feedback, float damping)
+{
+    float output = comb->buffer[comb->index];
+
+    comb->store = output * (1.0f - damping) + comb->store * damping;
+    if (fabsf(comb->store) < 1e-15f)
+        comb->store = 0.0f; // Denormals in a decaying tail are very slow on x86
+
+    comb->buffer[comb->index] = input + comb->store * feedback;
+    if (++comb->index >= comb->length)
+        comb->index = 0;
+
+    return output;
+}
+
+static float processAllpass(Allpass* allpass, float input)
+{
+    float delayed = allpass->buffer[allpass->index];
+
+    allpass->buffer[allpass->index] = input + delayed * 0.5f;
+    if (++allpass->index >= allpass->length)
+        allpass->index = 0;
+
+    return delayed - input;
+}
+
+static void clearReverb()
+{
+    for (int c = 0; c < MIXER_CHANNELS; c++) {
+        for (int i = 0; i < COMB_COUNT; i++) {
+            Comb* comb = &combs[c][i];
+            for (int j = 0; j < COMB_MAX; j++)
+                comb->buffer[j] = 0.0f;
+            comb->length = combLengths[i] + c * STEREO_SPREAD;
+            comb->index = 0;
+            comb->store = 0.0f;
+        }
+
+        for (int i = 0; i < ALLPASS_COUNT; i++) {
+            Allpass* allpass = &allpasses[c][i];
+            for (int j = 0; j < ALLPASS_MAX; j++)
+                allpass->buffer[j] = 0.0f;
+            allpass->length = allpassLengths[i] + c * STEREO_SPREAD;
+            allpass->index = 0;
+        }
+    }
+}
+
+// A small Freeverb: parallel damped combs into serial allpasses, per channel.
+static void applyReverb(float* samples, unsigned int frames, float mix, float roomSize, float damping)
+{
+    // Start from silence rather than the tail left over from the last time it was on.
+    if (!reverbActive) {
+        clearReverb();
+        reverbActive = true;
+    }
+
+    float feedback = 0.7f + roomSize * 0.28f;
+    damping *= 0.4f;
+
+    for (unsigned int i = 0; i < frames; i++) {
+        float* frame = &samples[i * MIXER_CHANNELS];
+        float input = (frame[0] + frame[1]) * 0.015f;
+
+        for (int c = 0; c < MIXER_CHANNELS; c++) {
+            float wet = 0.0f;
+            for (int j = 0; j < COMB_COUNT; j++)
+                wet += processComb(&combs[c][j], input, feedback, damping);
+            for (int j = 0; j < ALLPASS_COUNT; j++)
+                wet = processAllpass(&allpasses[c][j], wet);
+
+            frame[c] = frame[c] * (1.0f - mix) + wet * 3.0f * mix;
+        }
+    }
+}
+
+// Peak compressor linked across channels, 5ms attack and 100ms release.
+static void applyCompressor(float* samples, unsigned int frames, float threshold, float ratio)
+{
+    float attack = expf(-1.0f / (0.005f * MIXER_SAMPLE_RATE));
+    float release = expf(-1.0f / (0.1f * MIXER_SAMPLE_RATE));
+    float exponent = 1.0f / ratio - 1.0f;
+
+    for (unsigned int i = 0; i < frames; i++) {
+        float* frame = &samples[i * MIXER_CHANNELS];
+        float peak = fmaxf(fabsf(frame[0]), fabsf(frame[1]));
+
+        float coefficient = peak > envelope ? attack : release;
+        envelope = peak + coefficient * (envelope - peak);
+
+        if (envelope > threshold) {
+            float gain = powf(envelope / threshold, exponent);
+            frame[0] *= gain;
+            frame[1] *= gain;
+        }
+    }
+}
+
+// Runs once per period on the final mix, after every stream's bus processor.
+static void processMaster(void* buffer, unsigned int frames)
+{
+    mutexLock(lock);
+    MasterSettings current = master;
+    BusSettings buses[BUS_COUNT];
+    for (int i = 0; i < BUS_COUNT; i++)
+        buses[i] = settings[i];
+    mutexUnlock(lock);
+
+    float* samples = (float*)buffer;
+    mixed += frames;
+
+    advanceGains(buses, frames);
+
+    if (current.lowPass > 0.0f)
+        applyLowPass(samples, frames, current.lowPass);
+
+    if (current.reverbMix > 0.0f)
+        applyReverb(samples, frames, current.reverbMix, current.roomSize, current.damping);
+    else
+        reverbActive = false;
+
+    if (current.ratio > 1.0f)
+        applyCompressor(samples, frames, current.threshold, current.ratio);
+}
+
+static void ensureLock()
+{
+    if (lock == NULL)
+        lock = mutexCreate();
+}
+
+static Route* findRoute(AudioStream stream)
+{
+    for (int i = 0; i < routeCount; i++)
+        if (routes[i].buffer == stream.buffer)
+            return &routes[i];
+
+    return NULL;
+}
+
+int busFind(const char* name)
+{
+    for (int i = 0; i < BUS_COUNT; i++)
+        if (TextIsEqual(name, busNames[i]))
+            return i;
+
+    return -1;
+}
+
+void busAttach(AudioStream stream, int bus)
+{
+    ensureLock();
+
+    // Streams only exist once the device is up, so this is the first safe point to hook the mix.
+    if (!started) {
+        AttachAudioMixedProcessor(processMaster);
+        started = true;
+    }
+
+    Route* route = findRoute(stream);
+
+    if (route == NULL) {
+        if (routeCount == routeCapacity) {
+            int capacity = routeCapacity > 0 ? routeCapacity * 2 : 32;
+            Route* grown = (Route*)realloc(routes, capacity * sizeof(Route));
+            if (grown == NULL)
+                return;
+
+            routes = grown;
+            routeCapacity = capacity;
+        }
+
+        route = &routes[routeCount++];
+        route->buffer = stream.buffer;
+    } else {
+        DetachAudioStreamProcessor(stream, busProcessors[route->bus]);
+    }
+
+    route->bus = bus;
+    AttachAudioStreamProcessor(stream, busProcessors[bus]);
+}
+
+void busDetach(AudioStream stream)
+{
+    Route* route = findRoute(stream);
+    if (route == NULL)
+        return;
+
+    DetachAudioStreamProcessor(stream, busProcessors[route->bus]);
+    *route = routes[--routeCount];
+
+    if (routeCount == 0) {
+        free(routes);
+        routes = NULL;
+        routeCapacity = 0;
+    }
+}
+
+int busOf(AudioStream stream, int fallback)
+{
+    Route* route = findRoute(stream);
+    return route ? route->bus : fallback;
+}
+
+float busGetGain(int bus)
+{
+    return settings[bus].gain;
+}
+
+void busSetGain(int bus, float gain)
+{
+    ensureLock();
+    mutexLock(lock);
+    settings[bus].gain = gain;
+    mutexUnlock(lock);
+}
+
+void busSetDuck(int bus, int by, float amount)
+{
+    ensureLock();
+    mutexLock(lock);
+    settings[bus].duckBy = amount > 0.0f ? by : -1;
+    settings[bus].duckAmount = amount;
+    mutexUnlock(lock);
+}
+
+void busSetLowPass(float cutoff)
+{
+    ensureLock();
+    mutexLock(lock);
+    master.lowPass = cutoff;
+    mutexUnlock(lock);
+}
+
+void busSetReverb(float mix, float roomSize, float damping)
+{
+    ensureLock();
+    mutexLock(lock);
+    master.reverbMix = mix;
+    master.roomSize = roomSize;
+    master.damping = damping;
+    mutexUnlock(lock);
+}
+
+void busSetCompressor(float threshold, float ratio)
+{
+    ensureLock();
+    mutexLock(lock);
+    master.threshold = powf(10.0f, threshold / 20.0f);
+    master.ratio = ratio;
+    mutexUnlock(lock);
+}
+
+void busShutdown()
+{
+    // Detaching waits for a mix in progress, after that nothing reads the lock.
+    if (started) {
+        DetachAudioMixedProcessor(processMaster);
+        started = false;
+    }
+
+    if (lock) {
+        mutexDestroy(lock);
+        lock = NULL;
+    }
+
+    free(routes);
+    routes = NULL;
+    routeCount = routeCapacity = 0;
+}
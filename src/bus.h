@@ -0,0 +1,47 @@
+#ifndef BUS_H
+#define BUS_H
+
+#include <stdbool.h>
+
+#include <raylib.h>
+
+// Audio buses and effects, all processed on the audio thread. Every sound and
+// music stream is routed through one bus, which applies its gain and ducking
+// to the stream before raylib mixes it. The stateful effects (low-pass,
+// reverb, compressor) run once on the final mix.
+
+typedef enum {
+    BUS_MUSIC,
+    BUS_SFX,
+    BUS_VOICE,
+    BUS_COUNT
+} BusId;
+
+// Returns -1 for an unknown name.
+int busFind(const char* name);
+
+// Moves the stream to the bus, detaching it from any bus it was on.
+void busAttach(AudioStream stream, int bus);
+void busDetach(AudioStream stream);
+
+// Bus of an attached stream, or fallback if it isn't on one.
+int busOf(AudioStream stream, int fallback);
+
+float busGetGain(int bus);
+void busSetGain(int bus, float gain);
+
+// Lowers the bus by amount (0-1) while the other bus is audible, amount 0 turns it off.
+void busSetDuck(int bus, int by, float amount);
+
+// Effects on the final mix. Cutoff in Hz, 0 turns it off.
+void busSetLowPass(float cutoff);
+
+// Mix 0 turns it off. Room size and damping are 0-1.
+void busSetReverb(float mix, float roomSize, float damping);
+
+// Threshold in dB, ratio 1 turns it off.
+void busSetCompressor(float threshold, float ratio);
+
+void busShutdown();
+
+#endif
@@ -0,0 +1,323 @@
+#include "capture.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <raylib.h>
+#include <rlgl.h>
+
+#include "headless.h"
+#include "pool.h"
+
+#define CAPTURE_MAX_PENDING 8 // Frames encoding at once before recording waits for the oldest
+#define CAPTURE_PATH_SIZE 512
+
+typedef enum {
+    CAPTURE_PNG,
+    CAPTURE_QOI,
+    CAPTURE_OTHER // Anything else raylib can export, written on the main thread
+} CaptureFormat;
+
+typedef struct {
+    Image image;
+    CaptureFormat format;
+    char path[CAPTURE_PATH_SIZE];
+    bool written; // Set by the worker, read once the task is freed
+} CaptureJob;
+
+typedef struct {
+    CaptureJob* job;
+    PoolTask* task;
+} Pending;
+
+static Pending pending[CAPTURE_MAX_PENDING];
+static int pendingCount = 0;
+
+static char screenshotPath[CAPTURE_PATH_SIZE];
+static bool screenshotRequested = false;
+
+static char recordDirectory[CAPTURE_PATH_SIZE];
+static char recordType[16];
+static bool recording = false;
+static int recordFrame = 0;
+static int failures = 0;
+
+static CaptureFormat formatOf(const char* path)
+{
+    const char* dot = strrchr(path, '.');
+    if (dot == NULL || strlen(dot) != 4)
+        return CAPTURE_OTHER;
+
+    char extension[5];
+    for (int i = 0; i < 5; i++)
+        extension[i] = (char)tolower((unsigned char)dot[i]);
+
+    if (strcmp(extension, ".png") == 0)
+        return CAPTURE_PNG;
+    if (strcmp(extension, ".qoi") == 0)
+        return CAPTURE_QOI;
+    return CAPTURE_OTHER;
+}
+
+static void put32(unsigned char* out, unsigned int value)
+{
+    out[0] = (unsigned char)(value >> 24);
+    out[1] = (unsigned char)(value >> 16);
+    out[2] = (unsigned char)(value >> 8);
+    out[3] = (unsigned char)value;
+}
+
+// QOI encoder for RGBA8 pixels, following the reference encoder.
+static unsigned char* encodeQoi(const unsigned char* pixels, int width, int height, int* size)
+{
+    size_t count = (size_t)width * height;
+    unsigned char* out = (unsigned char*)malloc(14 + count * 5 + 8);
+    if (out == NULL)
+        return NULL;
+
+    memcpy(out, "qoif", 4);
+    put32(&out[4], (unsigned int)width);
+    put32(&out[8], (unsigned int)height);
+    out[12] = 4;
+    out[13] = 0;
+
+    unsigned char index[64][4] = { { 0 } };
+    unsigned char prev[4] = { 0, 0, 0, 255 };
+    size_t at = 14;
+    int run = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const unsigned char* px = &pixels[i * 4];
+
+        if (memcmp(px, prev, 4) == 0) {
+            if (++run == 62 || i == count - 1) {
+                out[at++] = (unsigned char)(0xC0 | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+
+        if (run > 0) {
+            out[at++] = (unsigned char)(0xC0 | (run - 1));
+            run = 0;
+        }
+
+        int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+
+        if (memcmp(index[hash], px, 4) == 0) {
+            out[at++] = (unsigned char)hash;
+        } else {
+            memcpy(index[hash], px, 4);
+
+            if (px[3] == prev[3]) {
+                int vr = (signed char)(px[0] - prev[0]);
+                int vg = (signed char)(px[1] - prev[1]);
+                int vb = (signed char)(px[2] - prev[2]);
+                int vgr = vr - vg;
+                int vgb = vb - vg;
+
+                if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                    out[at++] = (unsigned char)(0x40 | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+                } else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+                    out[at++] = (unsigned char)(0x80 | (vg + 32));
+                    out[at++] = (unsigned char)((vgr + 8) << 4 | (vgb + 8));
+                } else {
+                    out[at++] = 0xFE;
+                    memcpy(&out[at], px, 3);
+                    at += 3;
+                }
+            } else {
+                out[at++] = 0xFF;
+                memcpy(&out[at], px, 4);
+                at += 4;
+            }
+        }
+
+        memcpy(prev, px, 4);
+    }
+
+    static const unsigned char end[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    memcpy(&out[at], end, 8);
+    *size = (int)(at + 8);
+    return out;
+}
+
+// Runs on a pool worker, so it sticks to the encoders and stdio. raylib's file
+// and text helpers share static buffers with the main thread.
+static void runCaptureJob(void* arg)
+{
+    CaptureJob* job = (CaptureJob*)arg;
+
+    int size = 0;
+    unsigned char* data = NULL;
+
+    if (job->format == CAPTURE_QOI)
+        data = encodeQoi((const unsigned char*)job->image.data, job->image.width, job->image.height, &size);
+    else
+        data = ExportImageToMemory(job->image, ".png", &size);
+
+    if (data != NULL) {
+        FILE* file = fopen(job->path, "wb");
+        if (file) {
+            job->written = fwrite(data, 1, size, file) == (size_t)size;
+            job->written = fclose(file) == 0 && job->written;
+        }
+    }
+
+    if (job->format == CAPTURE_QOI)
+        free(data);
+    else
+        MemFree(data);
+
+    UnloadImage(job->image);
+    job->image.data = NULL;
+}
+
+static void finishPending(int index)
+{
+    poolTaskFree(pending[index].task);
+
+    if (!pending[index].job->written)
+        failures++;
+
+    free(pending[index].job);
+
+    // Kept in submission order so the oldest is always first.
+    memmove(&pending[index], &pending[index + 1], (--pendingCount - index) * sizeof(Pending));
+}
+
+static void submit(Image image, const char* path)
+{
+    CaptureFormat format = formatOf(path);
+
+    if (format == CAPTURE_OTHER) {
+        if (!ExportImage(image, path))
+            failures++;
+
+        UnloadImage(image);
+        return;
+    }
+
+    CaptureJob* job = (CaptureJob*)malloc(sizeof(CaptureJob));
+    if (job == NULL) {
+        UnloadImage(image);
+        return;
+    }
+
+    job->image = image;
+    job->format = format;
+    job->written = false;
+    snprintf(job->path, sizeof(job->path), "%s", path);
+
+    for (int i = pendingCount - 1; i >= 0; i--) {
+        if (poolTaskDone(pending[i].task))
+            finishPending(i);
+    }
+
+    // Recording faster than the workers can encode waits here rather than queueing frames without bound.
+    if (pendingCount == CAPTURE_MAX_PENDING)
+        finishPending(0);
+
+    PoolTask* task = poolSubmit(runCaptureJob, job);
+
+    // No worker threads, write it now.
+    if (task == NULL) {
+        runCaptureJob(job);
+
+        if (!job->written)
+            failures++;
+
+        free(job);
+        return;
+    }
+
+    pending[pendingCount++] = (Pending) { job, task };
+}
+
+bool captureScreenshot(const char* path)
+{
+    if (strlen(path) >= sizeof(screenshotPath))
+        return false;
+
+    strcpy(screenshotPath, path);
+    screenshotRequested = true;
+    return true;
+}
+
+bool captureStartRecording(const char* directory, const char* type)
+{
+    // Leaves room for the separator, frame number and extension.
+    if (strlen(directory) + strlen(type) + 16 >= sizeof(recordDirectory) || strlen(type) >= sizeof(recordType))
+        return false;
+
+    strcpy(recordDirectory, directory);
+    strcpy(recordType, type);
+    recording = true;
+    recordFrame = 0;
+    return true;
+}
+
+void captureStopRecording()
+{
+    recording = false;
+}
+
+bool captureRecording()
+{
+    return recording;
+}
+
+int captureRecordedFrames()
+{
+    return recordFrame;
+}
+
+int captureFailures()
+{
+    return failures;
+}
+
+void captureFrame()
+{
+    if (!screenshotRequested && !recording)
+        return;
+
+    Image image = { NULL, 0, 0, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+
+    if (headlessEnabled()) {
+        image.data = headlessReadPixels(&image.width, &image.height);
+    } else {
+        // Draw whatever is still batched so the readback sees the whole frame.
+        rlDrawRenderBatchActive();
+
+        Vector2 scale = GetWindowScaleDPI();
+        image.width = (int)(GetRenderWidth() * scale.x);
+        image.height = (int)(GetRenderHeight() * scale.y);
+        image.data = rlReadScreenPixels(image.width, image.height);
+    }
+
+    if (image.data == NULL)
+        return;
+
+    if (screenshotRequested) {
+        screenshotRequested = false;
+        submit(recording ? ImageCopy(image) : image, screenshotPath);
+    }
+
+    if (recording) {
+        char path[CAPTURE_PATH_SIZE];
+        snprintf(path, sizeof(path), "%s/%05d%s", recordDirectory, recordFrame++, recordType);
+        submit(image, path);
+    }
+}
+
+void captureShutdown()
+{
+    while (pendingCount > 0)
+        finishPending(pendingCount - 1);
+
+    screenshotRequested = false;
+    recording = false;
+}
@@ -0,0 +1,30 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdbool.h>
+
+// Screenshots and frame sequences taken at the end of a frame. The pixels are
+// read back on the main thread, while encoding and writing the files happens
+// on the worker pool so a capture costs one readback instead of a PNG encode.
+
+// Takes a screenshot at the next captureFrame. Returns false if the path is too long.
+// Only .png and .qoi are written on the pool, other types block the main thread.
+bool captureScreenshot(const char* path);
+
+// Writes every frame to directory as 00000.png, 00001.png... with the given file type.
+bool captureStartRecording(const char* directory, const char* type);
+void captureStopRecording();
+bool captureRecording();
+int captureRecordedFrames();
+
+// Screenshots and frames that could not be written, counted as their writes finish.
+int captureFailures();
+
+// Called before EndDrawing, while the back buffer still holds the frame. In
+// headless mode the frame is read from the offscreen target instead.
+void captureFrame();
+
+// Waits for the files still being written.
+void captureShutdown();
+
+#endif
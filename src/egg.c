@@ -0,0 +1,550 @@
+#if defined(__linux__)
+#define _GNU_SOURCE
+#elif !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "egg.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "lib/map/map.h"
+
+#include "thread.h"
+
+#define MINIZ_HEADER_FILE_ONLY
+#include "lib/zip/miniz.h"
+
+#define EGG_MAX_PATH 512
+#define EGG_COPY_BUFFER (1024 * 1024)
+#define EGG_CACHE_BUDGET (64 * 1024 * 1024) // Bytes of inflated entries kept around
+
+typedef struct CachedEntry {
+    int index;
+    unsigned char* data;
+    size_t size;
+    struct CachedEntry* newer;
+    struct CachedEntry* older;
+} CachedEntry;
+
+struct Egg {
+    const unsigned char* map; // Whole mapped file
+    size_t mapSize;
+    const unsigned char* data; // Start of the zip archive inside the mapping
+    size_t size;
+    mz_zip_archive zip;
+    map_int_t index; // Entry path to file index
+    CachedEntry** cached; // Per file index, NULL when not cached
+    CachedEntry* newest;
+    CachedEntry* oldest;
+    size_t cacheSize;
+    Mutex* cacheLock; // Loads can come from worker threads
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+static bool mapFile(Egg* egg, const char* path)
+{
+#ifdef _WIN32
+    egg->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (egg->file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(egg->file, &size) || size.QuadPart == 0) {
+        CloseHandle(egg->file);
+        return false;
+    }
+
+    egg->mapping = CreateFileMappingA(egg->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (egg->mapping == NULL) {
+        CloseHandle(egg->file);
+        return false;
+    }
+
+    egg->map = (const unsigned char*)MapViewOfFile(egg->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (egg->map == NULL) {
+        CloseHandle(egg->mapping);
+        CloseHandle(egg->file);
+        return false;
+    }
+
+    egg->mapSize = (size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED)
+        return false;
+
+    egg->map = (const unsigned char*)map;
+    egg->mapSize = (size_t)st.st_size;
+#endif
+
+    return true;
+}
+
+static void unmapFile(Egg* egg)
+{
+#ifdef _WIN32
+    UnmapViewOfFile(egg->map);
+    CloseHandle(egg->mapping);
+    CloseHandle(egg->file);
+#else
+    munmap((void*)egg->map, egg->mapSize);
+#endif
+}
+
+static Egg* openRegion(Egg* egg, size_t offset, size_t size)
+{
+    egg->data = egg->map + offset;
+    egg->size = size;
+
+    mz_zip_zero_struct(&egg->zip);
+    if (!mz_zip_reader_init_mem(&egg->zip, egg->data, egg->size, 0)) {
+        unmapFile(egg);
+        free(egg);
+        return NULL;
+    }
+
+    mz_uint count = mz_zip_reader_get_num_files(&egg->zip);
+
+    egg->cached = (CachedEntry**)calloc(count + 1, sizeof(CachedEntry*));
+    if (egg->cached == NULL) {
+        mz_zip_reader_end(&egg->zip);
+        unmapFile(egg);
+        free(egg);
+        return NULL;
+    }
+
+    map_init(&egg->index);
+    egg->cacheLock = mutexCreate();
+
+    char name[EGG_MAX_PATH];
+    for (mz_uint i = 0; i < count; i++) {
+        if (mz_zip_reader_is_file_a_directory(&egg->zip, i))
+            continue;
+
+        if (mz_zip_reader_get_filename(&egg->zip, i, name, sizeof(name)) < sizeof(name))
+            map_set(&egg->index, name, (int)i);
+    }
+
+    return egg;
+}
+
+// Same rules as zip_entry_open: forward slashes and no leading "./" or "/".
+static const char* normalizePath(const char* path, char* buffer)
+{
+    while (path[0] == '.' && (path[1] == '/' || path[1] == '\\'))
+        path += 2;
+    while (path[0] == '/' || path[0] == '\\')
+        path++;
+
+    size_t length = strlen(path);
+    if (length >= EGG_MAX_PATH)
+        return NULL;
+
+    for (size_t i = 0; i <= length; i++)
+        buffer[i] = path[i] == '\\' ? '/' : path[i];
+
+    return buffer;
+}
+
+static int findEntry(Egg* egg, const char* path)
+{
+    char buffer[EGG_MAX_PATH];
+    const char* name = normalizePath(path, buffer);
+    if (name == NULL)
+        return -1;
+
+    int* index = map_get(&egg->index, name);
+    if (index)
+        return *index;
+
+    // Names differing only in case still resolve, as they did with zip_entry_open.
+    return mz_zip_reader_locate_file(&egg->zip, name, NULL, 0);
+}
+
+static void cacheUnlink(Egg* egg, CachedEntry* entry)
+{
+    if (entry->newer)
+        entry->newer->older = entry->older;
+    else
+        egg->newest = entry->older;
+
+    if (entry->older)
+        entry->older->newer = entry->newer;
+    else
+        egg->oldest = entry->newer;
+}
+
+static void cachePushNewest(Egg* egg, CachedEntry* entry)
+{
+    entry->newer = NULL;
+    entry->older = egg->newest;
+
+    if (egg->newest)
+        egg->newest->newer = entry;
+    else
+        egg->oldest = entry;
+
+    egg->newest = entry;
+}
+
+static void cacheEvict(Egg* egg, CachedEntry* entry)
+{
+    cacheUnlink(egg, entry);
+    egg->cached[entry->index] = NULL;
+    egg->cacheSize -= entry->size;
+    free(entry->data);
+    free(entry);
+}
+
+static void cacheInsert(Egg* egg, int index, const unsigned char* data, size_t size)
+{
+    // Another thread may have inflated the same entry meanwhile.
+    if (size > EGG_CACHE_BUDGET / 2 || egg->cached[index])
+        return;
+
+    while (egg->oldest && egg->cacheSize + size > EGG_CACHE_BUDGET)
+        cacheEvict(egg, egg->oldest);
+
+    CachedEntry* entry = (CachedEntry*)malloc(sizeof(CachedEntry));
+    if (entry == NULL)
+        return;
+
+    entry->data = (unsigned char*)malloc(size);
+    if (entry->data == NULL) {
+        free(entry);
+        return;
+    }
+
+    memcpy(entry->data, data, size);
+    entry->index = index;
+    entry->size = size;
+
+    cachePushNewest(egg, entry);
+    egg->cached[index] = entry;
+    egg->cacheSize += size;
+}
+
+static const unsigned char* entryView(Egg* egg, mz_zip_archive_file_stat* stat)
+{
+    if (stat->m_method != 0 || stat->m_is_encrypted || stat->m_comp_size != stat->m_uncomp_size)
+        return NULL;
+
+    // The local header repeats the name and may have a different extra field, so read its lengths.
+    size_t header = (size_t)stat->m_local_header_ofs;
+    if (header + 30 > egg->size)
+        return NULL;
+
+    const unsigned char* local = egg->data + header;
+    if (local[0] != 'P' || local[1] != 'K' || local[2] != 3 || local[3] != 4)
+        return NULL;
+
+    size_t nameLength = local[26] | (local[27] << 8);
+    size_t extraLength = local[28] | (local[29] << 8);
+    size_t offset = header + 30 + nameLength + extraLength;
+
+    if (offset + stat->m_comp_size > egg->size)
+        return NULL;
+
+    return egg->data + offset;
+}
+
+Egg* eggOpen(const char* path)
+{
+    Egg* egg = (Egg*)calloc(1, sizeof(Egg));
+    if (egg == NULL)
+        return NULL;
+
+    if (!mapFile(egg, path)) {
+        free(egg);
+        return NULL;
+    }
+
+    return openRegion(egg, 0, egg->mapSize);
+}
+
+Egg* eggOpenFused(const char* path)
+{
+    Egg* egg = (Egg*)calloc(1, sizeof(Egg));
+    if (egg == NULL)
+        return NULL;
+
+    if (!mapFile(egg, path)) {
+        free(egg);
+        return NULL;
+    }
+
+    // Fused executables end with the egg size as a little endian uint64 followed by "WR64".
+    // Older ones used a native int followed by "WRAY".
+    const unsigned char* end = egg->map + egg->mapSize;
+    uint64_t size = 0;
+    size_t trailer = 0;
+
+    if (egg->mapSize >= 12 && memcmp(end - 4, "WR64", 4) == 0) {
+        for (int i = 0; i < 8; i++)
+            size |= (uint64_t)end[-12 + i] << (i * 8);
+
+        trailer = 12;
+    } else if (egg->mapSize >= 8 && memcmp(end - 4, "WRAY", 4) == 0) {
+        int legacy;
+        memcpy(&legacy, end - 8, sizeof(int));
+
+        size = legacy > 0 ? (uint64_t)legacy : 0;
+        trailer = 8;
+    }
+
+    if (trailer == 0 || size == 0 || size > egg->mapSize - trailer) {
+        unmapFile(egg);
+        free(egg);
+        return NULL;
+    }
+
+    return openRegion(egg, egg->mapSize - trailer - (size_t)size, (size_t)size);
+}
+
+#ifdef _WIN32
+static bool appendFile(HANDLE out, const char* path, uint64_t* size)
+{
+    HANDLE in = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (in == INVALID_HANDLE_VALUE)
+        return false;
+
+    unsigned char* buffer = (unsigned char*)malloc(EGG_COPY_BUFFER);
+    bool ok = buffer != NULL;
+
+    *size = 0;
+
+    DWORD read;
+    while (ok && ReadFile(in, buffer, EGG_COPY_BUFFER, &read, NULL) && read > 0) {
+        DWORD written;
+        ok = WriteFile(out, buffer, read, &written, NULL) && written == read;
+        *size += read;
+    }
+
+    free(buffer);
+    CloseHandle(in);
+
+    return ok;
+}
+#else
+static bool appendFile(int out, const char* path, uint64_t* size)
+{
+    int in = open(path, O_RDONLY);
+    if (in < 0)
+        return false;
+
+    *size = 0;
+
+#ifdef __linux__
+    // Let the kernel copy (or reflink) the data without bouncing it through user space.
+    for (;;) {
+        ssize_t copied = copy_file_range(in, NULL, out, NULL, EGG_COPY_BUFFER * 64, 0);
+        if (copied > 0) {
+            *size += (uint64_t)copied;
+            continue;
+        }
+
+        if (copied == 0) {
+            close(in);
+            return true;
+        }
+
+        if (errno != ENOSYS && errno != EXDEV && errno != EINVAL && errno != EOPNOTSUPP) {
+            close(in);
+            return false;
+        }
+
+        // Not supported for these files, carry on with plain reads from where it stopped.
+        break;
+    }
+#endif
+
+    unsigned char* buffer = (unsigned char*)malloc(EGG_COPY_BUFFER);
+    bool ok = buffer != NULL;
+
+    while (ok) {
+        ssize_t count = read(in, buffer, EGG_COPY_BUFFER);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0) {
+            ok = count == 0;
+            break;
+        }
+
+        for (ssize_t done = 0; ok && done < count;) {
+            ssize_t written = write(out, buffer + done, (size_t)(count - done));
+            if (written < 0 && errno == EINTR)
+                continue;
+
+            ok = written > 0;
+            done += written;
+        }
+
+        *size += (uint64_t)count;
+    }
+
+    free(buffer);
+    close(in);
+
+    return ok;
+}
+#endif
+
+bool eggFuse(const char* exePath, const char* eggPath, const char* outPath)
+{
+    uint64_t exeSize, eggSize;
+
+#ifdef _WIN32
+    HANDLE out = CreateFileA(outPath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (out == INVALID_HANDLE_VALUE)
+        return false;
+#else
+    int out = open(outPath, O_WRONLY | O_CREAT | O_TRUNC, 0777);
+    if (out < 0)
+        return false;
+#endif
+
+    bool ok = appendFile(out, exePath, &exeSize) && appendFile(out, eggPath, &eggSize);
+
+    if (ok) {
+        unsigned char trailer[12];
+        for (int i = 0; i < 8; i++)
+            trailer[i] = (unsigned char)(eggSize >> (i * 8));
+        memcpy(trailer + 8, "WR64", 4);
+
+#ifdef _WIN32
+        DWORD written;
+        ok = WriteFile(out, trailer, sizeof(trailer), &written, NULL) && written == sizeof(trailer);
+#else
+        ok = write(out, trailer, sizeof(trailer)) == sizeof(trailer);
+#endif
+    }
+
+#ifdef _WIN32
+    ok = CloseHandle(out) && ok;
+#else
+    ok = close(out) == 0 && ok;
+#endif
+
+    if (!ok)
+        remove(outPath);
+
+    return ok;
+}
+
+void eggClose(Egg* egg)
+{
+    if (egg == NULL)
+        return;
+
+    while (egg->oldest)
+        cacheEvict(egg, egg->oldest);
+
+    free(egg->cached);
+    map_deinit(&egg->index);
+    mutexDestroy(egg->cacheLock);
+
+    mz_zip_reader_end(&egg->zip);
+    unmapFile(egg);
+    free(egg);
+}
+
+bool eggHas(Egg* egg, const char* path)
+{
+    return findEntry(egg, path) >= 0;
+}
+
+const unsigned char* eggView(Egg* egg, const char* path, size_t* size)
+{
+    int index = findEntry(egg, path);
+    if (index < 0)
+        return NULL;
+
+    mz_zip_archive_file_stat stat;
+    if (!mz_zip_reader_file_stat(&egg->zip, index, &stat))
+        return NULL;
+
+    const unsigned char* view = entryView(egg, &stat);
+    if (view)
+        *size = (size_t)stat.m_uncomp_size;
+
+    return view;
+}
+
+unsigned char* eggLoad(Egg* egg, const char* path, size_t* size)
+{
+    int index = findEntry(egg, path);
+    if (index < 0)
+        return NULL;
+
+    mz_zip_archive_file_stat stat;
+    if (!mz_zip_reader_file_stat(&egg->zip, index, &stat))
+        return NULL;
+
+    size_t length = (size_t)stat.m_uncomp_size;
+
+    unsigned char* buffer = (unsigned char*)malloc(length + 1);
+    if (buffer == NULL)
+        return NULL;
+
+    mutexLock(egg->cacheLock);
+
+    CachedEntry* cached = egg->cached[index];
+    if (cached) {
+        cacheUnlink(egg, cached);
+        cachePushNewest(egg, cached);
+        memcpy(buffer, cached->data, length);
+    }
+
+    mutexUnlock(egg->cacheLock);
+
+    // Inflating only reads the mapping, so it runs outside the lock.
+    if (cached == NULL) {
+        const unsigned char* view = entryView(egg, &stat);
+
+        if (view) {
+            memcpy(buffer, view, length);
+        } else if (mz_zip_reader_extract_to_mem(&egg->zip, index, buffer, length, 0)) {
+            mutexLock(egg->cacheLock);
+            cacheInsert(egg, index, buffer, length);
+            mutexUnlock(egg->cacheLock);
+        } else {
+            free(buffer);
+            return NULL;
+        }
+    }
+
+    buffer[length] = '\0';
+    *size = length;
+
+    return buffer;
+}
@@ -0,0 +1,31 @@
+#ifndef EGG_H
+#define EGG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Read-only view of an egg archive, either a standalone .egg file or the
+// egg appended to a fused executable. The file is memory mapped and the
+// zip central directory is parsed once when it is opened.
+
+typedef struct Egg Egg;
+
+Egg* eggOpen(const char* path);
+Egg* eggOpenFused(const char* path);
+void eggClose(Egg* egg);
+
+// Writes the executable followed by the egg and a trailer eggOpenFused can
+// find. Both files are streamed, never loaded whole.
+bool eggFuse(const char* exePath, const char* eggPath, const char* outPath);
+
+bool eggHas(Egg* egg, const char* path);
+
+// Returns a pointer into the mapping for entries stored without compression,
+// NULL for compressed or missing entries. Valid until the egg is closed.
+const unsigned char* eggView(Egg* egg, const char* path, size_t* size);
+
+// Returns a malloc'd copy of the entry followed by a NUL byte that is not
+// counted in size, or NULL if the entry is missing.
+unsigned char* eggLoad(Egg* egg, const char* path, size_t* size);
+
+#endif
@@ -0,0 +1,122 @@
+#include "feeder.h"
+
+#include <stdlib.h>
+
+#include "thread.h"
+
+#define FEEDER_INTERVAL 10 // Milliseconds between rounds
+
+typedef struct {
+    void (*fn)(void*);
+    void* arg;
+} Feed;
+
+static Thread* thread = NULL;
+static Mutex* mutex = NULL;
+static bool running = false;
+static Feed* feeds = NULL;
+static int feedCount = 0;
+static int feedCapacity = 0;
+
+static void feederLoop(void* arg)
+{
+    for (;;) {
+        mutexLock(mutex);
+
+        if (!running) {
+            mutexUnlock(mutex);
+            return;
+        }
+
+        for (int i = 0; i < feedCount; i++)
+            feeds[i].fn(feeds[i].arg);
+
+        mutexUnlock(mutex);
+        threadSleep(FEEDER_INTERVAL);
+    }
+}
+
+bool feederAdd(void (*fn)(void*), void* arg)
+{
+    if (mutex == NULL) {
+        mutex = mutexCreate();
+        if (mutex == NULL)
+            return false;
+    }
+
+    mutexLock(mutex);
+
+    if (feedCount == feedCapacity) {
+        int capacity = feedCapacity > 0 ? feedCapacity * 2 : 8;
+        Feed* grown = (Feed*)realloc(feeds, capacity * sizeof(Feed));
+        if (grown == NULL) {
+            mutexUnlock(mutex);
+            return false;
+        }
+
+        feeds = grown;
+        feedCapacity = capacity;
+    }
+
+    feeds[feedCount++] = (Feed) { fn, arg };
+
+    if (thread == NULL) {
+        running = true;
+        thread = threadCreate(feederLoop, NULL);
+    }
+
+    mutexUnlock(mutex);
+
+    return thread != NULL;
+}
+
+void feederRemove(void* arg)
+{
+    if (mutex == NULL)
+        return;
+
+    mutexLock(mutex);
+
+    for (int i = 0; i < feedCount; i++) {
+        if (feeds[i].arg == arg) {
+            feeds[i] = feeds[--feedCount];
+            break;
+        }
+    }
+
+    mutexUnlock(mutex);
+}
+
+void feederLock()
+{
+    if (mutex)
+        mutexLock(mutex);
+}
+
+void feederUnlock()
+{
+    if (mutex)
+        mutexUnlock(mutex);
+}
+
+void feederShutdown()
+{
+    if (mutex == NULL)
+        return;
+
+    mutexLock(mutex);
+    running = false;
+    mutexUnlock(mutex);
+
+    if (thread)
+        threadJoin(thread);
+
+    mutexDestroy(mutex);
+    free(feeds);
+
+    thread = NULL;
+    mutex = NULL;
+    feeds = NULL;
+    feedCount = 0;
+    feedCapacity = 0;
+}
@@ -0,0 +1,20 @@
+#ifndef FEEDER_H
+#define FEEDER_H
+
+#include <stdbool.h>
+
+// A background thread that calls each registered function every few
+// milliseconds, used to keep audio streams topped up without the script
+// having to call update every frame. The functions run with the feeder
+// lock held, so anything they share with the main thread must only be
+// touched between feederLock and feederUnlock.
+
+bool feederAdd(void (*fn)(void*), void* arg);
+void feederRemove(void* arg);
+
+void feederLock();
+void feederUnlock();
+
+void feederShutdown();
+
+#endif
@@ -0,0 +1,148 @@
+#include "headless.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <raylib.h>
+#include <rlgl.h>
+
+static bool enabled = false;
+static double step = 1.0 / 60.0;
+static int frameLimit = 0;
+static int frames = 0;
+static bool drawing = false;
+static RenderTexture target = { 0 };
+
+// Wall clock time between the ends of consecutive frames.
+static double lastEnd = 0.0;
+static double totalTime = 0.0;
+static double minTime = 0.0;
+static double maxTime = 0.0;
+
+void headlessEnable(double dt, int limit)
+{
+    enabled = true;
+    step = dt;
+    frameLimit = limit;
+}
+
+bool headlessEnabled()
+{
+    return enabled;
+}
+
+double headlessGetDt()
+{
+    return step;
+}
+
+double headlessGetTime()
+{
+    return frames * step;
+}
+
+bool headlessDone()
+{
+    return enabled && frameLimit > 0 && frames >= frameLimit;
+}
+
+void headlessBegin()
+{
+    if (!enabled)
+        return;
+
+    int width = GetRenderWidth();
+    int height = GetRenderHeight();
+
+    // Follows the window size, which the script may change at any time.
+    if (target.id == 0 || target.texture.width != width || target.texture.height != height) {
+        if (target.id != 0)
+            UnloadRenderTexture(target);
+
+        target = LoadRenderTexture(width, height);
+    }
+
+    drawing = true;
+    BeginTextureMode(target);
+}
+
+void headlessEnd()
+{
+    if (!enabled || !drawing)
+        return;
+
+    EndTextureMode();
+    drawing = false;
+
+    double now = GetTime();
+    if (frames > 0) {
+        double elapsed = now - lastEnd;
+        totalTime += elapsed;
+        minTime = frames == 1 || elapsed < minTime ? elapsed : minTime;
+        maxTime = elapsed > maxTime ? elapsed : maxTime;
+    }
+
+    lastEnd = now;
+    frames++;
+}
+
+void headlessResume()
+{
+    if (enabled && drawing)
+        BeginTextureMode(target);
+}
+
+unsigned char* headlessReadPixels(int* width, int* height)
+{
+    if (target.id == 0)
+        return NULL;
+
+    *width = target.texture.width;
+    *height = target.texture.height;
+
+    unsigned char* pixels = (unsigned char*)rlReadTexturePixels(target.texture.id, *width, *height, target.texture.format);
+    if (pixels == NULL)
+        return NULL;
+
+    // Render textures are stored bottom-up, images top-down.
+    size_t rowSize = (size_t)*width * 4;
+    unsigned char* row = (unsigned char*)malloc(rowSize);
+    if (row == NULL) {
+        free(pixels);
+        return NULL;
+    }
+
+    for (int y = 0; y < *height / 2; y++) {
+        unsigned char* top = &pixels[y * rowSize];
+        unsigned char* bottom = &pixels[(*height - 1 - y) * rowSize];
+        memcpy(row, top, rowSize);
+        memcpy(top, bottom, rowSize);
+        memcpy(bottom, row, rowSize);
+    }
+
+    free(row);
+
+    // Match screen captures, which are always opaque.
+    for (size_t i = 3; i < rowSize * *height; i += 4)
+        pixels[i] = 255;
+
+    return pixels;
+}
+
+void headlessShutdown()
+{
+    if (!enabled)
+        return;
+
+    if (frames > 1) {
+        int intervals = frames - 1;
+        printf("Rendered %d frames, frame time avg %.3f ms, min %.3f ms, max %.3f ms\n",
+            frames, totalTime / intervals * 1000.0, minTime * 1000.0, maxTime * 1000.0);
+    }
+
+    if (target.id != 0 && IsWindowReady())
+        UnloadRenderTexture(target);
+
+    target = (RenderTexture) { 0 };
+}
@@ -0,0 +1,33 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <stdbool.h>
+
+// Runs games for automated tests and benchmarks: the window stays hidden,
+// frames are drawn into an offscreen render texture, and time advances by a
+// fixed step per frame so every run sees the same dt sequence.
+
+// A frameLimit of 0 runs until the script closes the window itself.
+void headlessEnable(double dt, int frameLimit);
+bool headlessEnabled();
+
+double headlessGetDt();
+double headlessGetTime();
+
+// True once frameLimit frames have been drawn, reported to the script as Window.closed.
+bool headlessDone();
+
+// Called after BeginDrawing and before EndDrawing.
+void headlessBegin();
+void headlessEnd();
+
+// Rebinds the offscreen target after the script ends its own texture mode mid-frame.
+void headlessResume();
+
+// Reads the last frame as top-down RGBA, freed by the caller.
+unsigned char* headlessReadPixels(int* width, int* height);
+
+// Prints frame timings and frees the target, called before the window closes.
+void headlessShutdown();
+
+#endif
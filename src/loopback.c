@@ -0,0 +1,482 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "loopback.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+#define LOOPBACK_SOCKET_BASE 0x40000000
+#define LOOPBACK_PORT_FIRST 49152
+
+#define TIME_LESS(a, b) ((int)((enet_uint32)(a) - (enet_uint32)(b)) < 0)
+
+typedef struct {
+    enet_uint32 deliverAt;
+    enet_uint32 sequence;
+    ENetAddress from;
+    size_t length;
+    enet_uint8 data[];
+} Datagram;
+
+typedef struct {
+    bool bound;
+    enet_uint16 port;
+    Datagram** queue; // Binary heap ordered by delivery time
+    int count;
+    int capacity;
+    double linkBacklog; // Milliseconds of outgoing data still on the wire
+    enet_uint32 linkTime;
+} VirtualSocket;
+
+static bool enabled = false;
+static bool deterministic = false;
+static enet_uint32 virtualClock = 0;
+
+static LoopbackSettings settings = { 0 };
+
+static enet_uint32 rng = 0x9E3779B9;
+static enet_uint32 sequence = 0;
+
+static VirtualSocket** sockets = NULL;
+static int socketCapacity = 0;
+static int ports[65536]; // Socket index + 1 bound to each port
+static int nextPort = LOOPBACK_PORT_FIRST;
+
+static LoopbackStats stats = { 0 };
+
+static enet_uint32 nextRandom()
+{
+    // xorshift32
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void sleepMs(enet_uint32 ms)
+{
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static VirtualSocket* getSocket(ENetSocket socket)
+{
+    if (socket == ENET_SOCKET_NULL || socket < LOOPBACK_SOCKET_BASE)
+        return NULL;
+
+    size_t index = (size_t)(socket - LOOPBACK_SOCKET_BASE);
+    if (index >= (size_t)socketCapacity)
+        return NULL;
+
+    return sockets[index];
+}
+
+static bool datagramLess(Datagram* a, Datagram* b)
+{
+    if (a->deliverAt != b->deliverAt)
+        return TIME_LESS(a->deliverAt, b->deliverAt);
+
+    return TIME_LESS(a->sequence, b->sequence);
+}
+
+static bool queuePush(VirtualSocket* s, Datagram* datagram)
+{
+    if (s->count == s->capacity) {
+        int capacity = s->capacity == 0 ? 64 : s->capacity * 2;
+        Datagram** queue = realloc(s->queue, capacity * sizeof(Datagram*));
+        if (queue == NULL)
+            return false;
+
+        s->queue = queue;
+        s->capacity = capacity;
+    }
+
+    int i = s->count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!datagramLess(datagram, s->queue[parent]))
+            break;
+
+        s->queue[i] = s->queue[parent];
+        i = parent;
+    }
+    s->queue[i] = datagram;
+
+    return true;
+}
+
+static Datagram* queuePop(VirtualSocket* s)
+{
+    Datagram* top = s->queue[0];
+    Datagram* last = s->queue[--s->count];
+
+    int i = 0;
+    for (;;) {
+        int child = i * 2 + 1;
+        if (child >= s->count)
+            break;
+        if (child + 1 < s->count && datagramLess(s->queue[child + 1], s->queue[child]))
+            child++;
+        if (!datagramLess(s->queue[child], last))
+            break;
+
+        s->queue[i] = s->queue[child];
+        i = child;
+    }
+    if (s->count > 0)
+        s->queue[i] = last;
+
+    return top;
+}
+
+static bool queueReady(VirtualSocket* s, enet_uint32 now)
+{
+    return s->count > 0 && !TIME_LESS(now, s->queue[0]->deliverAt);
+}
+
+static int bindPort(ENetSocket socket, VirtualSocket* s, enet_uint16 port)
+{
+    if (port == ENET_PORT_ANY) {
+        int tries = 65536 - LOOPBACK_PORT_FIRST;
+        while (tries-- > 0 && ports[nextPort] != 0) {
+            nextPort = nextPort == 65535 ? LOOPBACK_PORT_FIRST : nextPort + 1;
+        }
+
+        if (ports[nextPort] != 0)
+            return -1;
+
+        port = (enet_uint16)nextPort;
+    } else if (ports[port] != 0) {
+        return -1;
+    }
+
+    ports[port] = (int)(socket - LOOPBACK_SOCKET_BASE) + 1;
+    s->port = port;
+    s->bound = true;
+
+    return 0;
+}
+
+void loopbackEnable(bool enable)
+{
+    enabled = enable;
+}
+
+void loopbackReset()
+{
+    for (int i = 0; i < socketCapacity; i++) {
+        if (sockets[i])
+            loopbackSocketDestroy(LOOPBACK_SOCKET_BASE + i);
+    }
+
+    free(sockets);
+    sockets = NULL;
+    socketCapacity = 0;
+    nextPort = LOOPBACK_PORT_FIRST;
+
+    memset(&stats, 0, sizeof(stats));
+}
+
+LoopbackSettings* loopbackSettings()
+{
+    return &settings;
+}
+
+void loopbackSeedRandom(unsigned int seed)
+{
+    rng = seed != 0 ? seed : 0x9E3779B9;
+}
+
+void loopbackUseVirtualClock(bool enable)
+{
+    if (enable && !deterministic)
+        virtualClock = enet_time_get();
+
+    deterministic = enable;
+}
+
+void loopbackAdvanceClock(enet_uint32 ms)
+{
+    virtualClock += ms;
+}
+
+void loopbackReadStats(LoopbackStats* out)
+{
+    *out = stats;
+}
+
+ENetSocket loopbackSocketCreate(ENetSocketType type)
+{
+    if (!enabled)
+        return enet_socket_create(type);
+
+    if (type != ENET_SOCKET_TYPE_DATAGRAM)
+        return ENET_SOCKET_NULL;
+
+    int index = 0;
+    while (index < socketCapacity && sockets[index] != NULL)
+        index++;
+
+    if (index == socketCapacity) {
+        int capacity = socketCapacity == 0 ? 16 : socketCapacity * 2;
+        VirtualSocket** grown = realloc(sockets, capacity * sizeof(VirtualSocket*));
+        if (grown == NULL)
+            return ENET_SOCKET_NULL;
+
+        memset(grown + socketCapacity, 0, (capacity - socketCapacity) * sizeof(VirtualSocket*));
+        sockets = grown;
+        socketCapacity = capacity;
+    }
+
+    VirtualSocket* s = calloc(1, sizeof(VirtualSocket));
+    if (s == NULL)
+        return ENET_SOCKET_NULL;
+
+    s->linkTime = loopbackTimeGet();
+    sockets[index] = s;
+
+    return LOOPBACK_SOCKET_BASE + index;
+}
+
+int loopbackSocketBind(ENetSocket socket, const ENetAddress* address)
+{
+    VirtualSocket* s = getSocket(socket);
+    if (s == NULL)
+        return enet_socket_bind(socket, address);
+
+    if (s->bound)
+        return -1;
+
+    return bindPort(socket, s, address ? address->port : ENET_PORT_ANY);
+}
+
+int loopbackSocketGetAddress(ENetSocket socket, ENetAddress* address)
+{
+    VirtualSocket* s = getSocket(socket);
+    if (s == NULL)
+        return enet_socket_get_address(socket, address);
+
+    if (!s->bound)
+        return -1;
+
+    address->host = ENET_HOST_TO_NET_32(0x7F000001);
+    address->port = s->port;
+
+    return 0;
+}
+
+int loopbackSocketSetOption(ENetSocket socket, ENetSocketOption option, int value)
+{
+    if (getSocket(socket) == NULL)
+        return enet_socket_set_option(socket, option, value);
+
+    return 0;
+}
+
+int loopbackSocketSend(ENetSocket socket, const ENetAddress* address, const ENetBuffer* buffers, size_t bufferCount)
+{
+    VirtualSocket* s = getSocket(socket);
+    if (s == NULL)
+        return enet_socket_send(socket, address, buffers, bufferCount);
+
+    // Unbound sockets get an ephemeral port on first send, like UDP.
+    if (!s->bound && bindPort(socket, s, ENET_PORT_ANY) < 0)
+        return -1;
+
+    size_t length = 0;
+    for (size_t i = 0; i < bufferCount; i++)
+        length += buffers[i].dataLength;
+
+    enet_uint32 now = loopbackTimeGet();
+
+    stats.sent++;
+    stats.bytes += length;
+
+    // The sender's link is busy for the transmission time of every packet, so
+    // bursts above the bandwidth queue up behind each other.
+    if (settings.bandwidth > 0) {
+        double elapsed = (double)(enet_uint32)(now - s->linkTime);
+        s->linkBacklog = s->linkBacklog > elapsed ? s->linkBacklog - elapsed : 0.0;
+        s->linkBacklog += length * 1000.0 / settings.bandwidth;
+    }
+    s->linkTime = now;
+
+    int targetIndex = address ? ports[address->port] : 0;
+    VirtualSocket* target = targetIndex ? sockets[targetIndex - 1] : NULL;
+    if (target == NULL) {
+        stats.dropped++;
+        return (int)length;
+    }
+
+    if (settings.loss > 0.0 && (nextRandom() >> 8) / 16777216.0 < settings.loss) {
+        stats.dropped++;
+        return (int)length;
+    }
+
+    Datagram* datagram = malloc(sizeof(Datagram) + length);
+    if (datagram == NULL)
+        return -1;
+
+    enet_uint32 delay = settings.latency + (enet_uint32)s->linkBacklog;
+    if (settings.jitter > 0)
+        delay += nextRandom() % (settings.jitter + 1);
+
+    datagram->deliverAt = now + delay;
+    datagram->sequence = sequence++;
+    datagram->from.host = ENET_HOST_TO_NET_32(0x7F000001);
+    datagram->from.port = s->port;
+    datagram->length = length;
+
+    size_t offset = 0;
+    for (size_t i = 0; i < bufferCount; i++) {
+        memcpy(datagram->data + offset, buffers[i].data, buffers[i].dataLength);
+        offset += buffers[i].dataLength;
+    }
+
+    if (!queuePush(target, datagram)) {
+        free(datagram);
+        return -1;
+    }
+
+    stats.queued++;
+
+    return (int)length;
+}
+
+int loopbackSocketReceive(ENetSocket socket, ENetAddress* address, ENetBuffer* buffers, size_t bufferCount)
+{
+    VirtualSocket* s = getSocket(socket);
+    if (s == NULL)
+        return enet_socket_receive(socket, address, buffers, bufferCount);
+
+    if (!queueReady(s, loopbackTimeGet()))
+        return 0;
+
+    Datagram* datagram = queuePop(s);
+    stats.queued--;
+
+    size_t capacity = 0;
+    for (size_t i = 0; i < bufferCount; i++)
+        capacity += buffers[i].dataLength;
+
+    // Truncated datagrams are an error, same as MSG_TRUNC on a real socket.
+    if (datagram->length > capacity) {
+        free(datagram);
+        stats.dropped++;
+        return -1;
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < bufferCount && offset < datagram->length; i++) {
+        size_t chunk = datagram->length - offset;
+        if (chunk > buffers[i].dataLength)
+            chunk = buffers[i].dataLength;
+
+        memcpy(buffers[i].data, datagram->data + offset, chunk);
+        offset += chunk;
+    }
+
+    if (address)
+        *address = datagram->from;
+
+    int length = (int)datagram->length;
+    free(datagram);
+    stats.delivered++;
+
+    return length;
+}
+
+int loopbackSocketWait(ENetSocket socket, enet_uint32* condition, enet_uint32 timeout)
+{
+    VirtualSocket* s = getSocket(socket);
+    if (s == NULL)
+        return enet_socket_wait(socket, condition, timeout);
+
+    enet_uint32 wanted = *condition;
+    *condition = ENET_SOCKET_WAIT_NONE;
+
+    if (wanted & ENET_SOCKET_WAIT_SEND) {
+        *condition |= ENET_SOCKET_WAIT_SEND;
+        return 0;
+    }
+
+    if (!(wanted & ENET_SOCKET_WAIT_RECEIVE))
+        return 0;
+
+    enet_uint32 now = loopbackTimeGet();
+    enet_uint32 deadline = now + timeout;
+
+    for (;;) {
+        if (queueReady(s, now)) {
+            *condition |= ENET_SOCKET_WAIT_RECEIVE;
+            return 0;
+        }
+
+        if (!TIME_LESS(now, deadline))
+            return 0;
+
+        enet_uint32 next = deadline;
+        if (s->count > 0 && TIME_LESS(s->queue[0]->deliverAt, next))
+            next = s->queue[0]->deliverAt;
+
+        // In deterministic mode waiting is what moves time forward, otherwise
+        // sleep until the next datagram lands or the timeout expires.
+        if (deterministic) {
+            virtualClock = next;
+        } else {
+            sleepMs(next - now);
+        }
+
+        now = loopbackTimeGet();
+    }
+}
+
+void loopbackSocketDestroy(ENetSocket socket)
+{
+    VirtualSocket* s = getSocket(socket);
+    if (s == NULL) {
+        enet_socket_destroy(socket);
+        return;
+    }
+
+    if (s->bound)
+        ports[s->port] = 0;
+
+    for (int i = 0; i < s->count; i++)
+        free(s->queue[i]);
+
+    stats.queued -= s->count;
+
+    free(s->queue);
+    free(s);
+
+    sockets[socket - LOOPBACK_SOCKET_BASE] = NULL;
+}
+
+enet_uint32 loopbackTimeGet(void)
+{
+    if (deterministic)
+        return virtualClock;
+
+    return enet_time_get();
+}
+
+enet_uint32 loopbackHostRandomSeed(void)
+{
+    if (deterministic)
+        return nextRandom();
+
+    return enet_host_random_seed();
+}
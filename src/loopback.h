@@ -0,0 +1,48 @@
+#ifndef LOOPBACK_H
+#define LOOPBACK_H
+
+#include <stdbool.h>
+
+#include <enet/enet.h>
+
+// In-process datagram transport used by loopback hosts.
+// ENet's host.c and protocol.c are compiled with their socket and time calls
+// renamed to the functions below (see CMakeLists.txt). Sockets created while
+// loopback is enabled are virtual, everything else is forwarded to ENet.
+
+typedef struct {
+    int latency;   // One-way delay in milliseconds
+    int jitter;    // Extra random delay of up to this many milliseconds
+    double loss;   // Probability of dropping a datagram, from 0 to 1
+    int bandwidth; // Bytes per second each socket can send, 0 for unlimited
+} LoopbackSettings;
+
+typedef struct {
+    double sent;
+    double delivered;
+    double dropped;
+    double bytes;
+    double queued;
+} LoopbackStats;
+
+void loopbackEnable(bool enable);
+void loopbackReset();
+
+LoopbackSettings* loopbackSettings();
+void loopbackSeedRandom(unsigned int seed);
+void loopbackUseVirtualClock(bool enable);
+void loopbackAdvanceClock(enet_uint32 ms);
+void loopbackReadStats(LoopbackStats* stats);
+
+ENetSocket loopbackSocketCreate(ENetSocketType type);
+int loopbackSocketBind(ENetSocket socket, const ENetAddress* address);
+int loopbackSocketGetAddress(ENetSocket socket, ENetAddress* address);
+int loopbackSocketSetOption(ENetSocket socket, ENetSocketOption option, int value);
+int loopbackSocketSend(ENetSocket socket, const ENetAddress* address, const ENetBuffer* buffers, size_t bufferCount);
+int loopbackSocketReceive(ENetSocket socket, ENetAddress* address, ENetBuffer* buffers, size_t bufferCount);
+int loopbackSocketWait(ENetSocket socket, enet_uint32* condition, enet_uint32 timeout);
+void loopbackSocketDestroy(ENetSocket socket);
+enet_uint32 loopbackTimeGet(void);
+enet_uint32 loopbackHostRandomSeed(void);
+
+#endif
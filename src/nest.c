@@ -0,0 +1,553 @@
+// 64-bit stat sizes on 32-bit Linux too.
+#if !defined(_WIN32)
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "nest.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include <raylib.h>
+
+#include "lib/map/map.h"
+
+#include "thread.h"
+#include "util.h"
+
+#define MINIZ_HEADER_FILE_ONLY
+#include "lib/zip/miniz.h"
+
+#define NEST_CONFIG "nest.cfg"
+#define NEST_MANIFEST_HEADER "# wray nest manifest 1"
+
+// Formats that are already compressed and gain nothing from deflate.
+#define NEST_STORED_EXTENSIONS ".png;.jpg;.jpeg;.gif;.qoi;.webp;.ogg;.mp3;.flac;.qoa;.zip;.egg"
+
+typedef struct {
+    char pattern[256];
+    int level;
+} Rule;
+
+// What the previous build packed for a path, read from the manifest next to the egg.
+typedef struct {
+    char* name;
+    long long size;
+    long modified;
+    int level;
+    BYTE hash[SHA256_BLOCK_SIZE];
+} Record;
+
+typedef struct {
+    Record* records;
+    int count;
+    map_int_t index; // Entry name to record
+} Manifest;
+
+typedef struct {
+    const char* path;
+    char* name;
+    int level;
+    long long fileSize;
+    long modified;
+    BYTE hash[SHA256_BLOCK_SIZE];
+
+    const Record* record; // Previous build of this path, NULL if new
+    int previous; // Index in the previous egg, -1 if it isn't there
+    bool reused; // Copied as is from the previous egg
+
+    unsigned char* data; // Raw file, or the deflated stream when compressed
+    size_t size;
+    size_t rawSize;
+    mz_uint32 crc;
+    bool compressed;
+    bool failed;
+    bool done;
+} Entry;
+
+typedef struct {
+    Entry* entries;
+    int count;
+    int next; // Next entry a worker will pick up
+    int written; // Entries already written to the archive
+    int window; // Entries allowed in flight ahead of the writer
+    Mutex* mutex;
+    Cond* ready; // Signaled by workers when an entry is done
+    Cond* space; // Signaled by the writer when the window moves
+} Queue;
+
+static Rule* loadRules(const char* dir, int* count)
+{
+    *count = 0;
+
+    const char* path = TextFormat("%s/%s", dir, NEST_CONFIG);
+    if (!FileExists(path))
+        return NULL;
+
+    char* text = LoadFileText(path);
+    if (text == NULL)
+        return NULL;
+
+    Rule* rules = NULL;
+    int capacity = 0;
+
+    char* line = text;
+    while (line && *line) {
+        char* end = strchr(line, '\n');
+        if (end)
+            *end = '\0';
+
+        char pattern[256];
+        char level[16];
+        if (line[0] != '#' && sscanf(line, "%255s %15s", pattern, level) == 2) {
+            int value = TextIsEqual(level, "store") ? 0 : atoi(level);
+
+            if (value < 0 || value > 9) {
+                printf("%s: invalid level %s for %s\n", NEST_CONFIG, level, pattern);
+            } else {
+                if (*count == capacity) {
+                    capacity = capacity ? capacity * 2 : 8;
+                    rules = (Rule*)realloc(rules, capacity * sizeof(Rule));
+                }
+
+                TextCopy(rules[*count].pattern, pattern);
+                rules[*count].level = value;
+                (*count)++;
+            }
+        }
+
+        line = end ? end + 1 : NULL;
+    }
+
+    UnloadFileText(text);
+
+    return rules;
+}
+
+static int entryLevel(const char* name, const Rule* rules, int ruleCount, int level)
+{
+    if (IsFileExtension(name, NEST_STORED_EXTENSIONS))
+        level = 0;
+
+    const char* base = strrchr(name, '/');
+    base = base ? base + 1 : name;
+
+    for (int i = 0; i < ruleCount; i++) {
+        const char* subject = strchr(rules[i].pattern, '/') ? name : base;
+        if (globMatch(rules[i].pattern, subject))
+            level = rules[i].level;
+    }
+
+    return level;
+}
+
+static bool loadManifest(Manifest* manifest, const char* path)
+{
+    map_init(&manifest->index);
+
+    char* text = LoadFileText(path);
+    if (text == NULL)
+        return false;
+
+    if (strncmp(text, NEST_MANIFEST_HEADER, strlen(NEST_MANIFEST_HEADER)) != 0) {
+        UnloadFileText(text);
+        return false;
+    }
+
+    int capacity = 0;
+
+    char* line = text;
+    while (line && *line) {
+        char* end = strchr(line, '\n');
+        if (end)
+            *end = '\0';
+
+        // <size> <mtime> <level> <sha256> <name>, the name runs to the end of the line.
+        Record record;
+        char hash[SHA256_BLOCK_SIZE * 2 + 1];
+        int nameStart = 0;
+
+        if (line[0] != '#' && sscanf(line, "%lld %ld %d %64s %n", &record.size, &record.modified, &record.level, hash, &nameStart) == 4 && nameStart > 0 && line[nameStart] != '\0') {
+            size_t hashLength;
+            unsigned char* bytes = hexToBytes(hash, strlen(hash), &hashLength);
+
+            if (bytes && hashLength == SHA256_BLOCK_SIZE) {
+                if (manifest->count == capacity) {
+                    capacity = capacity ? capacity * 2 : 64;
+                    manifest->records = (Record*)realloc(manifest->records, capacity * sizeof(Record));
+                }
+
+                size_t length = strlen(line + nameStart);
+                record.name = (char*)malloc(length + 1);
+                memcpy(record.name, line + nameStart, length + 1);
+                memcpy(record.hash, bytes, SHA256_BLOCK_SIZE);
+
+                manifest->records[manifest->count] = record;
+                map_set(&manifest->index, record.name, manifest->count);
+                manifest->count++;
+            }
+
+            free(bytes);
+        }
+
+        line = end ? end + 1 : NULL;
+    }
+
+    UnloadFileText(text);
+
+    return true;
+}
+
+static void unloadManifest(Manifest* manifest)
+{
+    for (int i = 0; i < manifest->count; i++)
+        free(manifest->records[i].name);
+
+    free(manifest->records);
+    map_deinit(&manifest->index);
+}
+
+static bool saveManifest(const char* path, const Entry* entries, int count)
+{
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+        return false;
+
+    fprintf(file, "%s\n", NEST_MANIFEST_HEADER);
+
+    for (int i = 0; i < count; i++) {
+        const Entry* entry = &entries[i];
+
+        size_t length;
+        char* hash = bytesToHex(entry->hash, SHA256_BLOCK_SIZE, &length);
+        fprintf(file, "%lld %ld %d %.*s %s\n", entry->fileSize, entry->modified, entry->level, (int)length, hash, entry->name);
+        free(hash);
+    }
+
+    return fclose(file) == 0;
+}
+
+// ftell and GetFileLength stop at 2 GB where long or int is 32 bits, stat has a 64-bit size everywhere.
+static long long getFileSize(const char* path)
+{
+#ifdef _WIN32
+    struct __stat64 info;
+    if (_stat64(path, &info) != 0)
+        return -1;
+#else
+    struct stat info;
+    if (stat(path, &info) != 0)
+        return -1;
+#endif
+
+    return (long long)info.st_size;
+}
+
+static unsigned char* readFile(const char* path, size_t* size)
+{
+    long long length = getFileSize(path);
+    if (length < 0 || (unsigned long long)length > SIZE_MAX)
+        return NULL;
+
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+        return NULL;
+
+    unsigned char* data = (unsigned char*)malloc(length > 0 ? (size_t)length : 1);
+    if (data && fread(data, 1, (size_t)length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+
+    fclose(file);
+
+    *size = (size_t)length;
+
+    return data;
+}
+
+static void compressEntry(Entry* entry)
+{
+    entry->data = readFile(entry->path, &entry->rawSize);
+    if (entry->data == NULL) {
+        entry->failed = true;
+        return;
+    }
+
+    entry->fileSize = (long long)entry->rawSize;
+
+    SHA256_CTX ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, entry->data, entry->rawSize);
+    sha256_final(&ctx, entry->hash);
+
+    // Touched but not changed, the previous entry is still good.
+    const Record* record = entry->record;
+    if (record && entry->previous >= 0 && record->level == entry->level && memcmp(record->hash, entry->hash, SHA256_BLOCK_SIZE) == 0) {
+        free(entry->data);
+        entry->data = NULL;
+        entry->reused = true;
+        return;
+    }
+
+    entry->size = entry->rawSize;
+    entry->crc = (mz_uint32)mz_crc32(MZ_CRC32_INIT, entry->data, entry->rawSize);
+
+    if (entry->level == 0 || entry->rawSize == 0)
+        return;
+
+    // Raw deflate, exactly what mz_zip_writer_add_mem would have produced.
+    int flags = tdefl_create_comp_flags_from_zip_params(entry->level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+
+    size_t size;
+    void* deflated = tdefl_compress_mem_to_heap(entry->data, entry->rawSize, &size, flags);
+
+    // Keep the raw bytes when deflate doesn't help, they can be mapped at runtime.
+    if (deflated && size < entry->rawSize) {
+        free(entry->data);
+        entry->data = (unsigned char*)deflated;
+        entry->size = size;
+        entry->compressed = true;
+    } else {
+        mz_free(deflated);
+    }
+}
+
+static void worker(void* arg)
+{
+    Queue* queue = (Queue*)arg;
+
+    mutexLock(queue->mutex);
+
+    for (;;) {
+        while (queue->next < queue->count && queue->next >= queue->written + queue->window)
+            condWait(queue->space, queue->mutex);
+
+        if (queue->next >= queue->count)
+            break;
+
+        Entry* entry = &queue->entries[queue->next++];
+        if (entry->done)
+            continue;
+
+        mutexUnlock(queue->mutex);
+        compressEntry(entry);
+        mutexLock(queue->mutex);
+
+        entry->done = true;
+        condBroadcast(queue->ready);
+    }
+
+    mutexUnlock(queue->mutex);
+}
+
+static bool writeEntry(mz_zip_archive* zip, mz_zip_archive* previous, Entry* entry)
+{
+    if (entry->reused)
+        return mz_zip_writer_add_from_zip_reader(zip, previous, entry->previous);
+
+    time_t modified = (time_t)entry->modified;
+
+    if (entry->compressed) {
+        return mz_zip_writer_add_mem_ex_v2(zip, entry->name, entry->data, entry->size, NULL, 0,
+            entry->level | MZ_ZIP_FLAG_COMPRESSED_DATA, entry->rawSize, entry->crc, &modified, NULL, 0, NULL, 0);
+    }
+
+    return mz_zip_writer_add_mem_ex_v2(zip, entry->name, entry->data, entry->size, NULL, 0,
+        0, 0, 0, &modified, NULL, 0, NULL, 0);
+}
+
+static char* entryName(const char* path, const char* dir)
+{
+    const char* name = path + strlen(dir);
+    while (*name == '/' || *name == '\\')
+        name++;
+
+    size_t length = strlen(name);
+    char* copy = (char*)malloc(length + 1);
+    memcpy(copy, name, length + 1);
+
+    for (char* c = copy; *c; c++) {
+        if (*c == '\\')
+            *c = '/';
+    }
+
+    return copy;
+}
+
+bool nestPack(const char* dir, const char* output, const NestOptions* options, NestStats* stats)
+{
+    int ruleCount;
+    Rule* rules = loadRules(dir, &ruleCount);
+
+    char manifestPath[512];
+    char tempPath[512];
+    TextCopy(manifestPath, TextFormat("%s.cache", output));
+    TextCopy(tempPath, TextFormat("%s.tmp", output));
+
+    // The previous egg is only trusted together with the manifest it was written with.
+    Manifest manifest = { 0 };
+    mz_zip_archive previous;
+    mz_zip_zero_struct(&previous);
+
+    bool incremental = !options->force && loadManifest(&manifest, manifestPath) && mz_zip_reader_init_file(&previous, output, 0);
+
+    FilePathList files = LoadDirectoryFilesEx(dir, NULL, true);
+
+    Queue queue = { 0 };
+    queue.entries = (Entry*)calloc(files.count + 1, sizeof(Entry));
+
+    for (int i = 0; i < (int)files.count; i++) {
+        char* name = entryName(files.paths[i], dir);
+
+        if (TextIsEqual(name, NEST_CONFIG)) {
+            free(name);
+            continue;
+        }
+
+        Entry* entry = &queue.entries[queue.count++];
+        entry->path = files.paths[i];
+        entry->name = name;
+        entry->level = entryLevel(name, rules, ruleCount, options->level);
+        entry->fileSize = getFileSize(files.paths[i]);
+        entry->modified = GetFileModTime(files.paths[i]);
+        entry->previous = -1;
+
+        int* record = incremental ? map_get(&manifest.index, name) : NULL;
+        if (record) {
+            entry->record = &manifest.records[*record];
+            entry->previous = mz_zip_reader_locate_file(&previous, name, NULL, MZ_ZIP_FLAG_CASE_SENSITIVE);
+        }
+
+        // Same size and time as last build, reuse it without reading the file at all.
+        const Record* last = entry->record;
+        if (last && entry->previous >= 0 && last->size == entry->fileSize && last->modified == entry->modified && last->level == entry->level) {
+            memcpy(entry->hash, last->hash, SHA256_BLOCK_SIZE);
+            entry->reused = true;
+            entry->done = true;
+        }
+    }
+
+    free(rules);
+
+    mz_zip_archive zip;
+    mz_zip_zero_struct(&zip);
+
+    bool ok = mz_zip_writer_init_file(&zip, tempPath, 0);
+    if (!ok)
+        printf("Failed to create %s\n", tempPath);
+
+    int jobs = options->jobs > 0 ? options->jobs : threadCpuCount();
+    if (jobs > queue.count)
+        jobs = queue.count;
+
+    Thread** threads = (Thread**)calloc(jobs + 1, sizeof(Thread*));
+
+    queue.window = jobs * 2;
+    queue.mutex = mutexCreate();
+    queue.ready = condCreate();
+    queue.space = condCreate();
+
+    if (ok) {
+        for (int i = 0; i < jobs; i++)
+            threads[i] = threadCreate(worker, &queue);
+    }
+
+    // Write entries in order as they come back, so the egg layout doesn't depend on timing.
+    for (int i = 0; ok && i < queue.count; i++) {
+        Entry* entry = &queue.entries[i];
+
+        mutexLock(queue.mutex);
+        while (!entry->done) {
+            // Nobody has picked this one up yet, so compress it here rather than wait.
+            if (queue.next <= i) {
+                queue.next = i + 1;
+                mutexUnlock(queue.mutex);
+                compressEntry(entry);
+                mutexLock(queue.mutex);
+                entry->done = true;
+            } else {
+                condWait(queue.ready, queue.mutex);
+            }
+        }
+        mutexUnlock(queue.mutex);
+
+        if (entry->failed) {
+            printf("Failed to read %s\n", entry->path);
+            ok = false;
+        } else if (!writeEntry(&zip, &previous, entry)) {
+            printf("Failed to write %s: %s\n", entry->name, mz_zip_get_error_string(mz_zip_get_last_error(&zip)));
+            ok = false;
+        }
+
+        if (entry->reused && stats)
+            stats->reused++;
+
+        free(entry->data);
+        entry->data = NULL;
+
+        mutexLock(queue.mutex);
+        queue.written++;
+        condBroadcast(queue.space);
+        mutexUnlock(queue.mutex);
+    }
+
+    // On failure stop handing out entries and wake workers waiting on the window.
+    mutexLock(queue.mutex);
+    queue.next = queue.count;
+    condBroadcast(queue.space);
+    mutexUnlock(queue.mutex);
+
+    for (int i = 0; i < jobs; i++) {
+        if (threads[i])
+            threadJoin(threads[i]);
+    }
+
+    if (ok && !mz_zip_writer_finalize_archive(&zip)) {
+        printf("Failed to finalize %s\n", tempPath);
+        ok = false;
+    }
+
+    mz_zip_writer_end(&zip);
+    mz_zip_reader_end(&previous);
+
+    // Only replace the old egg once the new one is complete.
+    if (ok) {
+        remove(output);
+        if (rename(tempPath, output) != 0) {
+            printf("Failed to replace %s\n", output);
+            ok = false;
+        }
+    } else {
+        remove(tempPath);
+    }
+
+    if (ok && !saveManifest(manifestPath, queue.entries, queue.count))
+        printf("Failed to write %s, the next build will start from scratch\n", manifestPath);
+
+    if (!ok)
+        remove(manifestPath);
+
+    if (stats)
+        stats->entries = queue.count;
+
+    for (int i = 0; i < queue.count; i++) {
+        free(queue.entries[i].data);
+        free(queue.entries[i].name);
+    }
+
+    condDestroy(queue.space);
+    condDestroy(queue.ready);
+    mutexDestroy(queue.mutex);
+    free(threads);
+    free(queue.entries);
+
+    unloadManifest(&manifest);
+    UnloadDirectoryFiles(files);
+
+    return ok;
+}
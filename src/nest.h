@@ -0,0 +1,34 @@
+#ifndef NEST_H
+#define NEST_H
+
+#include <stdbool.h>
+
+// Packs a project directory into an egg. Entries are read and compressed on
+// worker threads and written in directory order by the calling thread.
+//
+// A `nest.cfg` file in the project root picks the compression per glob, one
+// rule per line as `<pattern> <0-9|store>`. The last matching rule wins and
+// patterns without a '/' match the file name only:
+//
+//     # Already compressed
+//     *.png store
+//     assets/levels/** 9
+//
+// Builds are incremental: `<output>.cache` records the size, modification
+// time, SHA-256 and level of every entry, and entries that didn't change are
+// copied from the previous egg without being compressed again.
+
+typedef struct {
+    int level; // Default compression level, 0-9
+    int jobs; // Worker threads, 0 for one per CPU
+    bool force; // Ignore the previous build
+} NestOptions;
+
+typedef struct {
+    int entries;
+    int reused; // Entries copied from the previous build
+} NestStats;
+
+bool nestPack(const char* dir, const char* output, const NestOptions* options, NestStats* stats);
+
+#endif
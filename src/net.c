@@ -1,13 +1,38 @@
 #include "api.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <enet/enet.h>
 
 #include "lib/wren/wren.h"
+#include "loopback.h"
+
+#define RTT_BUCKET_COUNT 65
+
+// Per peer slot statistics, reached through peer->data.
+typedef struct {
+    double* channelBytes; // Received and sent payload bytes, two entries per channel
+    size_t channelCount;
+    size_t maxQueueDepth;
+    enet_uint32 rttMin;
+    enet_uint32 rttMax;
+    enet_uint32 rttSamples;
+    enet_uint32 rttBuckets[RTT_BUCKET_COUNT];
+} PeerStats;
+
+typedef struct {
+    ENetHost* enet;
+    PeerStats* peerStats;
+    enet_uint32 lastSample;
+    FILE* dumpFile;
+    enet_uint32 dumpInterval;
+    enet_uint32 lastDump;
+} Host;
 
 void enetClose()
 {
+    loopbackReset();
     enet_deinitialize();
 }
 
@@ -33,17 +58,28 @@ void enetGetVersion(WrenVM* vm)
 void hostAllocate(WrenVM* vm)
 {
     wrenEnsureSlots(vm, 1);
-    wrenSetSlotNewForeign(vm, 0, 0, sizeof(ENetHost*));
+    Host* host = (Host*)wrenSetSlotNewForeign(vm, 0, 0, sizeof(Host));
+    memset(host, 0, sizeof(Host));
 }
 
 void hostFinalize(void* data)
 {
-    ENetHost** host = (ENetHost**)data;
+    Host* host = (Host*)data;
 
-    if (*host)
-        enet_host_destroy(*host);
+    if (host->peerStats) {
+        for (size_t i = 0; i < host->enet->peerCount; i++)
+            free(host->peerStats[i].channelBytes);
 
-    *host = NULL;
+        free(host->peerStats);
+    }
+
+    if (host->dumpFile)
+        fclose(host->dumpFile);
+
+    if (host->enet)
+        enet_host_destroy(host->enet);
+
+    host->enet = NULL;
 }
 
 // Thanks to: https://github.com/leafo/lua-enet
@@ -100,9 +136,152 @@ static void parse_address(WrenVM* vm, const char* addr_str, ENetAddress* address
     }
 }
 
+static void initPeerStats(WrenVM* vm, Host* host)
+{
+    host->peerStats = calloc(host->enet->peerCount, sizeof(PeerStats));
+    if (host->peerStats == NULL) {
+        VM_ABORT(vm, "Failed to allocate peer statistics.");
+        return;
+    }
+
+    for (size_t i = 0; i < host->enet->peerCount; i++)
+        host->enet->peers[i].data = &host->peerStats[i];
+}
+
+static void resetPeerStats(ENetPeer* peer)
+{
+    PeerStats* stats = (PeerStats*)peer->data;
+    if (stats == NULL)
+        return;
+
+    free(stats->channelBytes);
+    memset(stats, 0, sizeof(PeerStats));
+
+    stats->channelBytes = calloc(peer->channelCount * 2, sizeof(double));
+    if (stats->channelBytes)
+        stats->channelCount = peer->channelCount;
+}
+
+static void countBytes(ENetPeer* peer, int channel, size_t length, bool outgoing)
+{
+    PeerStats* stats = (PeerStats*)peer->data;
+    if (stats == NULL || channel >= stats->channelCount)
+        return;
+
+    stats->channelBytes[channel * 2 + (outgoing ? 1 : 0)] += length;
+}
+
+static size_t peerQueueDepth(ENetPeer* peer)
+{
+    return enet_list_size(&peer->outgoingCommands) + enet_list_size(&peer->sentReliableCommands);
+}
+
+// RTT buckets are 4ms wide up to 128ms, 16ms wide up to 640ms, then one overflow bucket.
+static int rttBucket(enet_uint32 rtt)
+{
+    if (rtt < 128)
+        return rtt / 4;
+    if (rtt < 640)
+        return 32 + (rtt - 128) / 16;
+    return RTT_BUCKET_COUNT - 1;
+}
+
+static enet_uint32 rttPercentile(PeerStats* stats, double percentile)
+{
+    if (stats->rttSamples == 0)
+        return 0;
+
+    double target = percentile * stats->rttSamples;
+    enet_uint32 seen = 0;
+
+    for (int i = 0; i < RTT_BUCKET_COUNT - 1; i++) {
+        seen += stats->rttBuckets[i];
+        if (seen >= target) {
+            enet_uint32 edge = i < 32 ? (i + 1) * 4 : 128 + (i - 31) * 16;
+            return edge < stats->rttMax ? edge : stats->rttMax;
+        }
+    }
+
+    return stats->rttMax;
+}
+
+static void dumpStats(Host* host)
+{
+    ENetHost* enet = host->enet;
+
+    for (size_t i = 0; i < enet->peerCount; i++) {
+        ENetPeer* peer = &enet->peers[i];
+        if (peer->state != ENET_PEER_STATE_CONNECTED)
+            continue;
+
+        PeerStats* stats = &host->peerStats[i];
+
+        double bytesIn = 0, bytesOut = 0;
+        for (size_t c = 0; c < stats->channelCount; c++) {
+            bytesIn += stats->channelBytes[c * 2];
+            bytesOut += stats->channelBytes[c * 2 + 1];
+        }
+
+        fprintf(host->dumpFile, "%u,%d,%u,%u,%u,%u,%.4f,%.4f,%d,%.0f,%.0f\n",
+            enet->serviceTime, (int)i, peer->roundTripTime,
+            rttPercentile(stats, 0.5), rttPercentile(stats, 0.9), rttPercentile(stats, 0.99),
+            peer->packetLoss / (double)ENET_PEER_PACKET_LOSS_SCALE,
+            peer->packetThrottle / (double)ENET_PEER_PACKET_THROTTLE_SCALE,
+            (int)peerQueueDepth(peer), bytesIn, bytesOut);
+    }
+
+    fflush(host->dumpFile);
+}
+
+// Called after every service, but peers are only sampled once per ENet tick.
+static void sampleHost(Host* host)
+{
+    ENetHost* enet = host->enet;
+
+    if (host->peerStats == NULL || enet->serviceTime == host->lastSample)
+        return;
+
+    host->lastSample = enet->serviceTime;
+
+    for (size_t i = 0; i < enet->peerCount; i++) {
+        ENetPeer* peer = &enet->peers[i];
+        if (peer->state != ENET_PEER_STATE_CONNECTED)
+            continue;
+
+        PeerStats* stats = &host->peerStats[i];
+
+        size_t depth = peerQueueDepth(peer);
+        if (depth > stats->maxQueueDepth)
+            stats->maxQueueDepth = depth;
+
+        enet_uint32 rtt = peer->lastRoundTripTime;
+        if (stats->rttSamples == 0 || rtt < stats->rttMin)
+            stats->rttMin = rtt;
+        if (rtt > stats->rttMax)
+            stats->rttMax = rtt;
+
+        stats->rttBuckets[rttBucket(rtt)]++;
+        stats->rttSamples++;
+    }
+
+    if (host->dumpFile && enet->serviceTime - host->lastDump >= host->dumpInterval) {
+        host->lastDump = enet->serviceTime;
+        dumpStats(host);
+    }
+}
+
+static void recordEvent(ENetEvent* event)
+{
+    if (event->type == ENET_EVENT_TYPE_CONNECT) {
+        resetPeerStats(event->peer);
+    } else if (event->type == ENET_EVENT_TYPE_RECEIVE) {
+        countBytes(event->peer, event->channelID, event->packet->dataLength, false);
+    }
+}
+
 void hostNew(WrenVM* vm)
 {
-    ENetHost** host = (ENetHost**)wrenGetSlotForeign(vm, 0);
+    Host* host = (Host*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 2, NUM, "peerCount");
     ASSERT_SLOT_TYPE(vm, 3, NUM, "channelCount");
     ASSERT_SLOT_TYPE(vm, 4, NUM, "inBandwidth");
@@ -113,48 +292,66 @@ void hostNew(WrenVM* vm)
     int outBandwidth = (int)wrenGetSlotDouble(vm, 5);
 
     if (wrenGetSlotType(vm, 1) == WREN_TYPE_NULL) {
-        *host = enet_host_create(NULL, peerCount, channelCount, inBandwidth, outBandwidth);
+        host->enet = enet_host_create(NULL, peerCount, channelCount, inBandwidth, outBandwidth);
     } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_STRING) {
         const char* address = wrenGetSlotString(vm, 1);
         ENetAddress addr;
         parse_address(vm, address, &addr);
-        *host = enet_host_create(&addr, peerCount, channelCount, inBandwidth, outBandwidth);
+        host->enet = enet_host_create(&addr, peerCount, channelCount, inBandwidth, outBandwidth);
     } else {
         VM_ABORT(vm, "Invalid address type.");
         return;
     }
 
-    if (*host == NULL) {
+    if (host->enet == NULL) {
         VM_ABORT(vm, "Failed to create ENet host.");
         return;
     }
+
+    initPeerStats(vm, host);
 }
 
 void hostNew2(WrenVM* vm)
 {
-    ENetHost** host = (ENetHost**)wrenGetSlotForeign(vm, 0);
+    Host* host = (Host*)wrenGetSlotForeign(vm, 0);
 
     if (wrenGetSlotType(vm, 1) == WREN_TYPE_NULL) {
-        *host = enet_host_create(NULL, 64, 1, 0, 0);
+        host->enet = enet_host_create(NULL, 64, 1, 0, 0);
     } else if (wrenGetSlotType(vm, 1) == WREN_TYPE_STRING) {
         const char* address = wrenGetSlotString(vm, 1);
         ENetAddress addr;
         parse_address(vm, address, &addr);
-        *host = enet_host_create(&addr, 64, 1, 0, 0);
+        host->enet = enet_host_create(&addr, 64, 1, 0, 0);
     } else {
         VM_ABORT(vm, "Invalid address type.");
         return;
     }
 
-    if (*host == NULL) {
+    if (host->enet == NULL) {
         VM_ABORT(vm, "Failed to create ENet host.");
         return;
     }
+
+    initPeerStats(vm, host);
+}
+
+void hostLoopback(WrenVM* vm)
+{
+    loopbackEnable(true);
+    hostNew(vm);
+    loopbackEnable(false);
+}
+
+void hostLoopback2(WrenVM* vm)
+{
+    loopbackEnable(true);
+    hostNew2(vm);
+    loopbackEnable(false);
 }
 
 void hostConnect(WrenVM* vm)
 {
-    ENetHost** host = (ENetHost**)wrenGetSlotForeign(vm, 0);
+    Host* host = (Host*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, STRING, "address");
     ASSERT_SLOT_TYPE(vm, 2, NUM, "channelCount");
     ASSERT_SLOT_TYPE(vm, 3, NUM, "data");
@@ -165,7 +362,7 @@ void hostConnect(WrenVM* vm)
     ENetAddress addr;
     parse_address(vm, address, &addr);
 
-    ENetPeer* peer = enet_host_connect(*host, &addr, channelCount, data);
+    ENetPeer* peer = enet_host_connect(host->enet, &addr, channelCount, data);
     if (peer == NULL) {
         VM_ABORT(vm, "Failed to connect to ENet host.");
         return;
@@ -232,12 +429,14 @@ static void pushEvent(WrenVM* vm, ENetEvent* event)
 
 void hostService(WrenVM* vm)
 {
-    ENetHost** host = (ENetHost**)wrenGetSlotForeign(vm, 0);
+    Host* host = (Host*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, NUM, "timeout");
     int timeout = (int)wrenGetSlotDouble(vm, 1);
 
     ENetEvent event;
-    int status = enet_host_service(*host, &event, timeout);
+    int status = enet_host_service(host->enet, &event, timeout);
+    sampleHost(host);
+
     if (status == 0) {
         wrenSetSlotNull(vm, 0);
         return;
@@ -246,15 +445,16 @@ void hostService(WrenVM* vm)
         return;
     }
 
+    recordEvent(&event);
     pushEvent(vm, &event);
 }
 
 void hostCheckEvents(WrenVM* vm)
 {
-    ENetHost** host = (ENetHost**)wrenGetSlotForeign(vm, 0);
+    Host* host = (Host*)wrenGetSlotForeign(vm, 0);
 
     ENetEvent event;
-    int status = enet_host_check_events(*host, &event);
+    int status = enet_host_check_events(host->enet, &event);
     if (status == 0) {
         wrenSetSlotNull(vm, 0);
         return;
@@ -263,13 +463,14 @@ void hostCheckEvents(WrenVM* vm)
         return;
     }
 
+    recordEvent(&event);
     pushEvent(vm, &event);
 }
 
 void hostCompressWithRangeCoder(WrenVM* vm)
 {
-    ENetHost** host = (ENetHost**)wrenGetSlotForeign(vm, 0);
-    int result = enet_host_compress_with_range_coder(*host);
+    Host* host = (Host*)wrenGetSlotForeign(vm, 0);
+    int result = enet_host_compress_with_range_coder(host->enet);
 
     if (result == 0) {
         wrenSetSlotBool(vm, 0, true);
@@ -280,13 +481,13 @@ void hostCompressWithRangeCoder(WrenVM* vm)
 
 void hostFlush(WrenVM* vm)
 {
-    ENetHost** host = (ENetHost**)wrenGetSlotForeign(vm, 0);
-    enet_host_flush(*host);
+    Host* host = (Host*)wrenGetSlotForeign(vm, 0);
+    enet_host_flush(host->enet);
 }
 
 void hostBroadcast(WrenVM* vm)
 {
-    ENetHost** host = (ENetHost**)wrenGetSlotForeign(vm, 0);
+    Host* host = (Host*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, STRING, "data");
     ASSERT_SLOT_TYPE(vm, 2, NUM, "channel");
     ASSERT_SLOT_TYPE(vm, 3, STRING, "flag");
@@ -315,22 +516,27 @@ void hostBroadcast(WrenVM* vm)
         return;
     }
 
-    enet_host_broadcast(*host, channel, packet);
+    for (size_t i = 0; i < host->enet->peerCount; i++) {
+        if (host->enet->peers[i].state == ENET_PEER_STATE_CONNECTED)
+            countBytes(&host->enet->peers[i], channel, length, true);
+    }
+
+    enet_host_broadcast(host->enet, channel, packet);
 }
 
 void hostSetBandwidthLimit(WrenVM* vm)
 {
-    ENetHost** host = (ENetHost**)wrenGetSlotForeign(vm, 0);
+    Host* host = (Host*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, NUM, "incoming");
     ASSERT_SLOT_TYPE(vm, 2, NUM, "outgoing");
     int incoming = (int)wrenGetSlotDouble(vm, 1);
     int outgoing = (int)wrenGetSlotDouble(vm, 2);
-    enet_host_bandwidth_limit(*host, incoming, outgoing);
+    enet_host_bandwidth_limit(host->enet, incoming, outgoing);
 }
 
 void hostGetPeer(WrenVM* vm)
 {
-    ENetHost* host = *(ENetHost**)wrenGetSlotForeign(vm, 0);
+    ENetHost* host = ((Host*)wrenGetSlotForeign(vm, 0))->enet;
     ASSERT_SLOT_TYPE(vm, 1, NUM, "index");
     int index = (int)wrenGetSlotDouble(vm, 1);
 
@@ -349,46 +555,75 @@ void hostGetPeer(WrenVM* vm)
 
 void hostGetTotalSent(WrenVM* vm)
 {
-    ENetHost* host = *(ENetHost**)wrenGetSlotForeign(vm, 0);
+    ENetHost* host = ((Host*)wrenGetSlotForeign(vm, 0))->enet;
     wrenSetSlotDouble(vm, 0, host->totalSentData);
 }
 
 void hostGetTotalReceived(WrenVM* vm)
 {
-    ENetHost* host = *(ENetHost**)wrenGetSlotForeign(vm, 0);
+    ENetHost* host = ((Host*)wrenGetSlotForeign(vm, 0))->enet;
     wrenSetSlotDouble(vm, 0, host->totalReceivedData);
 }
 
 void hostGetServiceTime(WrenVM* vm)
 {
-    ENetHost* host = *(ENetHost**)wrenGetSlotForeign(vm, 0);
+    ENetHost* host = ((Host*)wrenGetSlotForeign(vm, 0))->enet;
     wrenSetSlotDouble(vm, 0, host->serviceTime);
 }
 
 void hostGetPeerCount(WrenVM* vm)
 {
-    ENetHost* host = *(ENetHost**)wrenGetSlotForeign(vm, 0);
+    ENetHost* host = ((Host*)wrenGetSlotForeign(vm, 0))->enet;
     wrenSetSlotDouble(vm, 0, host->peerCount);
 }
 
 void hostGetAddress(WrenVM* vm)
 {
-    ENetHost* host = *(ENetHost**)wrenGetSlotForeign(vm, 0);
+    ENetHost* host = ((Host*)wrenGetSlotForeign(vm, 0))->enet;
 
     ENetAddress addr;
-    enet_socket_get_address(host->socket, &addr);
+    loopbackSocketGetAddress(host->socket, &addr);
 
     char address[128];
     sprintf(address, "%d.%d.%d.%d:%d", addr.host & 0xFF, (addr.host >> 8) & 0xFF, (addr.host >> 16) & 0xFF, (addr.host >> 24) & 0xFF, addr.port);
     wrenSetSlotString(vm, 0, address);
 }
 
+void hostDumpStats(WrenVM* vm)
+{
+    Host* host = (Host*)wrenGetSlotForeign(vm, 0);
+    ASSERT_SLOT_TYPE(vm, 2, NUM, "interval");
+    int interval = (int)wrenGetSlotDouble(vm, 2);
+
+    if (host->dumpFile) {
+        fclose(host->dumpFile);
+        host->dumpFile = NULL;
+    }
+
+    if (wrenGetSlotType(vm, 1) == WREN_TYPE_NULL)
+        return;
+
+    ASSERT_SLOT_TYPE(vm, 1, STRING, "path");
+    const char* path = wrenGetSlotString(vm, 1);
+
+    host->dumpFile = fopen(path, "w");
+    if (host->dumpFile == NULL) {
+        VM_ABORT(vm, "Failed to open stats file.");
+        return;
+    }
+
+    fprintf(host->dumpFile, "time,peer,rtt,rttP50,rttP90,rttP99,packetLoss,packetThrottle,queueDepth,bytesIn,bytesOut\n");
+
+    host->dumpInterval = interval < 0 ? 0 : interval;
+    host->lastDump = host->enet->serviceTime;
+}
+
 void hostSetChannelLimit(WrenVM* vm)
 {
-    ENetHost** host = (ENetHost**)wrenGetSlotForeign(vm, 0);
+    Host* host = (Host*)wrenGetSlotForeign(vm, 0);
     ASSERT_SLOT_TYPE(vm, 1, NUM, "limit");
     int limit = (int)wrenGetSlotDouble(vm, 1);
-    enet_host_channel_limit(*host, limit);
+    enet_host_channel_limit(host->enet, limit);
 }
 
 void peerDisconnect(WrenVM* vm)
@@ -458,7 +693,8 @@ void peerSend(WrenVM* vm)
         return;
     }
 
-    enet_peer_send(*peer, channel, packet);
+    if (enet_peer_send(*peer, channel, packet) == 0)
+        countBytes(*peer, channel, length, true);
 }
 
 void peerReceive(WrenVM* vm)
@@ -483,6 +719,7 @@ void peerReceive(WrenVM* vm)
     wrenSetSlotDouble(vm, 2, channel);
     wrenSetMapValue(vm, 0, 1, 2);
 
+    countBytes(*peer, channel, packet->dataLength, false);
     enet_packet_destroy(packet);
 }
 
@@ -607,6 +844,80 @@ void peerGetTimeout(WrenVM* vm)
     wrenSetMapValue(vm, 0, 1, 2);
 }
 
+void peerGetStats(WrenVM* vm)
+{
+    ENetPeer* peer = *(ENetPeer**)wrenGetSlotForeign(vm, 0);
+    PeerStats* stats = (PeerStats*)peer->data;
+
+    if (stats == NULL) {
+        wrenSetSlotNull(vm, 0);
+        return;
+    }
+
+    wrenEnsureSlots(vm, 4);
+    wrenSetSlotNewMap(vm, 0);
+
+    wrenSetSlotString(vm, 1, "packetLoss");
+    wrenSetSlotDouble(vm, 2, peer->packetLoss / (double)ENET_PEER_PACKET_LOSS_SCALE);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "packetThrottle");
+    wrenSetSlotDouble(vm, 2, peer->packetThrottle / (double)ENET_PEER_PACKET_THROTTLE_SCALE);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "queueDepth");
+    wrenSetSlotDouble(vm, 2, peerQueueDepth(peer));
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "maxQueueDepth");
+    wrenSetSlotDouble(vm, 2, stats->maxQueueDepth);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "inTransit");
+    wrenSetSlotDouble(vm, 2, peer->reliableDataInTransit);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "bytesIn");
+    wrenSetSlotNewList(vm, 2);
+    for (size_t i = 0; i < stats->channelCount; i++) {
+        wrenSetSlotDouble(vm, 3, stats->channelBytes[i * 2]);
+        wrenInsertInList(vm, 2, -1, 3);
+    }
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "bytesOut");
+    wrenSetSlotNewList(vm, 2);
+    for (size_t i = 0; i < stats->channelCount; i++) {
+        wrenSetSlotDouble(vm, 3, stats->channelBytes[i * 2 + 1]);
+        wrenInsertInList(vm, 2, -1, 3);
+    }
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "rttMin");
+    wrenSetSlotDouble(vm, 2, stats->rttMin);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "rttMax");
+    wrenSetSlotDouble(vm, 2, stats->rttMax);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "rttP50");
+    wrenSetSlotDouble(vm, 2, rttPercentile(stats, 0.5));
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "rttP90");
+    wrenSetSlotDouble(vm, 2, rttPercentile(stats, 0.9));
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "rttP99");
+    wrenSetSlotDouble(vm, 2, rttPercentile(stats, 0.99));
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "rttSamples");
+    wrenSetSlotDouble(vm, 2, stats->rttSamples);
+    wrenSetMapValue(vm, 0, 1, 2);
+}
+
 void peerGetToString(WrenVM* vm)
 {
     ENetPeer* peer = *(ENetPeer**)wrenGetSlotForeign(vm, 0);
@@ -639,3 +950,96 @@ void peerSetLastRtt(WrenVM* vm)
     int lastRtt = (int)wrenGetSlotDouble(vm, 1);
     peer->lastRoundTripTime = lastRtt;
 }
+
+void loopbackSetLatency(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "latency");
+    int latency = (int)wrenGetSlotDouble(vm, 1);
+    loopbackSettings()->latency = latency < 0 ? 0 : latency;
+}
+
+void loopbackSetJitter(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "jitter");
+    int jitter = (int)wrenGetSlotDouble(vm, 1);
+    loopbackSettings()->jitter = jitter < 0 ? 0 : jitter;
+}
+
+void loopbackSetLoss(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "loss");
+    double loss = wrenGetSlotDouble(vm, 1);
+
+    if (loss < 0 || loss > 1) {
+        VM_ABORT(vm, "Loss must be between 0 and 1.");
+        return;
+    }
+
+    loopbackSettings()->loss = loss;
+}
+
+void loopbackSetBandwidth(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "bandwidth");
+    int bandwidth = (int)wrenGetSlotDouble(vm, 1);
+    loopbackSettings()->bandwidth = bandwidth < 0 ? 0 : bandwidth;
+}
+
+void loopbackSetSeed(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "seed");
+    loopbackSeedRandom((unsigned int)wrenGetSlotDouble(vm, 1));
+}
+
+void loopbackSetDeterministic(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, BOOL, "deterministic");
+    loopbackUseVirtualClock(wrenGetSlotBool(vm, 1));
+}
+
+void loopbackAdvance(WrenVM* vm)
+{
+    ASSERT_SLOT_TYPE(vm, 1, NUM, "ms");
+    int ms = (int)wrenGetSlotDouble(vm, 1);
+
+    if (ms < 0) {
+        VM_ABORT(vm, "Cannot advance time backwards.");
+        return;
+    }
+
+    loopbackAdvanceClock(ms);
+}
+
+void loopbackGetTime(WrenVM* vm)
+{
+    wrenSetSlotDouble(vm, 0, loopbackTimeGet());
+}
+
+void loopbackGetStats(WrenVM* vm)
+{
+    LoopbackStats stats;
+    loopbackReadStats(&stats);
+
+    wrenEnsureSlots(vm, 3);
+    wrenSetSlotNewMap(vm, 0);
+
+    wrenSetSlotString(vm, 1, "sent");
+    wrenSetSlotDouble(vm, 2, stats.sent);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "delivered");
+    wrenSetSlotDouble(vm, 2, stats.delivered);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "dropped");
+    wrenSetSlotDouble(vm, 2, stats.dropped);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "bytes");
+    wrenSetSlotDouble(vm, 2, stats.bytes);
+    wrenSetMapValue(vm, 0, 1, 2);
+
+    wrenSetSlotString(vm, 1, "queued");
+    wrenSetSlotDouble(vm, 2, stats.queued);
+    wrenSetMapValue(vm, 0, 1, 2);
+}
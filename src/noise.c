@@ -0,0 +1,353 @@
+#include "noise.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "pool.h"
+
+#define NOISE_ROWS_PER_JOB 32
+#define NOISE_MIN_PARALLEL (256 * 256) // Smaller grids aren't worth handing to the pool
+#define NOISE_MAX_JOBS 64
+
+static int SEED = 2004;
+
+void setSeed(int seed)
+{
+    SEED = seed;
+}
+
+// Perlin noise from: https://gist.github.com/nowl/828013
+
+static const unsigned char HASH[] = {
+    208, 34, 231, 213, 32, 248, 233, 56, 161, 78, 24, 140, 71, 48, 140, 254, 245, 255, 247, 247, 40,
+    185, 248, 251, 245, 28, 124, 204, 204, 76, 36, 1, 107, 28, 234, 163, 202, 224, 245, 128, 167, 204,
+    9, 92, 217, 54, 239, 174, 173, 102, 193, 189, 190, 121, 100, 108, 167, 44, 43, 77, 180, 204, 8, 81,
+    70, 223, 11, 38, 24, 254, 210, 210, 177, 32, 81, 195, 243, 125, 8, 169, 112, 32, 97, 53, 195, 13,
+    203, 9, 47, 104, 125, 117, 114, 124, 165, 203, 181, 235, 193, 206, 70, 180, 174, 0, 167, 181, 41,
+    164, 30, 116, 127, 198, 245, 146, 87, 224, 149, 206, 57, 4, 192, 210, 65, 210, 129, 240, 178, 105,
+    228, 108, 245, 148, 140, 40, 35, 195, 38, 58, 65, 207, 215, 253, 65, 85, 208, 76, 62, 3, 237, 55, 89,
+    232, 50, 217, 64, 244, 157, 199, 121, 252, 90, 17, 212, 203, 149, 152, 140, 187, 234, 177, 73, 174,
+    193, 100, 192, 143, 97, 53, 145, 135, 19, 103, 13, 90, 135, 151, 199, 91, 239, 247, 33, 39, 145,
+    101, 120, 99, 3, 186, 86, 99, 41, 237, 203, 111, 79, 220, 135, 158, 42, 30, 154, 120, 67, 87, 167,
+    135, 176, 183, 191, 253, 115, 184, 21, 233, 58, 129, 233, 142, 39, 128, 211, 118, 137, 139, 255,
+    114, 20, 218, 113, 154, 27, 127, 246, 250, 1, 8, 198, 250, 209, 92, 222, 173, 21, 88, 102, 219
+};
+
+static int noise2(int x, int y)
+{
+    int yindex = (y + SEED) % 256;
+    if (yindex < 0)
+        yindex += 256;
+
+    int xindex = (HASH[yindex] + x) % 256;
+    if (xindex < 0)
+        xindex += 256;
+
+    const int result = HASH[xindex];
+    return result;
+}
+
+static double lin_inter(double x, double y, double s)
+{
+    return x + s * (y - x);
+}
+
+static double smooth_inter(double x, double y, double s)
+{
+    return lin_inter(x, y, s * s * (3 - 2 * s));
+}
+
+static double noise2d(double x, double y)
+{
+    const int x_int = floor(x);
+    const int y_int = floor(y);
+    const double x_frac = x - x_int;
+    const double y_frac = y - y_int;
+    const int s = noise2(x_int, y_int);
+    const int t = noise2(x_int + 1, y_int);
+    const int u = noise2(x_int, y_int + 1);
+    const int v = noise2(x_int + 1, y_int + 1);
+    const double low = smooth_inter(s, t, x_frac);
+    const double high = smooth_inter(u, v, x_frac);
+    const double result = smooth_inter(low, high, y_frac);
+    return result;
+}
+
+double perlin2d(double x, double y, double freq, int depth)
+{
+    double xa = x * freq;
+    double ya = y * freq;
+    double amp = 1.0;
+    double fin = 0;
+    double div = 0.0;
+
+    for (int i = 0; i < depth; i++) {
+        div += 256 * amp;
+        fin += noise2d(xa, ya) * amp;
+        amp /= 2;
+        xa *= 2;
+        ya *= 2;
+    }
+
+    return fin / div;
+}
+
+// Simplex noise after Stefan Gustavson, "Simplex noise demystified", hashing
+// lattice points through the same seeded table as the value noise.
+
+static const double GRAD3[12][3] = {
+    { 1, 1, 0 }, { -1, 1, 0 }, { 1, -1, 0 }, { -1, -1, 0 },
+    { 1, 0, 1 }, { -1, 0, 1 }, { 1, 0, -1 }, { -1, 0, -1 },
+    { 0, 1, 1 }, { 0, -1, 1 }, { 0, 1, -1 }, { 0, -1, -1 }
+};
+
+static int perm(int i)
+{
+    return HASH[(i + SEED) & 255];
+}
+
+static double corner2d(int gradient, double x, double y)
+{
+    double t = 0.5 - x * x - y * y;
+    if (t < 0)
+        return 0.0;
+
+    t *= t;
+    return t * t * (GRAD3[gradient][0] * x + GRAD3[gradient][1] * y);
+}
+
+static double corner3d(int gradient, double x, double y, double z)
+{
+    double t = 0.6 - x * x - y * y - z * z;
+    if (t < 0)
+        return 0.0;
+
+    t *= t;
+    return t * t * (GRAD3[gradient][0] * x + GRAD3[gradient][1] * y + GRAD3[gradient][2] * z);
+}
+
+double simplex2d(double x, double y)
+{
+    const double F2 = 0.36602540378443865; // (sqrt(3) - 1) / 2
+    const double G2 = 0.21132486540518713; // (3 - sqrt(3)) / 6
+
+    double s = (x + y) * F2;
+    int i = (int)floor(x + s);
+    int j = (int)floor(y + s);
+
+    double t = (i + j) * G2;
+    double x0 = x - (i - t);
+    double y0 = y - (j - t);
+
+    int i1 = x0 > y0 ? 1 : 0;
+    int j1 = x0 > y0 ? 0 : 1;
+
+    double x1 = x0 - i1 + G2;
+    double y1 = y0 - j1 + G2;
+    double x2 = x0 - 1.0 + 2.0 * G2;
+    double y2 = y0 - 1.0 + 2.0 * G2;
+
+    int ii = i & 255;
+    int jj = j & 255;
+
+    double n = corner2d(perm(ii + perm(jj)) % 12, x0, y0)
+        + corner2d(perm(ii + i1 + perm(jj + j1)) % 12, x1, y1)
+        + corner2d(perm(ii + 1 + perm(jj + 1)) % 12, x2, y2);
+
+    return 70.0 * n;
+}
+
+double simplex3d(double x, double y, double z)
+{
+    const double F3 = 1.0 / 3.0;
+    const double G3 = 1.0 / 6.0;
+
+    double s = (x + y + z) * F3;
+    int i = (int)floor(x + s);
+    int j = (int)floor(y + s);
+    int k = (int)floor(z + s);
+
+    double t = (i + j + k) * G3;
+    double x0 = x - (i - t);
+    double y0 = y - (j - t);
+    double z0 = z - (k - t);
+
+    // Which of the six tetrahedra the point is in.
+    int i1, j1, k1, i2, j2, k2;
+    if (x0 >= y0) {
+        if (y0 >= z0) {
+            i1 = 1, j1 = 0, k1 = 0, i2 = 1, j2 = 1, k2 = 0;
+        } else if (x0 >= z0) {
+            i1 = 1, j1 = 0, k1 = 0, i2 = 1, j2 = 0, k2 = 1;
+        } else {
+            i1 = 0, j1 = 0, k1 = 1, i2 = 1, j2 = 0, k2 = 1;
+        }
+    } else {
+        if (y0 < z0) {
+            i1 = 0, j1 = 0, k1 = 1, i2 = 0, j2 = 1, k2 = 1;
+        } else if (x0 < z0) {
+            i1 = 0, j1 = 1, k1 = 0, i2 = 0, j2 = 1, k2 = 1;
+        } else {
+            i1 = 0, j1 = 1, k1 = 0, i2 = 1, j2 = 1, k2 = 0;
+        }
+    }
+
+    double x1 = x0 - i1 + G3, y1 = y0 - j1 + G3, z1 = z0 - k1 + G3;
+    double x2 = x0 - i2 + 2.0 * G3, y2 = y0 - j2 + 2.0 * G3, z2 = z0 - k2 + 2.0 * G3;
+    double x3 = x0 - 1.0 + 3.0 * G3, y3 = y0 - 1.0 + 3.0 * G3, z3 = z0 - 1.0 + 3.0 * G3;
+
+    int ii = i & 255;
+    int jj = j & 255;
+    int kk = k & 255;
+
+    double n = corner3d(perm(ii + perm(jj + perm(kk))) % 12, x0, y0, z0)
+        + corner3d(perm(ii + i1 + perm(jj + j1 + perm(kk + k1))) % 12, x1, y1, z1)
+        + corner3d(perm(ii + i2 + perm(jj + j2 + perm(kk + k2))) % 12, x2, y2, z2)
+        + corner3d(perm(ii + 1 + perm(jj + 1 + perm(kk + 1))) % 12, x3, y3, z3);
+
+    return 32.0 * n;
+}
+
+// Batch value noise. The lattice coordinates and fade weights only depend on
+// the column or the row, so they are computed once per octave rather than per
+// sample, and the rest is done in single precision.
+static void fillValueRows(float* out, double x, double y, int width, int rowStart, int rowEnd, double freq, int depth, int* columns, float* weights)
+{
+    for (int row = rowStart; row < rowEnd; row++)
+        for (int column = 0; column < width; column++)
+            out[(size_t)row * width + column] = 0.0f;
+
+    double scale = freq;
+    float amp = 1.0f;
+    float div = 0.0f;
+
+    for (int octave = 0; octave < depth; octave++) {
+        for (int column = 0; column < width; column++) {
+            double xa = (x + column) * scale;
+            int xInt = (int)floor(xa);
+            float s = (float)(xa - xInt);
+            columns[column] = xInt;
+            weights[column] = s * s * (3 - 2 * s);
+        }
+
+        for (int row = rowStart; row < rowEnd; row++) {
+            double ya = (y + row) * scale;
+            int yInt = (int)floor(ya);
+            float t = (float)(ya - yInt);
+            float yWeight = t * t * (3 - 2 * t);
+
+            int low = HASH[(yInt + SEED) & 255];
+            int high = HASH[(yInt + 1 + SEED) & 255];
+            float* line = &out[(size_t)row * width];
+
+            for (int column = 0; column < width; column++) {
+                int xInt = columns[column];
+                float w = weights[column];
+
+                float s = HASH[(low + xInt) & 255];
+                float t = HASH[(low + xInt + 1) & 255];
+                float u = HASH[(high + xInt) & 255];
+                float v = HASH[(high + xInt + 1) & 255];
+
+                float bottom = s + w * (t - s);
+                float top = u + w * (v - u);
+                line[column] += (bottom + yWeight * (top - bottom)) * amp;
+            }
+        }
+
+        div += 256 * amp;
+        amp /= 2;
+        scale *= 2;
+    }
+
+    for (int row = rowStart; row < rowEnd; row++)
+        for (int column = 0; column < width; column++)
+            out[(size_t)row * width + column] /= div;
+}
+
+static void fillSimplexRows(float* out, bool volume, double x, double y, double z, int width, int rowStart, int rowEnd, double freq, int depth)
+{
+    for (int row = rowStart; row < rowEnd; row++) {
+        for (int column = 0; column < width; column++) {
+            double scale = freq;
+            double amp = 1.0;
+            double sum = 0.0;
+            double div = 0.0;
+
+            for (int octave = 0; octave < depth; octave++) {
+                double xa = (x + column) * scale;
+                double ya = (y + row) * scale;
+                sum += (volume ? simplex3d(xa, ya, z * scale) : simplex2d(xa, ya)) * amp;
+                div += amp;
+                amp /= 2;
+                scale *= 2;
+            }
+
+            out[(size_t)row * width + column] = div > 0 ? (float)((sum / div + 1) * 0.5) : 0.0f;
+        }
+    }
+}
+
+typedef struct {
+    float* out;
+    NoiseType type;
+    double x, y, z;
+    int width;
+    int rowStart, rowEnd;
+    double freq;
+    int depth;
+} NoiseJob;
+
+static void runNoiseJob(void* arg)
+{
+    NoiseJob* job = (NoiseJob*)arg;
+
+    if (job->type == NOISE_VALUE) {
+        int* columns = (int*)malloc(job->width * sizeof(int));
+        float* weights = (float*)malloc(job->width * sizeof(float));
+
+        if (columns && weights)
+            fillValueRows(job->out, job->x, job->y, job->width, job->rowStart, job->rowEnd, job->freq, job->depth, columns, weights);
+
+        free(columns);
+        free(weights);
+    } else {
+        fillSimplexRows(job->out, job->type == NOISE_SIMPLEX_3D, job->x, job->y, job->z, job->width, job->rowStart, job->rowEnd, job->freq, job->depth);
+    }
+}
+
+void fillNoise(float* out, NoiseType type, double x, double y, double z, int width, int height, double freq, int depth)
+{
+    if (width <= 0 || height <= 0)
+        return;
+
+    NoiseJob jobs[NOISE_MAX_JOBS];
+    PoolTask* tasks[NOISE_MAX_JOBS];
+
+    int count = 1;
+    if ((size_t)width * height >= NOISE_MIN_PARALLEL) {
+        count = (height + NOISE_ROWS_PER_JOB - 1) / NOISE_ROWS_PER_JOB;
+        if (count > NOISE_MAX_JOBS)
+            count = NOISE_MAX_JOBS;
+    }
+
+    for (int i = 0; i < count; i++) {
+        jobs[i] = (NoiseJob) { out, type, x, y, z, width, height * i / count, height * (i + 1) / count, freq, depth };
+        tasks[i] = NULL;
+    }
+
+    // The calling thread takes the first slice while the pool works on the rest.
+    for (int i = 1; i < count; i++)
+        tasks[i] = poolSubmit(runNoiseJob, &jobs[i]);
+
+    runNoiseJob(&jobs[0]);
+
+    // Joining from the back takes back slices no worker has reached yet.
+    for (int i = count - 1; i >= 1; i--) {
+        if (tasks[i])
+            poolTaskJoin(tasks[i]);
+        else
+            runNoiseJob(&jobs[i]);
+    }
+}
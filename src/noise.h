@@ -0,0 +1,26 @@
+#ifndef NOISE_H
+#define NOISE_H
+
+// Value noise as used by Graphics.noise, plus simplex noise in two and three
+// dimensions. The fill functions produce whole grids in one call and split
+// large grids across the worker pool.
+
+typedef enum {
+    NOISE_VALUE,
+    NOISE_SIMPLEX,
+    NOISE_SIMPLEX_3D
+} NoiseType;
+
+void setSeed(int seed);
+double perlin2d(double x, double y, double freq, int depth);
+
+// Single simplex samples in [-1, 1].
+double simplex2d(double x, double y);
+double simplex3d(double x, double y, double z);
+
+// Writes width * height samples in [0, 1], row by row, for the grid points
+// (x + column, y + row). Each octave doubles the frequency and halves the
+// amplitude. Only 3D simplex noise uses z, the grid is a slice at that depth.
+void fillNoise(float* out, NoiseType type, double x, double y, double z, int width, int height, double freq, int depth);
+
+#endif
@@ -0,0 +1,136 @@
+#include "pcm.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring.h"
+#include "thread.h"
+
+struct Pcm {
+    AudioStream stream;
+    Ring* ring;
+    size_t frameSize;
+    size_t underruns; // Only written by the audio thread
+    int slot;
+};
+
+static Pcm* slots[PCM_MAX_STREAMS];
+
+// Runs on the audio thread. Whatever the ring can't cover is played as silence.
+static void pull(int slot, void* buffer, unsigned int frames)
+{
+    Pcm* pcm = slots[slot];
+    size_t size = frames * pcm->frameSize;
+    size_t read = ringRead(pcm->ring, buffer, size);
+
+    if (read < size) {
+        memset((unsigned char*)buffer + read, pcm->stream.sampleSize == 8 ? 128 : 0, size - read);
+        atomicStore(&pcm->underruns, pcm->underruns + 1);
+    }
+}
+
+// raylib stream callbacks get no user data, so each slot has its own.
+#define PULL(n)                                            \
+    static void pull##n(void* buffer, unsigned int frames) \
+    {                                                      \
+        pull(n, buffer, frames);                           \
+    }
+
+PULL(0) PULL(1) PULL(2) PULL(3) PULL(4) PULL(5) PULL(6) PULL(7)
+PULL(8) PULL(9) PULL(10) PULL(11) PULL(12) PULL(13) PULL(14) PULL(15)
+PULL(16) PULL(17) PULL(18) PULL(19) PULL(20) PULL(21) PULL(22) PULL(23)
+PULL(24) PULL(25) PULL(26) PULL(27) PULL(28) PULL(29) PULL(30) PULL(31)
+
+static const AudioCallback pullers[PCM_MAX_STREAMS] = {
+    pull0, pull1, pull2, pull3, pull4, pull5, pull6, pull7,
+    pull8, pull9, pull10, pull11, pull12, pull13, pull14, pull15,
+    pull16, pull17, pull18, pull19, pull20, pull21, pull22, pull23,
+    pull24, pull25, pull26, pull27, pull28, pull29, pull30, pull31,
+};
+
+Pcm* pcmCreate(unsigned int sampleRate, unsigned int sampleSize, unsigned int channels, size_t frames)
+{
+    int slot = -1;
+    for (int i = 0; i < PCM_MAX_STREAMS && slot < 0; i++)
+        if (slots[i] == NULL)
+            slot = i;
+
+    if (slot < 0)
+        return NULL;
+
+    Pcm* pcm = (Pcm*)calloc(1, sizeof(Pcm));
+    if (pcm == NULL)
+        return NULL;
+
+    pcm->frameSize = sampleSize / 8 * channels;
+    pcm->slot = slot;
+
+    // The ring rounds up to a power of two, which only ever adds headroom.
+    pcm->ring = ringCreate(frames * pcm->frameSize);
+    if (pcm->ring == NULL) {
+        free(pcm);
+        return NULL;
+    }
+
+    pcm->stream = LoadAudioStream(sampleRate, sampleSize, channels);
+    if (!IsAudioStreamReady(pcm->stream)) {
+        ringDestroy(pcm->ring);
+        free(pcm);
+        return NULL;
+    }
+
+    // The slot is filled before the callback can run, raylib's lock orders the two.
+    slots[slot] = pcm;
+    SetAudioStreamCallback(pcm->stream, pullers[slot]);
+
+    return pcm;
+}
+
+void pcmDestroy(Pcm* pcm)
+{
+    // Unloading takes the stream out of the mix, after that the callback can't run.
+    UnloadAudioStream(pcm->stream);
+    slots[pcm->slot] = NULL;
+
+    ringDestroy(pcm->ring);
+    free(pcm);
+}
+
+AudioStream pcmGetStream(Pcm* pcm)
+{
+    return pcm->stream;
+}
+
+size_t pcmGetFrameSize(Pcm* pcm)
+{
+    return pcm->frameSize;
+}
+
+size_t pcmWrite(Pcm* pcm, const void* data, size_t frames)
+{
+    size_t space = ringSpace(pcm->ring) / pcm->frameSize;
+    if (frames > space)
+        frames = space;
+
+    return ringWrite(pcm->ring, data, frames * pcm->frameSize) / pcm->frameSize;
+}
+
+void pcmClear(Pcm* pcm)
+{
+    ringClear(pcm->ring);
+}
+
+size_t pcmGetQueued(Pcm* pcm)
+{
+    return ringAvailable(pcm->ring) / pcm->frameSize;
+}
+
+size_t pcmGetSpace(Pcm* pcm)
+{
+    return ringSpace(pcm->ring) / pcm->frameSize;
+}
+
+size_t pcmGetUnderruns(Pcm* pcm)
+{
+    return atomicLoad(&pcm->underruns);
+}
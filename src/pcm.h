@@ -0,0 +1,37 @@
+#ifndef PCM_H
+#define PCM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <raylib.h>
+
+// Audio streams fed by the main thread. Frames go into a lock-free ring that
+// the audio thread drains from the stream callback, so writing never blocks
+// and the only latency is what is queued.
+
+#define PCM_MAX_STREAMS 32
+
+typedef struct Pcm Pcm;
+
+// Returns NULL if every stream slot is taken or memory runs out.
+Pcm* pcmCreate(unsigned int sampleRate, unsigned int sampleSize, unsigned int channels, size_t frames);
+void pcmDestroy(Pcm* pcm);
+
+AudioStream pcmGetStream(Pcm* pcm);
+size_t pcmGetFrameSize(Pcm* pcm);
+
+// Queues as many whole frames as fit and returns how many did.
+size_t pcmWrite(Pcm* pcm, const void* data, size_t frames);
+
+// Drops what is queued; frames written afterwards are kept. Safe while the
+// stream plays, and once it is stopped the freed space is writable right away.
+void pcmClear(Pcm* pcm);
+
+size_t pcmGetQueued(Pcm* pcm);
+size_t pcmGetSpace(Pcm* pcm);
+
+// Times the audio thread asked for more frames than were queued.
+size_t pcmGetUnderruns(Pcm* pcm);
+
+#endif
@@ -0,0 +1,594 @@
+#include "pixels.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <raylib.h>
+
+#include "pool.h"
+#include "thread.h"
+
+#define PIXELS_MIN_PARALLEL (256 * 256) // Smaller images aren't worth handing to the pool
+#define PIXELS_ROWS_PER_JOB 32
+#define PIXELS_MAX_JOBS 64
+
+// SSE2 is part of every x86-64 target, so there is no runtime check.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXELS_SSE2
+#include <emmintrin.h>
+#endif
+
+// Exact x / 255 for x up to 255 * 255, rounded.
+#define DIV255(x) ((((x) + 128) + (((x) + 128) >> 8)) >> 8)
+
+typedef struct {
+    void (*fn)(void* arg, int rowStart, int rowEnd);
+    void* arg;
+    int rowStart, rowEnd;
+} RowJob;
+
+static void runRowJob(void* arg)
+{
+    RowJob* job = (RowJob*)arg;
+    job->fn(job->arg, job->rowStart, job->rowEnd);
+}
+
+// Calls fn over slices of rows, in parallel once the image is big enough.
+static void forRows(void (*fn)(void*, int, int), void* arg, int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return;
+
+    RowJob jobs[PIXELS_MAX_JOBS];
+    PoolTask* tasks[PIXELS_MAX_JOBS];
+
+    int count = 1;
+    if ((size_t)width * height >= PIXELS_MIN_PARALLEL) {
+        count = (height + PIXELS_ROWS_PER_JOB - 1) / PIXELS_ROWS_PER_JOB;
+        if (count > PIXELS_MAX_JOBS)
+            count = PIXELS_MAX_JOBS;
+    }
+
+    for (int i = 0; i < count; i++) {
+        jobs[i] = (RowJob) { fn, arg, height * i / count, height * (i + 1) / count };
+        tasks[i] = NULL;
+    }
+
+    // The calling thread takes the first slice while the pool works on the rest.
+    for (int i = 1; i < count; i++)
+        tasks[i] = poolSubmit(runRowJob, &jobs[i]);
+
+    runRowJob(&jobs[0]);
+
+    // Workers take slices in queue order, so joining from the back means the
+    // caller only ever waits on slices that are already running.
+    for (int i = count - 1; i >= 1; i--) {
+        if (tasks[i])
+            poolTaskJoin(tasks[i]);
+        else
+            runRowJob(&jobs[i]);
+    }
+}
+
+static uint8_t toByte(float v)
+{
+    v += 0.5f;
+    return v <= 0.0f ? 0 : (v >= 255.0f ? 255 : (uint8_t)v);
+}
+
+void pixelsFill(uint32_t* pixels, int stride, int width, int height, uint32_t color)
+{
+    for (int y = 0; y < height; y++) {
+        uint32_t* row = &pixels[(size_t)y * stride];
+        int x = 0;
+
+#ifdef PIXELS_SSE2
+        __m128i value = _mm_set1_epi32((int)color);
+        for (; x + 4 <= width; x += 4)
+            _mm_storeu_si128((__m128i*)&row[x], value);
+#endif
+
+        for (; x < width; x++)
+            row[x] = color;
+    }
+}
+
+static uint32_t blendPixel(uint32_t dst, uint32_t src)
+{
+    uint8_t s[4], d[4], out[4];
+    memcpy(s, &src, 4);
+    memcpy(d, &dst, 4);
+
+    int a = s[3];
+    for (int i = 0; i < 3; i++)
+        out[i] = (uint8_t)DIV255(s[i] * a + d[i] * (255 - a));
+    out[3] = (uint8_t)DIV255(a * 255 + d[3] * (255 - a));
+
+    uint32_t result;
+    memcpy(&result, out, 4);
+    return result;
+}
+
+#ifdef PIXELS_SSE2
+// Blends two pixels widened to 16 bits per channel.
+static __m128i blendWide(__m128i dst, __m128i src, __m128i rgbMask, __m128i alphaOne)
+{
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, 0xFF), 0xFF);
+    __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+
+    // The alpha channel keeps the source alpha at full weight, so coverage only grows.
+    __m128i weight = _mm_or_si128(_mm_and_si128(alpha, rgbMask), alphaOne);
+
+    __m128i x = _mm_add_epi16(_mm_mullo_epi16(src, weight), _mm_mullo_epi16(dst, inverse));
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+#endif
+
+void pixelsBlend(uint32_t* dst, int dstStride, const uint32_t* src, int srcStride, int width, int height)
+{
+#ifdef PIXELS_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128i rgbMask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    __m128i alphaOne = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+#endif
+
+    for (int y = 0; y < height; y++) {
+        uint32_t* out = &dst[(size_t)y * dstStride];
+        const uint32_t* in = &src[(size_t)y * srcStride];
+        int x = 0;
+
+#ifdef PIXELS_SSE2
+        for (; x + 4 <= width; x += 4) {
+            __m128i s = _mm_loadu_si128((const __m128i*)&in[x]);
+
+            // Fully transparent runs are common in sprites, skip them outright.
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(s, 24), zero)) == 0xFFFF)
+                continue;
+
+            __m128i d = _mm_loadu_si128((const __m128i*)&out[x]);
+            __m128i low = blendWide(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(s, zero), rgbMask, alphaOne);
+            __m128i high = blendWide(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(s, zero), rgbMask, alphaOne);
+            _mm_storeu_si128((__m128i*)&out[x], _mm_packus_epi16(low, high));
+        }
+#endif
+
+        for (; x < width; x++)
+            out[x] = blendPixel(out[x], in[x]);
+    }
+}
+
+int pixelsReplace(uint32_t* pixels, int count, uint32_t from, uint32_t to)
+{
+    int replaced = 0;
+    int i = 0;
+
+#ifdef PIXELS_SSE2
+    __m128i match = _mm_set1_epi32((int)from);
+    __m128i value = _mm_set1_epi32((int)to);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i*)&pixels[i]);
+        __m128i mask = _mm_cmpeq_epi32(p, match);
+        int bits = _mm_movemask_ps(_mm_castsi128_ps(mask));
+        if (bits == 0)
+            continue;
+
+        _mm_storeu_si128((__m128i*)&pixels[i], _mm_or_si128(_mm_andnot_si128(mask, p), _mm_and_si128(mask, value)));
+        replaced += (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1);
+    }
+#endif
+
+    for (; i < count; i++) {
+        if (pixels[i] == from) {
+            pixels[i] = to;
+            replaced++;
+        }
+    }
+
+    return replaced;
+}
+
+static int clampIndex(int i, int size)
+{
+    return i < 0 ? 0 : (i >= size ? size - 1 : i);
+}
+
+bool pixelsConvolve(uint32_t* pixels, int width, int height, const float* kernel, int size)
+{
+    uint32_t* source = (uint32_t*)malloc((size_t)width * height * sizeof(uint32_t));
+    if (source == NULL)
+        return false;
+
+    memcpy(source, pixels, (size_t)width * height * sizeof(uint32_t));
+    int radius = size / 2;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+#ifdef PIXELS_SSE2
+            // One pixel is four floats, so each tap is a single multiply-add.
+            __m128i zero = _mm_setzero_si128();
+            __m128 sum = _mm_setzero_ps();
+
+            for (int j = 0; j < size; j++) {
+                const uint32_t* row = &source[(size_t)clampIndex(y + j - radius, height) * width];
+
+                for (int i = 0; i < size; i++) {
+                    __m128i p = _mm_cvtsi32_si128((int)row[clampIndex(x + i - radius, width)]);
+                    __m128 channels = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(p, zero), zero));
+                    sum = _mm_add_ps(sum, _mm_mul_ps(channels, _mm_set1_ps(kernel[j * size + i])));
+                }
+            }
+
+            __m128i rounded = _mm_cvtps_epi32(sum);
+            rounded = _mm_packus_epi16(_mm_packs_epi32(rounded, zero), zero);
+            pixels[(size_t)y * width + x] = (uint32_t)_mm_cvtsi128_si32(rounded);
+#else
+            float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+            for (int j = 0; j < size; j++) {
+                const uint32_t* row = &source[(size_t)clampIndex(y + j - radius, height) * width];
+
+                for (int i = 0; i < size; i++) {
+                    uint8_t p[4];
+                    memcpy(p, &row[clampIndex(x + i - radius, width)], 4);
+
+                    float weight = kernel[j * size + i];
+                    for (int c = 0; c < 4; c++)
+                        sum[c] += p[c] * weight;
+                }
+            }
+
+            uint8_t out[4];
+            for (int c = 0; c < 4; c++)
+                out[c] = toByte(sum[c]);
+
+            memcpy(&pixels[(size_t)y * width + x], out, 4);
+#endif
+        }
+    }
+
+    free(source);
+    return true;
+}
+
+typedef struct {
+    uint32_t* pixels;
+    int width;
+} PremultiplyJob;
+
+static void premultiplyRows(void* arg, int rowStart, int rowEnd)
+{
+    PremultiplyJob* job = (PremultiplyJob*)arg;
+    uint8_t* p = (uint8_t*)&job->pixels[(size_t)rowStart * job->width];
+    uint8_t* end = (uint8_t*)&job->pixels[(size_t)rowEnd * job->width];
+
+    for (; p < end; p += 4) {
+        int a = p[3];
+        if (a == 255)
+            continue;
+
+        p[0] = (uint8_t)DIV255(p[0] * a);
+        p[1] = (uint8_t)DIV255(p[1] * a);
+        p[2] = (uint8_t)DIV255(p[2] * a);
+    }
+}
+
+void pixelsPremultiply(uint32_t* pixels, int count)
+{
+    // Treated as one long row split into rows of 1024 pixels, the remainder done separately.
+    int width = 1024;
+    PremultiplyJob job = { pixels, width };
+    forRows(premultiplyRows, &job, width, count / width);
+
+    PremultiplyJob tail = { &pixels[(size_t)(count / width) * width], count % width };
+    premultiplyRows(&tail, 0, 1);
+}
+
+// Source taps and weights for each destination pixel along one axis.
+typedef struct {
+    int taps;
+    int* index;
+    float* weights;
+} Filter;
+
+static bool buildFilter(Filter* filter, int srcSize, int dstSize)
+{
+    float scale = (float)srcSize / dstSize;
+    float radius = scale > 1.0f ? scale : 1.0f;
+
+    filter->taps = (int)ceilf(radius * 2.0f) + 1;
+    filter->index = (int*)calloc((size_t)dstSize * filter->taps, sizeof(int));
+    filter->weights = (float*)calloc((size_t)dstSize * filter->taps, sizeof(float));
+
+    if (filter->index == NULL || filter->weights == NULL) {
+        free(filter->index);
+        free(filter->weights);
+        return false;
+    }
+
+    for (int d = 0; d < dstSize; d++) {
+        float center = (d + 0.5f) * scale - 0.5f;
+        int first = (int)ceilf(center - radius);
+        int last = (int)floorf(center + radius);
+
+        int* index = &filter->index[(size_t)d * filter->taps];
+        float* weights = &filter->weights[(size_t)d * filter->taps];
+        float total = 0.0f;
+        int n = 0;
+
+        for (int s = first; s <= last && n < filter->taps; s++) {
+            float w = 1.0f - fabsf(s - center) / radius;
+            if (w <= 0.0f)
+                continue;
+
+            index[n] = s < 0 ? 0 : (s >= srcSize ? srcSize - 1 : s);
+            weights[n] = w;
+            total += w;
+            n++;
+        }
+
+        // Unused taps keep a zero weight on pixel 0.
+        for (int i = 0; i < n; i++)
+            weights[i] /= total;
+    }
+
+    return true;
+}
+
+typedef struct {
+    const uint8_t* src;
+    uint8_t* dst;
+    int srcWidth, dstWidth;
+    int channels;
+    Filter* filter;
+} ResizeJob;
+
+static void resizeColumns(void* arg, int rowStart, int rowEnd)
+{
+    ResizeJob* job = (ResizeJob*)arg;
+    int channels = job->channels;
+    int taps = job->filter->taps;
+
+    for (int y = rowStart; y < rowEnd; y++) {
+        const uint8_t* in = &job->src[(size_t)y * job->srcWidth * channels];
+        uint8_t* out = &job->dst[(size_t)y * job->dstWidth * channels];
+
+        for (int x = 0; x < job->dstWidth; x++) {
+            const int* index = &job->filter->index[(size_t)x * taps];
+            const float* weights = &job->filter->weights[(size_t)x * taps];
+            float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+            for (int t = 0; t < taps; t++) {
+                const uint8_t* p = &in[index[t] * channels];
+                for (int c = 0; c < channels; c++)
+                    sum[c] += p[c] * weights[t];
+            }
+
+            for (int c = 0; c < channels; c++)
+                out[x * channels + c] = toByte(sum[c]);
+        }
+    }
+}
+
+static void resizeRows(void* arg, int rowStart, int rowEnd)
+{
+    ResizeJob* job = (ResizeJob*)arg;
+    int rowSize = job->dstWidth * job->channels;
+    int taps = job->filter->taps;
+
+    // Whole rows are accumulated at once so the inner loop runs over contiguous memory.
+    float* sum = (float*)malloc(rowSize * sizeof(float));
+    if (sum == NULL)
+        return;
+
+    for (int y = rowStart; y < rowEnd; y++) {
+        const int* index = &job->filter->index[(size_t)y * taps];
+        const float* weights = &job->filter->weights[(size_t)y * taps];
+
+        for (int i = 0; i < rowSize; i++)
+            sum[i] = 0.0f;
+
+        for (int t = 0; t < taps; t++) {
+            const uint8_t* in = &job->src[(size_t)index[t] * rowSize];
+            float w = weights[t];
+            if (w == 0.0f)
+                continue;
+
+            for (int i = 0; i < rowSize; i++)
+                sum[i] += in[i] * w;
+        }
+
+        uint8_t* out = &job->dst[(size_t)y * rowSize];
+        for (int i = 0; i < rowSize; i++)
+            out[i] = toByte(sum[i]);
+    }
+
+    free(sum);
+}
+
+bool pixelsResize(const uint8_t* src, int srcWidth, int srcHeight, uint8_t* dst, int dstWidth, int dstHeight, int channels)
+{
+    Filter columns, rows;
+    if (!buildFilter(&columns, srcWidth, dstWidth))
+        return false;
+
+    if (!buildFilter(&rows, srcHeight, dstHeight)) {
+        free(columns.index);
+        free(columns.weights);
+        return false;
+    }
+
+    // Horizontal pass into an intermediate image, then vertical into dst.
+    uint8_t* temp = (uint8_t*)malloc((size_t)dstWidth * srcHeight * channels);
+    bool ok = temp != NULL;
+
+    if (ok) {
+        ResizeJob horizontal = { src, temp, srcWidth, dstWidth, channels, &columns };
+        forRows(resizeColumns, &horizontal, dstWidth, srcHeight);
+
+        ResizeJob vertical = { temp, dst, dstWidth, dstWidth, channels, &rows };
+        forRows(resizeRows, &vertical, dstWidth, dstHeight);
+    }
+
+    free(temp);
+    free(columns.index);
+    free(columns.weights);
+    free(rows.index);
+    free(rows.weights);
+    return ok;
+}
+
+void pixelsRotatedSize(int width, int height, int degrees, int* rotatedWidth, int* rotatedHeight)
+{
+    // Same bounds as raylib's ImageRotate.
+    float rad = degrees * PI / 180.0f;
+    float s = sinf(rad);
+    float c = cosf(rad);
+
+    *rotatedWidth = (int)(fabsf(width * c) + fabsf(height * s));
+    *rotatedHeight = (int)(fabsf(height * c) + fabsf(width * s));
+}
+
+typedef struct {
+    const uint8_t* src;
+    uint8_t* dst;
+    int srcWidth, srcHeight, dstWidth;
+    int channels;
+    float sin, cos;
+    float centerX, centerY;
+} RotateJob;
+
+static void rotateRows(void* arg, int rowStart, int rowEnd)
+{
+    RotateJob* job = (RotateJob*)arg;
+    int channels = job->channels;
+
+    for (int y = rowStart; y < rowEnd; y++) {
+        uint8_t* out = &job->dst[(size_t)y * job->dstWidth * channels];
+        float dy = y + 0.5f - job->centerY;
+
+        for (int x = 0; x < job->dstWidth; x++) {
+            float dx = x + 0.5f - job->centerX;
+
+            // Inverse rotation back into the source, sampling at pixel centers.
+            float sx = dx * job->cos + dy * job->sin + job->srcWidth / 2.0f - 0.5f;
+            float sy = dy * job->cos - dx * job->sin + job->srcHeight / 2.0f - 0.5f;
+
+            if (sx < -0.5f || sy < -0.5f || sx > job->srcWidth - 0.5f || sy > job->srcHeight - 0.5f) {
+                memset(&out[x * channels], 0, channels);
+                continue;
+            }
+
+            int x0 = (int)floorf(sx), y0 = (int)floorf(sy);
+            float fx = sx - x0, fy = sy - y0;
+            int x1 = x0 + 1, y1 = y0 + 1;
+
+            x0 = x0 < 0 ? 0 : x0;
+            y0 = y0 < 0 ? 0 : y0;
+            x1 = x1 >= job->srcWidth ? job->srcWidth - 1 : x1;
+            y1 = y1 >= job->srcHeight ? job->srcHeight - 1 : y1;
+
+            const uint8_t* p00 = &job->src[((size_t)y0 * job->srcWidth + x0) * channels];
+            const uint8_t* p10 = &job->src[((size_t)y0 * job->srcWidth + x1) * channels];
+            const uint8_t* p01 = &job->src[((size_t)y1 * job->srcWidth + x0) * channels];
+            const uint8_t* p11 = &job->src[((size_t)y1 * job->srcWidth + x1) * channels];
+
+            for (int c = 0; c < channels; c++) {
+                float top = p00[c] + (p10[c] - p00[c]) * fx;
+                float bottom = p01[c] + (p11[c] - p01[c]) * fx;
+                out[x * channels + c] = toByte(top + (bottom - top) * fy);
+            }
+        }
+    }
+}
+
+void pixelsRotate(const uint8_t* src, int srcWidth, int srcHeight, uint8_t* dst, int channels, int degrees)
+{
+    int dstWidth, dstHeight;
+    pixelsRotatedSize(srcWidth, srcHeight, degrees, &dstWidth, &dstHeight);
+
+    float rad = degrees * PI / 180.0f;
+    RotateJob job = { src, dst, srcWidth, srcHeight, dstWidth, channels, sinf(rad), cosf(rad), dstWidth / 2.0f, dstHeight / 2.0f };
+    forRows(rotateRows, &job, dstWidth, dstHeight);
+}
+
+typedef struct {
+    const uint8_t* src;
+    uint8_t* dst;
+    int srcWidth, srcHeight, dstWidth;
+    int channels;
+} HalveJob;
+
+static void halveRows(void* arg, int rowStart, int rowEnd)
+{
+    HalveJob* job = (HalveJob*)arg;
+    int channels = job->channels;
+
+    for (int y = rowStart; y < rowEnd; y++) {
+        int y0 = y * 2 < job->srcHeight ? y * 2 : job->srcHeight - 1;
+        int y1 = y0 + 1 < job->srcHeight ? y0 + 1 : y0;
+        const uint8_t* top = &job->src[(size_t)y0 * job->srcWidth * channels];
+        const uint8_t* bottom = &job->src[(size_t)y1 * job->srcWidth * channels];
+        uint8_t* out = &job->dst[(size_t)y * job->dstWidth * channels];
+
+        for (int x = 0; x < job->dstWidth; x++) {
+            int x0 = x * 2 < job->srcWidth ? x * 2 : job->srcWidth - 1;
+            int x1 = x0 + 1 < job->srcWidth ? x0 + 1 : x0;
+
+            for (int c = 0; c < channels; c++) {
+                int sum = top[x0 * channels + c] + top[x1 * channels + c] + bottom[x0 * channels + c] + bottom[x1 * channels + c];
+                out[x * channels + c] = (uint8_t)((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+void pixelsHalve(const uint8_t* src, int srcWidth, int srcHeight, uint8_t* dst, int channels)
+{
+    int dstWidth = srcWidth / 2 > 0 ? srcWidth / 2 : 1;
+    int dstHeight = srcHeight / 2 > 0 ? srcHeight / 2 : 1;
+
+    HalveJob job = { src, dst, srcWidth, srcHeight, dstWidth, channels };
+    forRows(halveRows, &job, dstWidth, dstHeight);
+}
+
+typedef struct {
+    const uint8_t* src;
+    uint8_t* dst;
+    int srcFormat, dstFormat;
+    int width;
+    size_t failed; // Set by any slice, so written atomically
+} ConvertJob;
+
+// raylib's conversion only works on whole images, so each slice is wrapped as one.
+static void convertRows(void* arg, int rowStart, int rowEnd)
+{
+    ConvertJob* job = (ConvertJob*)arg;
+
+    Image slice = {
+        (void*)&job->src[GetPixelDataSize(job->width, rowStart, job->srcFormat)],
+        job->width, rowEnd - rowStart, 1, job->srcFormat
+    };
+
+    Image copy = ImageCopy(slice);
+    ImageFormat(&copy, job->dstFormat);
+
+    if (copy.data == NULL || copy.format != job->dstFormat)
+        atomicStore(&job->failed, 1);
+    else
+        memcpy(&job->dst[GetPixelDataSize(job->width, rowStart, job->dstFormat)], copy.data, GetPixelDataSize(job->width, rowEnd - rowStart, job->dstFormat));
+
+    UnloadImage(copy);
+}
+
+bool pixelsConvert(const void* src, int srcFormat, void* dst, int dstFormat, int width, int height)
+{
+    if (srcFormat >= PIXELFORMAT_COMPRESSED_DXT1_RGB || dstFormat >= PIXELFORMAT_COMPRESSED_DXT1_RGB)
+        return false;
+
+    ConvertJob job = { (const uint8_t*)src, (uint8_t*)dst, srcFormat, dstFormat, width, 0 };
+    forRows(convertRows, &job, width, height);
+    return atomicLoad(&job.failed) == 0;
+}
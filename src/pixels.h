@@ -0,0 +1,43 @@
+#ifndef PIXELS_H
+#define PIXELS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Bulk operations on 32-bit RGBA pixels, laid out R, G, B, A in memory.
+// Strides are in pixels. Rectangles must already be clipped to the images.
+
+void pixelsFill(uint32_t* pixels, int stride, int width, int height, uint32_t color);
+
+// Draws src over dst using the source alpha.
+void pixelsBlend(uint32_t* dst, int dstStride, const uint32_t* src, int srcStride, int width, int height);
+
+// Returns the number of pixels replaced.
+int pixelsReplace(uint32_t* pixels, int count, uint32_t from, uint32_t to);
+
+// Applies a size by size kernel (size odd) to every channel, clamping at the
+// edges. Returns false if the scratch copy can't be allocated.
+bool pixelsConvolve(uint32_t* pixels, int width, int height, const float* kernel, int size);
+
+void pixelsPremultiply(uint32_t* pixels, int count);
+
+// The functions below take pixels of 1 to 4 8-bit channels and split large
+// images across the worker pool.
+
+// Resamples with a tent filter as wide as the scale, so downscaling averages
+// every source pixel and upscaling is bilinear.
+bool pixelsResize(const uint8_t* src, int srcWidth, int srcHeight, uint8_t* dst, int dstWidth, int dstHeight, int channels);
+
+// Rotates around the center with bilinear sampling into a dst sized by
+// pixelsRotatedSize, leaving the uncovered corners transparent.
+void pixelsRotatedSize(int width, int height, int degrees, int* rotatedWidth, int* rotatedHeight);
+void pixelsRotate(const uint8_t* src, int srcWidth, int srcHeight, uint8_t* dst, int channels, int degrees);
+
+// Box filters into the next mipmap level, max(1, width / 2) by max(1, height / 2).
+void pixelsHalve(const uint8_t* src, int srcWidth, int srcHeight, uint8_t* dst, int channels);
+
+// Converts between raylib's uncompressed pixel formats. Returns false for
+// compressed formats or if memory runs out.
+bool pixelsConvert(const void* src, int srcFormat, void* dst, int dstFormat, int width, int height);
+
+#endif
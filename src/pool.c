@@ -0,0 +1,178 @@
+#include "pool.h"
+
+#include <stdlib.h>
+
+#include "thread.h"
+
+#define POOL_MAX_THREADS 16
+
+struct PoolTask {
+    void (*fn)(void*);
+    void* arg;
+    bool done;
+    PoolTask* next;
+};
+
+static Thread* threads[POOL_MAX_THREADS];
+static int threadCount = 0;
+static Mutex* mutex = NULL;
+static Cond* queued = NULL; // Signaled when a task is added or on shutdown
+static Cond* finished = NULL; // Broadcast when any task is done
+static PoolTask* head = NULL;
+static PoolTask* tail = NULL;
+static bool stopping = false;
+
+static void worker(void* arg)
+{
+    mutexLock(mutex);
+
+    for (;;) {
+        while (head == NULL && !stopping)
+            condWait(queued, mutex);
+
+        if (head == NULL)
+            break;
+
+        PoolTask* task = head;
+        head = task->next;
+        if (head == NULL)
+            tail = NULL;
+
+        mutexUnlock(mutex);
+        task->fn(task->arg);
+        mutexLock(mutex);
+
+        task->done = true;
+        condBroadcast(finished);
+    }
+
+    mutexUnlock(mutex);
+}
+
+static bool poolStart()
+{
+    mutex = mutexCreate();
+    queued = condCreate();
+    finished = condCreate();
+    stopping = false;
+
+    int count = threadCpuCount();
+    if (count > POOL_MAX_THREADS)
+        count = POOL_MAX_THREADS;
+
+    for (int i = 0; i < count; i++) {
+        Thread* thread = threadCreate(worker, NULL);
+        if (thread)
+            threads[threadCount++] = thread;
+    }
+
+    return threadCount > 0;
+}
+
+PoolTask* poolSubmit(void (*fn)(void*), void* arg)
+{
+    if (mutex == NULL && !poolStart()) {
+        poolShutdown();
+        return NULL;
+    }
+
+    PoolTask* task = (PoolTask*)malloc(sizeof(PoolTask));
+    if (task == NULL)
+        return NULL;
+
+    task->fn = fn;
+    task->arg = arg;
+    task->done = false;
+    task->next = NULL;
+
+    mutexLock(mutex);
+
+    if (tail)
+        tail->next = task;
+    else
+        head = task;
+    tail = task;
+
+    condSignal(queued);
+    mutexUnlock(mutex);
+
+    return task;
+}
+
+bool poolTaskDone(PoolTask* task)
+{
+    mutexLock(mutex);
+    bool done = task->done;
+    mutexUnlock(mutex);
+
+    return done;
+}
+
+void poolTaskWait(PoolTask* task)
+{
+    mutexLock(mutex);
+    while (!task->done)
+        condWait(finished, mutex);
+    mutexUnlock(mutex);
+}
+
+void poolTaskFree(PoolTask* task)
+{
+    poolTaskWait(task);
+    free(task);
+}
+
+void poolTaskJoin(PoolTask* task)
+{
+    mutexLock(mutex);
+
+    PoolTask* prev = NULL;
+    PoolTask* queuedTask = head;
+    while (queuedTask && queuedTask != task) {
+        prev = queuedTask;
+        queuedTask = queuedTask->next;
+    }
+
+    if (queuedTask) {
+        if (prev)
+            prev->next = task->next;
+        else
+            head = task->next;
+        if (tail == task)
+            tail = prev;
+
+        mutexUnlock(mutex);
+        task->fn(task->arg);
+    } else {
+        while (!task->done)
+            condWait(finished, mutex);
+        mutexUnlock(mutex);
+    }
+
+    free(task);
+}
+
+void poolShutdown()
+{
+    if (mutex == NULL)
+        return;
+
+    // Workers drain the queue before they exit, so tasks still owned by callers complete.
+    mutexLock(mutex);
+    stopping = true;
+    condBroadcast(queued);
+    mutexUnlock(mutex);
+
+    for (int i = 0; i < threadCount; i++)
+        threadJoin(threads[i]);
+
+    threadCount = 0;
+
+    condDestroy(finished);
+    condDestroy(queued);
+    mutexDestroy(mutex);
+
+    mutex = NULL;
+    queued = NULL;
+    finished = NULL;
+}
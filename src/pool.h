@@ -0,0 +1,24 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdbool.h>
+
+// Shared worker threads for work that shouldn't block the main thread. The
+// threads start with the first submitted task and live until poolShutdown.
+
+typedef struct PoolTask PoolTask;
+
+PoolTask* poolSubmit(void (*fn)(void*), void* arg);
+bool poolTaskDone(PoolTask* task);
+void poolTaskWait(PoolTask* task);
+
+// Waits for the task if it is still running, then frees it. The arg is left to the caller.
+void poolTaskFree(PoolTask* task);
+
+// Like poolTaskFree, but runs the task on the calling thread if no worker has
+// started it yet, so the caller never waits behind unrelated queued work.
+void poolTaskJoin(PoolTask* task);
+
+void poolShutdown();
+
+#endif
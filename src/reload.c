@@ -0,0 +1,292 @@
+#include "reload.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <raylib.h>
+
+#include "bus.h"
+#include "voice.h"
+#include "watch.h"
+
+#define RELOAD_MAX_PATH 512
+
+typedef struct {
+    ReloadType type;
+    void* object; // The foreign object's Texture, Sound, Font or Shader
+    void* source; // Sound an alias was made from
+    char path[RELOAD_MAX_PATH];
+    char path2[RELOAD_MAX_PATH];
+    int size;
+} ReloadAsset;
+
+static Watch* watch = NULL;
+static char root[RELOAD_MAX_PATH]; // Watch paths are relative to this, asset paths to the working directory
+static ReloadAsset* assets = NULL;
+static int assetCount = 0;
+static int assetCapacity = 0;
+static bool scriptChanged = false;
+static char* state = NULL;
+static size_t stateLength = 0;
+
+// Asset paths come from scripts and watch paths from the walk, compare them without "./" prefixes.
+static const char* trimPath(const char* path)
+{
+    while (path[0] == '.' && (path[1] == '/' || path[1] == '\\'))
+        path += 2;
+
+    return path;
+}
+
+static bool samePath(const char* a, const char* b)
+{
+    a = trimPath(a);
+    b = trimPath(b);
+
+    for (; *a && *b; a++, b++) {
+        char ca = *a == '\\' ? '/' : *a;
+        char cb = *b == '\\' ? '/' : *b;
+        if (ca != cb)
+            return false;
+    }
+
+    return *a == *b;
+}
+
+bool reloadWatch(const char* path)
+{
+    // The watch outlives script restarts, the new VM asking again is fine.
+    if (watch)
+        return true;
+
+    if (TextLength(path) >= RELOAD_MAX_PATH)
+        return false;
+
+    watch = watchOpen(path);
+    if (watch == NULL)
+        return false;
+
+    TextCopy(root, path);
+
+    // Relative to the working directory like asset paths, if it is under it.
+    const char* cwd = GetWorkingDirectory();
+    size_t cwdLength = strlen(cwd);
+    if (strncmp(root, cwd, cwdLength) == 0 && root[cwdLength] == '\0')
+        TextCopy(root, ".");
+    else if (strncmp(root, cwd, cwdLength) == 0 && (root[cwdLength] == '/' || root[cwdLength] == '\\'))
+        memmove(root, root + cwdLength + 1, strlen(root + cwdLength + 1) + 1);
+
+    size_t length = strlen(root);
+    while (length > 0 && (root[length - 1] == '/' || root[length - 1] == '\\'))
+        root[--length] = '\0';
+
+    return true;
+}
+
+bool reloadWatching()
+{
+    return watch != NULL;
+}
+
+void reloadShutdown()
+{
+    watchClose(watch);
+    watch = NULL;
+
+    free(assets);
+    assets = NULL;
+    assetCount = 0;
+    assetCapacity = 0;
+
+    free(state);
+    state = NULL;
+    stateLength = 0;
+}
+
+static ReloadAsset* addAsset()
+{
+    if (assetCount == assetCapacity) {
+        int capacity = assetCapacity ? assetCapacity * 2 : 64;
+        ReloadAsset* grown = (ReloadAsset*)realloc(assets, capacity * sizeof(ReloadAsset));
+        if (grown == NULL)
+            return NULL;
+
+        assets = grown;
+        assetCapacity = capacity;
+    }
+
+    return &assets[assetCount++];
+}
+
+void reloadTrack(ReloadType type, void* object, const char* path, const char* path2, int size)
+{
+    if (watch == NULL || path == NULL)
+        return;
+
+    ReloadAsset* asset = addAsset();
+    if (asset == NULL)
+        return;
+
+    asset->type = type;
+    asset->object = object;
+    asset->source = NULL;
+    asset->size = size;
+    TextCopy(asset->path, TextLength(path) < RELOAD_MAX_PATH ? path : "");
+    TextCopy(asset->path2, path2 && TextLength(path2) < RELOAD_MAX_PATH ? path2 : "");
+}
+
+void reloadTrackAlias(void* alias, void* source)
+{
+    if (watch == NULL)
+        return;
+
+    // An alias of an alias shares the samples of the original sound.
+    for (int i = 0; i < assetCount; i++) {
+        if (assets[i].type == RELOAD_SOUND_ALIAS && assets[i].object == source)
+            source = assets[i].source;
+    }
+
+    ReloadAsset* asset = addAsset();
+    if (asset == NULL)
+        return;
+
+    *asset = (ReloadAsset) { RELOAD_SOUND_ALIAS, alias, source, "", "", 0 };
+}
+
+void reloadForget(void* object)
+{
+    // A freed sound also drops its aliases, another sound could be allocated at the same address.
+    for (int i = 0; i < assetCount; i++) {
+        if (assets[i].object == object || assets[i].source == object)
+            assets[i--] = assets[--assetCount];
+    }
+}
+
+// Loads the new version first and only swaps it in if it worked, a half saved file keeps the old one.
+static void reloadAsset(ReloadAsset* asset)
+{
+    switch (asset->type) {
+    case RELOAD_TEXTURE: {
+        Texture texture = LoadTexture(asset->path);
+        if (IsTextureReady(texture)) {
+            UnloadTexture(*(Texture*)asset->object);
+            *(Texture*)asset->object = texture;
+        }
+        break;
+    }
+    case RELOAD_SOUND: {
+        Sound sound = LoadSound(asset->path);
+        if (IsSoundReady(sound)) {
+            Sound* old = (Sound*)asset->object;
+            int bus = busOf(old->stream, BUS_SFX);
+
+            voiceReset(old);
+
+            // Script aliases play the old samples, move them over before those are freed.
+            for (int i = 0; i < assetCount; i++) {
+                if (assets[i].type != RELOAD_SOUND_ALIAS || assets[i].source != old)
+                    continue;
+
+                Sound* alias = (Sound*)assets[i].object;
+                int aliasBus = busOf(alias->stream, bus);
+
+                busDetach(alias->stream);
+                UnloadSoundAlias(*alias);
+                *alias = LoadSoundAlias(sound);
+                busAttach(alias->stream, aliasBus);
+            }
+
+            busDetach(old->stream);
+            UnloadSound(*old);
+            *old = sound;
+            busAttach(sound.stream, bus);
+        }
+        break;
+    }
+    case RELOAD_FONT: {
+        Font font = LoadFontEx(asset->path, asset->size, NULL, 250);
+        if (IsFontReady(font)) {
+            UnloadFont(*(Font*)asset->object);
+            *(Font*)asset->object = font;
+        }
+        break;
+    }
+    case RELOAD_SOUND_ALIAS:
+        break;
+    case RELOAD_SHADER: {
+        Shader shader = LoadShader(asset->path[0] ? asset->path : NULL, asset->path2[0] ? asset->path2 : NULL);
+        if (IsShaderReady(shader)) {
+            UnloadShader(*(Shader*)asset->object);
+            *(Shader*)asset->object = shader;
+        }
+        break;
+    }
+    }
+}
+
+typedef struct {
+    void (*fn)(const char* path, void* user);
+    void* user;
+} Poll;
+
+static void changed(const char* path, void* user)
+{
+    Poll* poll = (Poll*)user;
+
+    if (IsFileExtension(path, ".wren"))
+        scriptChanged = true;
+
+    char full[RELOAD_MAX_PATH * 2];
+    snprintf(full, sizeof(full), "%s/%s", root[0] ? root : ".", path);
+
+    for (int i = 0; i < assetCount; i++) {
+        ReloadAsset* asset = &assets[i];
+        if ((asset->path[0] && samePath(asset->path, full)) || (asset->path2[0] && samePath(asset->path2, full)))
+            reloadAsset(asset);
+    }
+
+    if (poll->fn)
+        poll->fn(path, poll->user);
+}
+
+void reloadPoll(void (*fn)(const char* path, void* user), void* user)
+{
+    if (watch == NULL)
+        return;
+
+    Poll poll = { fn, user };
+    watchPoll(watch, changed, &poll);
+}
+
+bool reloadScriptChanged()
+{
+    bool result = scriptChanged;
+    scriptChanged = false;
+
+    return result;
+}
+
+void reloadSetState(const char* value, size_t length)
+{
+    free(state);
+    state = NULL;
+    stateLength = 0;
+
+    if (value == NULL)
+        return;
+
+    state = (char*)malloc(length + 1);
+    if (state == NULL)
+        return;
+
+    memcpy(state, value, length);
+    state[length] = '\0';
+    stateLength = length;
+}
+
+const char* reloadGetState(size_t* length)
+{
+    *length = stateLength;
+    return state;
+}
@@ -0,0 +1,38 @@
+#ifndef RELOAD_H
+#define RELOAD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Hot reload for development. Once a directory is watched, assets loaded
+// from files are tracked so they can be reloaded in place, keeping the
+// foreign objects scripts hold. Changed scripts are flagged so the runner
+// can restart the VM, and a state string survives the restart.
+
+typedef enum {
+    RELOAD_TEXTURE,
+    RELOAD_SOUND,
+    RELOAD_FONT,
+    RELOAD_SHADER,
+    RELOAD_SOUND_ALIAS
+} ReloadType;
+
+bool reloadWatch(const char* root);
+bool reloadWatching();
+void reloadShutdown();
+
+// path2 is the fragment shader for shaders, size the font size for fonts.
+void reloadTrack(ReloadType type, void* object, const char* path, const char* path2, int size);
+void reloadForget(void* object);
+
+// Aliases share their source's samples, so they are re-aliased when the source reloads.
+void reloadTrackAlias(void* alias, void* source);
+
+// Reloads tracked assets whose files changed, then calls fn with every changed path.
+void reloadPoll(void (*fn)(const char* path, void* user), void* user);
+bool reloadScriptChanged();
+
+void reloadSetState(const char* state, size_t length);
+const char* reloadGetState(size_t* length);
+
+#endif
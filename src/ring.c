@@ -0,0 +1,142 @@
+#include "ring.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "thread.h"
+
+struct Ring {
+    unsigned char* data;
+    size_t mask;
+    size_t head; // Bytes written so far, only moved by the producer
+    size_t tail; // Bytes read so far, moved by whichever side holds the owner
+    size_t drop; // Head when the producer last cleared, the consumer skips up to it
+    size_t owner; // Who may move the tail right now, see RING_FREE
+};
+
+// The consumer owns the tail while it reads. The producer only takes it to apply a clear the
+// consumer hasn't reached, which is what a stopped stream needs before it can be refilled.
+#define RING_FREE 0
+#define RING_READING 1
+#define RING_RECLAIMING 2
+
+// Where the consumer's next read starts once it applies a pending clear. A drop behind the
+// tail is left over from a clear that was already applied.
+static size_t readStart(size_t tail, size_t head, size_t drop)
+{
+    return drop - tail <= head - tail ? drop : tail;
+}
+
+Ring* ringCreate(size_t capacity)
+{
+    size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+
+    Ring* ring = (Ring*)calloc(1, sizeof(Ring));
+    if (ring == NULL)
+        return NULL;
+
+    ring->data = (unsigned char*)malloc(size);
+    if (ring->data == NULL) {
+        free(ring);
+        return NULL;
+    }
+
+    ring->mask = size - 1;
+    return ring;
+}
+
+void ringDestroy(Ring* ring)
+{
+    if (ring == NULL)
+        return;
+
+    free(ring->data);
+    free(ring);
+}
+
+size_t ringCapacity(Ring* ring)
+{
+    return ring->mask + 1;
+}
+
+// Producer side. Frees the space of dropped bytes unless a read is in progress, in which
+// case that read or the next one skips them instead.
+static void reclaim(Ring* ring)
+{
+    size_t tail = atomicLoad(&ring->tail);
+    if (readStart(tail, ring->head, ring->drop) == tail || !atomicCompareExchange(&ring->owner, RING_FREE, RING_RECLAIMING))
+        return;
+
+    // The consumer may have moved the tail before the producer took it.
+    atomicStore(&ring->tail, readStart(atomicLoad(&ring->tail), ring->head, ring->drop));
+    atomicStore(&ring->owner, RING_FREE);
+}
+
+// Indices only grow, so the difference stays right when they wrap around.
+size_t ringWrite(Ring* ring, const void* data, size_t size)
+{
+    reclaim(ring);
+
+    size_t head = ring->head;
+    size_t space = ringCapacity(ring) - (head - atomicLoad(&ring->tail));
+    if (size > space)
+        size = space;
+
+    size_t start = head & ring->mask;
+    size_t first = ringCapacity(ring) - start;
+    if (first > size)
+        first = size;
+
+    memcpy(&ring->data[start], data, first);
+    memcpy(ring->data, (const unsigned char*)data + first, size - first);
+
+    atomicStore(&ring->head, head + size);
+    return size;
+}
+
+size_t ringRead(Ring* ring, void* out, size_t size)
+{
+    // The producer is applying a clear, there is nothing worth playing until it is done.
+    if (!atomicCompareExchange(&ring->owner, RING_FREE, RING_READING))
+        return 0;
+
+    // The drop is loaded first, so the head seen after it is never behind it.
+    size_t drop = atomicLoad(&ring->drop);
+    size_t head = atomicLoad(&ring->head);
+    size_t tail = readStart(ring->tail, head, drop);
+    size_t available = head - tail;
+    if (size > available)
+        size = available;
+
+    size_t start = tail & ring->mask;
+    size_t first = ringCapacity(ring) - start;
+    if (first > size)
+        first = size;
+
+    memcpy(out, &ring->data[start], first);
+    memcpy((unsigned char*)out + first, ring->data, size - first);
+
+    atomicStore(&ring->tail, tail + size);
+    atomicStore(&ring->owner, RING_FREE);
+    return size;
+}
+
+void ringClear(Ring* ring)
+{
+    atomicStore(&ring->drop, ring->head);
+}
+
+size_t ringSpace(Ring* ring)
+{
+    reclaim(ring);
+    return ringCapacity(ring) - (atomicLoad(&ring->head) - atomicLoad(&ring->tail));
+}
+
+size_t ringAvailable(Ring* ring)
+{
+    size_t drop = atomicLoad(&ring->drop);
+    size_t head = atomicLoad(&ring->head);
+    return head - readStart(atomicLoad(&ring->tail), head, drop);
+}
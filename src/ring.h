@@ -0,0 +1,37 @@
+#ifndef RING_H
+#define RING_H
+
+#include <stddef.h>
+
+// Lock-free byte ring for exactly one producer thread and one consumer
+// thread. Each side only moves its own index, publishing it with release
+// ordering, so neither ever blocks the other.
+
+typedef struct Ring Ring;
+
+// Capacity is rounded up to a power of two.
+Ring* ringCreate(size_t capacity);
+void ringDestroy(Ring* ring);
+
+size_t ringCapacity(Ring* ring);
+
+// Producer side. Writes at most size bytes and returns how many fit.
+size_t ringWrite(Ring* ring, const void* data, size_t size);
+
+// Consumer side. Reads at most size bytes and returns how many there were.
+size_t ringRead(Ring* ring, void* out, size_t size);
+
+// Producer side, drops everything written so far; data written after the
+// clear is kept. The consumer skips the bytes at its next read, and the
+// producer frees their space itself at its next write or space check when no
+// read is in progress, so a consumer that has stopped reading can be refilled.
+void ringClear(Ring* ring);
+
+// Producer side, since it may free the space of cleared bytes.
+size_t ringSpace(Ring* ring);
+
+// Either side may ask, leaving out bytes waiting to be dropped. Available only
+// shrinks through the consumer, so it can trust its own answer.
+size_t ringAvailable(Ring* ring);
+
+#endif
@@ -0,0 +1,243 @@
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "thread.h"
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+struct Thread {
+    void (*fn)(void*);
+    void* arg;
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+};
+
+struct Mutex {
+#ifdef _WIN32
+    CRITICAL_SECTION handle;
+#else
+    pthread_mutex_t handle;
+#endif
+};
+
+struct Cond {
+#ifdef _WIN32
+    CONDITION_VARIABLE handle;
+#else
+    pthread_cond_t handle;
+#endif
+};
+
+#ifdef _WIN32
+static DWORD WINAPI threadEntry(LPVOID data)
+{
+    Thread* thread = (Thread*)data;
+    thread->fn(thread->arg);
+    return 0;
+}
+#else
+static void* threadEntry(void* data)
+{
+    Thread* thread = (Thread*)data;
+    thread->fn(thread->arg);
+    return NULL;
+}
+#endif
+
+Thread* threadCreate(void (*fn)(void*), void* arg)
+{
+    Thread* thread = (Thread*)malloc(sizeof(Thread));
+    if (thread == NULL)
+        return NULL;
+
+    thread->fn = fn;
+    thread->arg = arg;
+
+#ifdef _WIN32
+    thread->handle = CreateThread(NULL, 0, threadEntry, thread, 0, NULL);
+    if (thread->handle == NULL) {
+        free(thread);
+        return NULL;
+    }
+#else
+    if (pthread_create(&thread->handle, NULL, threadEntry, thread) != 0) {
+        free(thread);
+        return NULL;
+    }
+#endif
+
+    return thread;
+}
+
+void threadJoin(Thread* thread)
+{
+#ifdef _WIN32
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+
+    free(thread);
+}
+
+void threadSleep(int milliseconds)
+{
+#ifdef _WIN32
+    Sleep((DWORD)milliseconds);
+#else
+    struct timespec duration = { milliseconds / 1000, (long)(milliseconds % 1000) * 1000000 };
+    nanosleep(&duration, NULL);
+#endif
+}
+
+int threadCpuCount()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = (int)info.dwNumberOfProcessors;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    return count > 0 ? count : 1;
+}
+
+Mutex* mutexCreate()
+{
+    Mutex* mutex = (Mutex*)malloc(sizeof(Mutex));
+    if (mutex == NULL)
+        return NULL;
+
+#ifdef _WIN32
+    InitializeCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_init(&mutex->handle, NULL);
+#endif
+
+    return mutex;
+}
+
+void mutexDestroy(Mutex* mutex)
+{
+#ifdef _WIN32
+    DeleteCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_destroy(&mutex->handle);
+#endif
+
+    free(mutex);
+}
+
+void mutexLock(Mutex* mutex)
+{
+#ifdef _WIN32
+    EnterCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_lock(&mutex->handle);
+#endif
+}
+
+void mutexUnlock(Mutex* mutex)
+{
+#ifdef _WIN32
+    LeaveCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_unlock(&mutex->handle);
+#endif
+}
+
+Cond* condCreate()
+{
+    Cond* cond = (Cond*)malloc(sizeof(Cond));
+    if (cond == NULL)
+        return NULL;
+
+#ifdef _WIN32
+    InitializeConditionVariable(&cond->handle);
+#else
+    pthread_cond_init(&cond->handle, NULL);
+#endif
+
+    return cond;
+}
+
+void condDestroy(Cond* cond)
+{
+#ifndef _WIN32
+    pthread_cond_destroy(&cond->handle);
+#endif
+
+    free(cond);
+}
+
+void condWait(Cond* cond, Mutex* mutex)
+{
+#ifdef _WIN32
+    SleepConditionVariableCS(&cond->handle, &mutex->handle, INFINITE);
+#else
+    pthread_cond_wait(&cond->handle, &mutex->handle);
+#endif
+}
+
+void condSignal(Cond* cond)
+{
+#ifdef _WIN32
+    WakeConditionVariable(&cond->handle);
+#else
+    pthread_cond_signal(&cond->handle);
+#endif
+}
+
+void condBroadcast(Cond* cond)
+{
+#ifdef _WIN32
+    WakeAllConditionVariable(&cond->handle);
+#else
+    pthread_cond_broadcast(&cond->handle);
+#endif
+}
+
+size_t atomicLoad(size_t* value)
+{
+#ifdef _WIN32
+    size_t result = *(volatile size_t*)value;
+    MemoryBarrier();
+    return result;
+#else
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+void atomicStore(size_t* value, size_t desired)
+{
+#ifdef _WIN32
+    MemoryBarrier();
+    *(volatile size_t*)value = desired;
+#else
+    __atomic_store_n(value, desired, __ATOMIC_RELEASE);
+#endif
+}
+
+bool atomicCompareExchange(size_t* value, size_t expected, size_t desired)
+{
+#ifdef _WIN32
+    return InterlockedCompareExchangePointer((PVOID volatile*)value, (PVOID)desired, (PVOID)expected) == (PVOID)expected;
+#else
+    return __atomic_compare_exchange_n(value, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
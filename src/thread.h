@@ -0,0 +1,39 @@
+#ifndef THREAD_H
+#define THREAD_H
+
+// Small portable threading layer: pthreads, or the Win32 API on Windows.
+// Handles are opaque so this header can be included next to raylib.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct Thread Thread;
+typedef struct Mutex Mutex;
+typedef struct Cond Cond;
+
+Thread* threadCreate(void (*fn)(void*), void* arg);
+void threadJoin(Thread* thread);
+void threadSleep(int milliseconds);
+int threadCpuCount();
+
+Mutex* mutexCreate();
+void mutexDestroy(Mutex* mutex);
+void mutexLock(Mutex* mutex);
+void mutexUnlock(Mutex* mutex);
+
+Cond* condCreate();
+void condDestroy(Cond* cond);
+void condWait(Cond* cond, Mutex* mutex);
+void condSignal(Cond* cond);
+void condBroadcast(Cond* cond);
+
+// Acquire load and release store, for a value one thread writes and another
+// reads without a mutex.
+size_t atomicLoad(size_t* value);
+void atomicStore(size_t* value, size_t desired);
+
+// Stores desired only if value still holds expected, returning whether it did.
+// Acquires and releases, so it can hand a value back and forth between threads.
+bool atomicCompareExchange(size_t* value, size_t expected, size_t desired);
+
+#endif
@@ -1,12 +1,27 @@
 #include "util.h"
 
-#include <math.h>
 #include <memory.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include <raylib.h>
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define UTIL_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET(features)
+#else
+#include <cpuid.h>
+#define TARGET(features) __attribute__((target(features)))
+#endif
+#endif
+
+#define CPU_SSSE3 1
+#define CPU_SSE41 2
+#define CPU_SHA 4
+
 #define ROTLEFT(a, b) (((a) << (b)) | ((a) >> (32 - (b))))
 #define ROTRIGHT(a, b) (((a) >> (b)) | ((a) << (32 - (b))))
 
@@ -17,7 +32,42 @@
 #define SIG0(x) (ROTRIGHT(x, 7) ^ ROTRIGHT(x, 18) ^ ((x) >> 3))
 #define SIG1(x) (ROTRIGHT(x, 17) ^ ROTRIGHT(x, 19) ^ ((x) >> 10))
 
-static int SEED = 2004;
+// Instruction set extensions the vectorized paths can use, 0 off x86.
+static int cpuFeatures(void)
+{
+    int features = 0;
+
+#if defined(UTIL_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    if (info[2] & (1 << 9))
+        features |= CPU_SSSE3;
+    if (info[2] & (1 << 19))
+        features |= CPU_SSE41;
+
+    if (maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        if (info[1] & (1 << 29))
+            features |= CPU_SHA;
+    }
+#elif defined(UTIL_X86)
+    unsigned int a, b, c, d;
+    if (__get_cpuid(1, &a, &b, &c, &d)) {
+        if (c & (1 << 9))
+            features |= CPU_SSSE3;
+        if (c & (1 << 19))
+            features |= CPU_SSE41;
+    }
+
+    if (__get_cpuid_count(7, 0, &a, &b, &c, &d) && (b & (1 << 29)))
+        features |= CPU_SHA;
+#endif
+
+    return features;
+}
 
 void loadKeys(map_int_t* keys)
 {
@@ -155,91 +205,130 @@ char* readLine()
     return buffer;
 }
 
-void setSeed(int seed)
+// Hex and base64 codecs write into caller provided memory so the API can target a Buffer
+// directly. Encoding has an SSSE3 path, decoding is table driven.
+
+static const char hexchars[] = "0123456789abcdef";
+
+static const char base64chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+#ifdef UTIL_X86
+
+TARGET("ssse3") static size_t hexEncodeSsse3(const unsigned char* src, size_t len, char* dst)
 {
-    SEED = seed;
+    const __m128i digits = _mm_loadu_si128((const __m128i*)hexchars);
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i*)&src[i]);
+        __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(in, mask));
+        _mm_storeu_si128((__m128i*)&dst[i * 2], _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)&dst[i * 2 + 16], _mm_unpackhi_epi8(hi, lo));
+    }
+
+    return i;
 }
 
-// Perlin noise from: https://gist.github.com/nowl/828013
-
-static const unsigned char HASH[] = {
-    208, 34, 231, 213, 32, 248, 233, 56, 161, 78, 24, 140, 71, 48, 140, 254, 245, 255, 247, 247, 40,
-    185, 248, 251, 245, 28, 124, 204, 204, 76, 36, 1, 107, 28, 234, 163, 202, 224, 245, 128, 167, 204,
-    9, 92, 217, 54, 239, 174, 173, 102, 193, 189, 190, 121, 100, 108, 167, 44, 43, 77, 180, 204, 8, 81,
-    70, 223, 11, 38, 24, 254, 210, 210, 177, 32, 81, 195, 243, 125, 8, 169, 112, 32, 97, 53, 195, 13,
-    203, 9, 47, 104, 125, 117, 114, 124, 165, 203, 181, 235, 193, 206, 70, 180, 174, 0, 167, 181, 41,
-    164, 30, 116, 127, 198, 245, 146, 87, 224, 149, 206, 57, 4, 192, 210, 65, 210, 129, 240, 178, 105,
-    228, 108, 245, 148, 140, 40, 35, 195, 38, 58, 65, 207, 215, 253, 65, 85, 208, 76, 62, 3, 237, 55, 89,
-    232, 50, 217, 64, 244, 157, 199, 121, 252, 90, 17, 212, 203, 149, 152, 140, 187, 234, 177, 73, 174,
-    193, 100, 192, 143, 97, 53, 145, 135, 19, 103, 13, 90, 135, 151, 199, 91, 239, 247, 33, 39, 145,
-    101, 120, 99, 3, 186, 86, 99, 41, 237, 203, 111, 79, 220, 135, 158, 42, 30, 154, 120, 67, 87, 167,
-    135, 176, 183, 191, 253, 115, 184, 21, 233, 58, 129, 233, 142, 39, 128, 211, 118, 137, 139, 255,
-    114, 20, 218, 113, 154, 27, 127, 246, 250, 1, 8, 198, 250, 209, 92, 222, 173, 21, 88, 102, 219
-};
+// Base64 in registers, 12 input bytes to 16 characters per step. See Wojciech Muła and
+// Daniel Lemire, "Faster Base64 Encoding and Decoding Using AVX2 Instructions".
+TARGET("ssse3") static size_t base64EncodeSsse3(const unsigned char* src, size_t len, char* dst)
+{
+    const __m128i spread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m128i shift = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    size_t i = 0;
+    size_t j = 0;
+
+    // Loads are 16 bytes wide even though only 12 are used.
+    for (; i + 16 <= len; i += 12, j += 16) {
+        __m128i in = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&src[i]), spread);
+
+        __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        __m128i indices = _mm_or_si128(t0, t1);
 
-static int noise2(int x, int y)
+        __m128i offsets = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        __m128i letters = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        offsets = _mm_or_si128(offsets, _mm_and_si128(letters, _mm_set1_epi8(13)));
+
+        _mm_storeu_si128((__m128i*)&dst[j], _mm_add_epi8(_mm_shuffle_epi8(shift, offsets), indices));
+    }
+
+    return i;
+}
+
+#endif
+
+size_t hexEncode(const unsigned char* src, size_t len, char* dst)
 {
-    int yindex = (y + SEED) % 256;
-    if (yindex < 0)
-        yindex += 256;
+    size_t i = 0;
+
+#ifdef UTIL_X86
+    if (len >= 16 && (cpuFeatures() & CPU_SSSE3))
+        i = hexEncodeSsse3(src, len, dst);
+#endif
 
-    int xindex = (HASH[yindex] + x) % 256;
-    if (xindex < 0)
-        xindex += 256;
+    for (; i < len; i++) {
+        dst[i * 2 + 0] = hexchars[src[i] >> 4];
+        dst[i * 2 + 1] = hexchars[src[i] & 0xF];
+    }
 
-    const int result = HASH[xindex];
-    return result;
+    return len * 2;
 }
 
-static double lin_inter(double x, double y, double s)
+// Returns -1 for anything that isn't a hex digit.
+static int nibble(char c)
 {
-    return x + s * (y - x);
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 0x0a;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 0x0a;
+
+    return -1;
 }
 
-static double smooth_inter(double x, double y, double s)
+static bool hexPrefixed(const char* src, size_t len)
 {
-    return lin_inter(x, y, s * s * (3 - 2 * s));
+    return len >= 2 && src[0] == '0' && (src[1] == 'x' || src[1] == 'X');
 }
 
-static double noise2d(double x, double y)
+size_t hexDecodedSize(const char* src, size_t len)
 {
-    const int x_int = floor(x);
-    const int y_int = floor(y);
-    const double x_frac = x - x_int;
-    const double y_frac = y - y_int;
-    const int s = noise2(x_int, y_int);
-    const int t = noise2(x_int + 1, y_int);
-    const int u = noise2(x_int, y_int + 1);
-    const int v = noise2(x_int + 1, y_int + 1);
-    const double low = smooth_inter(s, t, x_frac);
-    const double high = smooth_inter(u, v, x_frac);
-    const double result = smooth_inter(low, high, y_frac);
-    return result;
+    if (hexPrefixed(src, len))
+        len -= 2;
+
+    return (len + 1) / 2;
 }
 
-double perlin2d(double x, double y, double freq, int depth)
+bool hexDecode(const char* src, size_t len, unsigned char* dst, size_t* dstlen)
 {
-    double xa = x * freq;
-    double ya = y * freq;
-    double amp = 1.0;
-    double fin = 0;
-    double div = 0.0;
-
-    for (int i = 0; i < depth; i++) {
-        div += 256 * amp;
-        fin += noise2d(xa, ya) * amp;
-        amp /= 2;
-        xa *= 2;
-        ya *= 2;
+    size_t size = hexDecodedSize(src, len);
+
+    if (hexPrefixed(src, len)) {
+        src += 2;
+        len -= 2;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        int high = nibble(src[i * 2]);
+        int low = i * 2 + 1 < len ? nibble(src[i * 2 + 1]) : 0;
+
+        if (high < 0 || low < 0)
+            return false;
+
+        dst[i] = (unsigned char)(high << 4 | low);
     }
 
-    return fin / div;
+    *dstlen = size;
+    return true;
 }
 
 // Hex encoding from: https://github.com/love2d/love/blob/main/src/modules/data/DataModule.cpp
 
-static const char hexchars[] = "0123456789abcdef";
-
 char* bytesToHex(const unsigned char* src, size_t srclen, size_t* dstlen)
 {
     *dstlen = srclen * 2;
@@ -252,36 +341,14 @@ char* bytesToHex(const unsigned char* src, size_t srclen, size_t* dstlen)
         return NULL;
     }
 
-    for (size_t i = 0; i < srclen; i++) {
-        unsigned char b = src[i];
-        dst[i * 2 + 0] = hexchars[b >> 4];
-        dst[i * 2 + 1] = hexchars[b & 0xF];
-    }
-
+    hexEncode(src, srclen, dst);
     dst[*dstlen] = '\0';
 
     return dst;
 }
 
-static unsigned char nibble(char c)
-{
-    if (c >= '0' && c <= '9')
-        return (unsigned char)(c - '0');
-    if (c >= 'A' && c <= 'F')
-        return (unsigned char)(c - 'A' + 0x0a);
-    if (c >= 'a' && c <= 'f')
-        return (unsigned char)(c - 'a' + 0x0a);
-
-    return 0;
-}
-
 unsigned char* hexToBytes(const char* src, size_t srclen, size_t* dstlen)
 {
-    if (srclen >= 2 && src[0] == '0' && (src[1] == 'x' || src[1] == 'X')) {
-        src += 2;
-        srclen -= 2;
-    }
-
     *dstlen = (srclen + 1) / 2;
     if (*dstlen == 0)
         return NULL;
@@ -292,16 +359,167 @@ unsigned char* hexToBytes(const char* src, size_t srclen, size_t* dstlen)
         return NULL;
     }
 
-    for (size_t i = 0; i < *dstlen; i++) {
-        dst[i] = nibble(src[i * 2]) << 4;
-
-        if (i * 2 + 1 < srclen)
-            dst[i] |= nibble(src[i * 2 + 1]);
+    if (!hexDecode(src, srclen, dst, dstlen)) {
+        free(dst);
+        return NULL;
     }
 
     return dst;
 }
 
+size_t base64EncodedSize(size_t len)
+{
+    return (len + 2) / 3 * 4;
+}
+
+size_t base64Encode(const unsigned char* src, size_t len, char* dst)
+{
+    size_t i = 0;
+    size_t j = 0;
+
+#ifdef UTIL_X86
+    if (len >= 16 && (cpuFeatures() & CPU_SSSE3)) {
+        i = base64EncodeSsse3(src, len, dst);
+        j = i / 3 * 4;
+    }
+#endif
+
+    for (; i + 3 <= len; i += 3, j += 4) {
+        unsigned int triple = (unsigned int)src[i] << 16 | (unsigned int)src[i + 1] << 8 | src[i + 2];
+        dst[j + 0] = base64chars[(triple >> 18) & 0x3F];
+        dst[j + 1] = base64chars[(triple >> 12) & 0x3F];
+        dst[j + 2] = base64chars[(triple >> 6) & 0x3F];
+        dst[j + 3] = base64chars[triple & 0x3F];
+    }
+
+    if (i < len) {
+        unsigned int triple = (unsigned int)src[i] << 16 | (i + 1 < len ? (unsigned int)src[i + 1] << 8 : 0);
+        dst[j + 0] = base64chars[(triple >> 18) & 0x3F];
+        dst[j + 1] = base64chars[(triple >> 12) & 0x3F];
+        dst[j + 2] = i + 1 < len ? base64chars[(triple >> 6) & 0x3F] : '=';
+        dst[j + 3] = '=';
+        j += 4;
+    }
+
+    return j;
+}
+
+size_t base64DecodedSize(const char* src, size_t len)
+{
+    while (len > 0 && src[len - 1] == '=')
+        len--;
+
+    return len / 4 * 3 + (len % 4 > 1 ? len % 4 - 1 : 0);
+}
+
+// Sextet for each character, -1 if invalid. Accepts the url-safe alphabet too.
+static const signed char base64values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, 62, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, 63,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+bool base64Decode(const char* src, size_t len, unsigned char* dst, size_t* dstlen)
+{
+    // Padding is optional.
+    while (len > 0 && src[len - 1] == '=')
+        len--;
+
+    if (len % 4 == 1)
+        return false;
+
+    const unsigned char* in = (const unsigned char*)src;
+    size_t i = 0;
+    size_t j = 0;
+
+    for (; i + 4 <= len; i += 4, j += 3) {
+        int a = base64values[in[i]], b = base64values[in[i + 1]], c = base64values[in[i + 2]], d = base64values[in[i + 3]];
+        if ((a | b | c | d) < 0)
+            return false;
+
+        unsigned int triple = (unsigned int)a << 18 | (unsigned int)b << 12 | (unsigned int)c << 6 | (unsigned int)d;
+        dst[j + 0] = (unsigned char)(triple >> 16);
+        dst[j + 1] = (unsigned char)(triple >> 8);
+        dst[j + 2] = (unsigned char)triple;
+    }
+
+    if (i < len) {
+        int a = base64values[in[i]], b = base64values[in[i + 1]], c = i + 2 < len ? base64values[in[i + 2]] : 0;
+        if ((a | b | c) < 0)
+            return false;
+
+        unsigned int triple = (unsigned int)a << 18 | (unsigned int)b << 12 | (unsigned int)c << 6;
+        dst[j++] = (unsigned char)(triple >> 16);
+        if (i + 2 < len)
+            dst[j++] = (unsigned char)(triple >> 8);
+    }
+
+    *dstlen = j;
+    return true;
+}
+
+// Glob matching for paths: `*` and `?` stop at '/', `**` crosses directories.
+bool globMatch(const char* pattern, const char* text)
+{
+    while (*pattern) {
+        if (pattern[0] == '*' && pattern[1] == '*') {
+            pattern += 2;
+
+            // "**/" also matches zero directories.
+            if (*pattern == '/' && globMatch(pattern + 1, text))
+                return true;
+
+            for (;;) {
+                if (globMatch(pattern, text))
+                    return true;
+                if (*text == '\0')
+                    return false;
+                text++;
+            }
+        }
+
+        if (*pattern == '*') {
+            pattern++;
+
+            for (;;) {
+                if (globMatch(pattern, text))
+                    return true;
+                if (*text == '\0' || *text == '/')
+                    return false;
+                text++;
+            }
+        }
+
+        if (*text == '\0')
+            return false;
+
+        if (*pattern == '?') {
+            if (*text == '/')
+                return false;
+        } else if (*pattern != *text) {
+            return false;
+        }
+
+        pattern++;
+        text++;
+    }
+
+    return *text == '\0';
+}
+
 // SHA256 from: https://github.com/B-Con/crypto-algorithms/blob/master/sha256.c
 
 static const WORD k[64] = {
@@ -356,6 +574,68 @@ static void sha256_transform(SHA256_CTX* ctx, const BYTE data[])
     ctx->state[7] += h;
 }
 
+#ifdef UTIL_X86
+
+// SHA extensions, four rounds per group with the message schedule kept in registers.
+TARGET("sha,sse4.1") static void sha256_transform_ni(SHA256_CTX* ctx, const BYTE data[], size_t blocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i msg[4];
+
+    // The instructions want the state as ABEF and CDGH.
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&ctx->state[0]), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&ctx->state[4]), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (; blocks > 0; blocks--, data += 64) {
+        __m128i abef = state0;
+        __m128i cdgh = state1;
+
+        for (int i = 0; i < 16; i++) {
+            if (i < 4)
+                msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&data[i * 16]), mask);
+
+            __m128i m = _mm_add_epi32(msg[i & 3], _mm_loadu_si128((const __m128i*)&k[i * 4]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, m);
+
+            if (i >= 3 && i < 15) {
+                tmp = _mm_alignr_epi8(msg[i & 3], msg[(i + 3) & 3], 4);
+                msg[(i + 1) & 3] = _mm_add_epi32(msg[(i + 1) & 3], tmp);
+                msg[(i + 1) & 3] = _mm_sha256msg2_epu32(msg[(i + 1) & 3], msg[i & 3]);
+            }
+
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(m, 0x0E));
+
+            if (i >= 1 && i < 13)
+                msg[(i + 3) & 3] = _mm_sha256msg1_epu32(msg[(i + 3) & 3], msg[i & 3]);
+        }
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    _mm_storeu_si128((__m128i*)&ctx->state[0], _mm_blend_epi16(tmp, state1, 0xF0));
+    _mm_storeu_si128((__m128i*)&ctx->state[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+
+#endif
+
+static void sha256_blocks(SHA256_CTX* ctx, const BYTE data[], size_t blocks)
+{
+#ifdef UTIL_X86
+    if (ctx->accelerated) {
+        sha256_transform_ni(ctx, data, blocks);
+        return;
+    }
+#endif
+
+    for (; blocks > 0; blocks--, data += 64)
+        sha256_transform(ctx, data);
+}
+
 void sha256_init(SHA256_CTX* ctx)
 {
     ctx->datalen = 0;
@@ -368,21 +648,40 @@ void sha256_init(SHA256_CTX* ctx)
     ctx->state[5] = 0x9b05688c;
     ctx->state[6] = 0x1f83d9ab;
     ctx->state[7] = 0x5be0cd19;
+    ctx->accelerated = (cpuFeatures() & (CPU_SHA | CPU_SSE41)) == (CPU_SHA | CPU_SSE41);
 }
 
 void sha256_update(SHA256_CTX* ctx, const BYTE data[], size_t len)
 {
-    WORD i;
+    // Top up a partial block first, then hash whole blocks straight from the input.
+    if (ctx->datalen > 0) {
+        size_t fill = 64 - ctx->datalen;
+        if (fill > len)
+            fill = len;
+
+        memcpy(&ctx->data[ctx->datalen], data, fill);
+        ctx->datalen += (WORD)fill;
+        data += fill;
+        len -= fill;
+
+        if (ctx->datalen < 64)
+            return;
+
+        sha256_blocks(ctx, ctx->data, 1);
+        ctx->bitlen += 512;
+        ctx->datalen = 0;
+    }
 
-    for (i = 0; i < len; ++i) {
-        ctx->data[ctx->datalen] = data[i];
-        ctx->datalen++;
-        if (ctx->datalen == 64) {
-            sha256_transform(ctx, ctx->data);
-            ctx->bitlen += 512;
-            ctx->datalen = 0;
-        }
+    size_t blocks = len / 64;
+    if (blocks > 0) {
+        sha256_blocks(ctx, data, blocks);
+        ctx->bitlen += (unsigned long long)blocks * 512;
+        data += blocks * 64;
+        len -= blocks * 64;
     }
+
+    memcpy(ctx->data, data, len);
+    ctx->datalen = (WORD)len;
 }
 
 void sha256_final(SHA256_CTX* ctx, BYTE hash[])
@@ -399,7 +698,7 @@ void sha256_final(SHA256_CTX* ctx, BYTE hash[])
         ctx->data[i++] = 0x80;
         while (i < 64)
             ctx->data[i++] = 0x00;
-        sha256_transform(ctx, ctx->data);
+        sha256_blocks(ctx, ctx->data, 1);
         memset(ctx->data, 0, 56);
     }
 
@@ -412,7 +711,7 @@ void sha256_final(SHA256_CTX* ctx, BYTE hash[])
     ctx->data[58] = ctx->bitlen >> 40;
     ctx->data[57] = ctx->bitlen >> 48;
     ctx->data[56] = ctx->bitlen >> 56;
-    sha256_transform(ctx, ctx->data);
+    sha256_blocks(ctx, ctx->data, 1);
 
     for (i = 0; i < 4; ++i) {
         hash[i] = (ctx->state[0] >> (24 - i * 8)) & 0x000000ff;
@@ -425,3 +724,95 @@ void sha256_final(SHA256_CTX* ctx, BYTE hash[])
         hash[i + 28] = (ctx->state[7] >> (24 - i * 8)) & 0x000000ff;
     }
 }
+
+// 64-bit non-cryptographic hash, after wyhash (https://github.com/wangyi-fudan/wyhash).
+
+static void hashMultiply(uint64_t* a, uint64_t* b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    *a = _umul128(*a, *b, b);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static uint64_t hashMix(uint64_t a, uint64_t b)
+{
+    hashMultiply(&a, &b);
+    return a ^ b;
+}
+
+static uint64_t hashRead8(const unsigned char* p)
+{
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24
+        | (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 | (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+
+static uint64_t hashRead4(const unsigned char* p)
+{
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24;
+}
+
+static const uint64_t hashSecret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+uint64_t hash64(const void* data, size_t len, uint64_t seed)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    const uint64_t* secret = hashSecret;
+    uint64_t a, b;
+
+    seed ^= hashMix(seed ^ secret[0], secret[1]);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (hashRead4(p) << 32) | hashRead4(p + ((len >> 3) << 2));
+            b = (hashRead4(p + len - 4) << 32) | hashRead4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = hashMix(hashRead8(p) ^ secret[1], hashRead8(p + 8) ^ seed);
+                see1 = hashMix(hashRead8(p + 16) ^ secret[2], hashRead8(p + 24) ^ see1);
+                see2 = hashMix(hashRead8(p + 32) ^ secret[3], hashRead8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+
+        while (i > 16) {
+            seed = hashMix(hashRead8(p) ^ secret[1], hashRead8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+
+        a = hashRead8(p + i - 16);
+        b = hashRead8(p + i - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    hashMultiply(&a, &b);
+    return hashMix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
@@ -1,7 +1,9 @@
 #ifndef UTIL_H
 #define UTIL_H
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "lib/map/map.h"
 
@@ -15,16 +17,24 @@ typedef struct {
     WORD datalen;
     unsigned long long bitlen;
     WORD state[8];
+    bool accelerated;
 } SHA256_CTX;
 
 void loadKeys(map_int_t* keys);
 char* readLine();
-void setSeed(int seed);
-double perlin2d(double x, double y, double freq, int depth);
+size_t hexEncode(const unsigned char* src, size_t len, char* dst);
+size_t hexDecodedSize(const char* src, size_t len);
+bool hexDecode(const char* src, size_t len, unsigned char* dst, size_t* dstlen);
 char* bytesToHex(const unsigned char* src, size_t srclen, size_t* dstlen);
 unsigned char* hexToBytes(const char* src, size_t srclen, size_t* dstlen);
+size_t base64EncodedSize(size_t len);
+size_t base64Encode(const unsigned char* src, size_t len, char* dst);
+size_t base64DecodedSize(const char* src, size_t len);
+bool base64Decode(const char* src, size_t len, unsigned char* dst, size_t* dstlen);
+bool globMatch(const char* pattern, const char* text);
 void sha256_init(SHA256_CTX* ctx);
 void sha256_update(SHA256_CTX* ctx, const BYTE data[], size_t len);
 void sha256_final(SHA256_CTX* ctx, BYTE hash[]);
+uint64_t hash64(const void* data, size_t len, uint64_t seed);
 
 #endif
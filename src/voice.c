@@ -0,0 +1,231 @@
+#include "voice.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "bus.h"
+
+typedef struct {
+    Sound alias;
+    uint64_t started; // Play order, for stealing the oldest
+    int priority;
+} Voice;
+
+typedef struct {
+    Sound* sound;
+    Voice* voices; // NULL until the first play after a reset
+    int size;
+} VoicePool;
+
+static VoicePool* pools = NULL;
+static int poolCount = 0;
+static int poolCapacity = 0;
+static int voiceLimit = VOICE_DEFAULT_LIMIT;
+static uint64_t sequence = 0;
+
+static VoicePool* findPool(Sound* sound)
+{
+    for (int i = 0; i < poolCount; i++)
+        if (pools[i].sound == sound)
+            return &pools[i];
+
+    return NULL;
+}
+
+static VoicePool* addPool(Sound* sound, int size)
+{
+    if (poolCount == poolCapacity) {
+        int capacity = poolCapacity > 0 ? poolCapacity * 2 : 16;
+        VoicePool* grown = (VoicePool*)realloc(pools, capacity * sizeof(VoicePool));
+        if (grown == NULL)
+            return NULL;
+
+        pools = grown;
+        poolCapacity = capacity;
+    }
+
+    VoicePool* pool = &pools[poolCount++];
+    pool->sound = sound;
+    pool->voices = NULL;
+    pool->size = size;
+    return pool;
+}
+
+static bool allocateVoices(VoicePool* pool)
+{
+    pool->voices = (Voice*)calloc(pool->size, sizeof(Voice));
+    if (pool->voices == NULL)
+        return false;
+
+    int bus = busOf(pool->sound->stream, BUS_SFX);
+
+    for (int i = 0; i < pool->size; i++) {
+        pool->voices[i].alias = LoadSoundAlias(*pool->sound);
+        busAttach(pool->voices[i].alias.stream, bus);
+    }
+
+    return true;
+}
+
+static void freeVoices(VoicePool* pool)
+{
+    if (pool->voices == NULL)
+        return;
+
+    for (int i = 0; i < pool->size; i++) {
+        StopSound(pool->voices[i].alias);
+        busDetach(pool->voices[i].alias.stream);
+        UnloadSoundAlias(pool->voices[i].alias);
+    }
+
+    free(pool->voices);
+    pool->voices = NULL;
+}
+
+// Lower priority loses, then the one that started first.
+static bool weaker(Voice* voice, Voice* than)
+{
+    if (than == NULL)
+        return true;
+    if (voice->priority != than->priority)
+        return voice->priority < than->priority;
+
+    return voice->started < than->started;
+}
+
+bool voicePlay(Sound* sound, float volume, float pitch, float pan, int priority)
+{
+    VoicePool* pool = findPool(sound);
+    if (pool == NULL)
+        pool = addPool(sound, VOICE_DEFAULT_POOL);
+    if (pool == NULL || (pool->voices == NULL && !allocateVoices(pool)))
+        return false;
+
+    // One pass over every voice: how many play, the weakest of them, and a slot in this pool.
+    int active = 0;
+    Voice* weakest = NULL;
+    Voice* idle = NULL;
+    Voice* weakestOwn = NULL;
+
+    for (int i = 0; i < poolCount; i++) {
+        VoicePool* other = &pools[i];
+        if (other->voices == NULL)
+            continue;
+
+        for (int j = 0; j < other->size; j++) {
+            Voice* voice = &other->voices[j];
+
+            if (!IsSoundPlaying(voice->alias)) {
+                if (other == pool && idle == NULL)
+                    idle = voice;
+                continue;
+            }
+
+            active++;
+            if (weaker(voice, weakest))
+                weakest = voice;
+            if (other == pool && weaker(voice, weakestOwn))
+                weakestOwn = voice;
+        }
+    }
+
+    Voice* voice = idle;
+
+    if (voice == NULL) {
+        // Pool is full, take over its weakest voice. The active count stays the same.
+        if (weakestOwn == NULL || weakestOwn->priority > priority)
+            return false;
+
+        voice = weakestOwn;
+    } else if (active >= voiceLimit) {
+        if (weakest == NULL || weakest->priority > priority)
+            return false;
+
+        StopSound(weakest->alias);
+    }
+
+    SetSoundVolume(voice->alias, volume);
+    SetSoundPitch(voice->alias, pitch);
+    SetSoundPan(voice->alias, pan);
+    PlaySound(voice->alias);
+
+    voice->started = ++sequence;
+    voice->priority = priority;
+
+    return true;
+}
+
+void voiceStop(Sound* sound)
+{
+    VoicePool* pool = findPool(sound);
+    if (pool == NULL || pool->voices == NULL)
+        return;
+
+    for (int i = 0; i < pool->size; i++)
+        StopSound(pool->voices[i].alias);
+}
+
+bool voiceSetPoolSize(Sound* sound, int size)
+{
+    VoicePool* pool = findPool(sound);
+
+    if (pool == NULL) {
+        pool = addPool(sound, size);
+        if (pool == NULL)
+            return false;
+    } else {
+        freeVoices(pool);
+        pool->size = size;
+    }
+
+    return allocateVoices(pool);
+}
+
+void voiceReset(Sound* sound)
+{
+    VoicePool* pool = findPool(sound);
+    if (pool)
+        freeVoices(pool);
+}
+
+void voiceRelease(Sound* sound)
+{
+    VoicePool* pool = findPool(sound);
+    if (pool == NULL)
+        return;
+
+    freeVoices(pool);
+    *pool = pools[--poolCount];
+
+    if (poolCount == 0) {
+        free(pools);
+        pools = NULL;
+        poolCapacity = 0;
+    }
+}
+
+int voiceGetLimit()
+{
+    return voiceLimit;
+}
+
+void voiceSetLimit(int limit)
+{
+    voiceLimit = limit;
+}
+
+int voiceGetActive()
+{
+    int active = 0;
+
+    for (int i = 0; i < poolCount; i++) {
+        if (pools[i].voices == NULL)
+            continue;
+
+        for (int j = 0; j < pools[i].size; j++)
+            if (IsSoundPlaying(pools[i].voices[j].alias))
+                active++;
+    }
+
+    return active;
+}
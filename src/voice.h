@@ -0,0 +1,30 @@
+#ifndef VOICE_H
+#define VOICE_H
+
+#include <stdbool.h>
+
+#include <raylib.h>
+
+// Polyphonic one-shots: each sound gets a pool of aliases sharing its samples,
+// allocated on first use. When the pool or the global voice limit is full the
+// lowest priority voice is stolen, the oldest one among equals.
+
+#define VOICE_DEFAULT_POOL 8
+#define VOICE_DEFAULT_LIMIT 64
+
+// Returns false if every candidate voice has a higher priority.
+bool voicePlay(Sound* sound, float volume, float pitch, float pan, int priority);
+void voiceStop(Sound* sound);
+bool voiceSetPoolSize(Sound* sound, int size);
+
+// Unloads the aliases, they are recreated on the next play. Call before the sound data changes.
+void voiceReset(Sound* sound);
+
+// Forgets the sound entirely, call before unloading it.
+void voiceRelease(Sound* sound);
+
+int voiceGetLimit();
+void voiceSetLimit(int limit);
+int voiceGetActive();
+
+#endif
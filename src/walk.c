@@ -0,0 +1,171 @@
+#if defined(__linux__)
+#define _GNU_SOURCE
+#elif !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "walk.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define WALK_MAX_PATH 4096
+
+// The path buffer is shared by the whole walk, each level appends its name and truncates on the way out.
+typedef struct {
+    char path[WALK_MAX_PATH];
+    size_t rootLength;
+    bool recursive;
+    WalkFn fn;
+    void* user;
+} Walk;
+
+static bool isDots(const char* name)
+{
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+#ifdef _WIN32
+static void walkLevel(Walk* walk, size_t length)
+{
+    if (length + 3 >= WALK_MAX_PATH)
+        return;
+
+    memcpy(walk->path + length, "/*", 3);
+
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileExA(walk->path, FindExInfoBasic, &data, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    walk->path[length] = '\0';
+
+    if (find == INVALID_HANDLE_VALUE)
+        return;
+
+    do {
+        if (isDots(data.cFileName))
+            continue;
+
+        size_t nameLength = strlen(data.cFileName);
+        if (length + 1 + nameLength >= WALK_MAX_PATH)
+            continue;
+
+        walk->path[length] = '/';
+        memcpy(walk->path + length + 1, data.cFileName, nameLength + 1);
+
+        // FILETIME counts 100ns intervals since 1601.
+        uint64_t time = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+
+        WalkEntry entry;
+        entry.path = walk->path;
+        entry.relative = walk->path + walk->rootLength + 1;
+        entry.directory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        entry.size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        entry.modified = (int64_t)(time / 10000000ULL) - 11644473600LL;
+
+        bool reparse = (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+
+        if (walk->fn(&entry, walk->user) && entry.directory && walk->recursive && !reparse)
+            walkLevel(walk, length + 1 + nameLength);
+
+        walk->path[length] = '\0';
+    } while (FindNextFileA(find, &data));
+
+    FindClose(find);
+}
+#else
+static void walkLevel(Walk* walk, size_t length)
+{
+    DIR* dir = opendir(walk->path);
+    if (dir == NULL)
+        return;
+
+    int fd = dirfd(dir);
+
+    struct dirent* item;
+    while ((item = readdir(dir)) != NULL) {
+        if (isDots(item->d_name))
+            continue;
+
+        size_t nameLength = strlen(item->d_name);
+        if (length + 1 + nameLength >= WALK_MAX_PATH)
+            continue;
+
+        // Stat relative to the open directory, so the kernel doesn't resolve the whole path again.
+        struct stat st;
+        if (fstatat(fd, item->d_name, &st, 0) != 0)
+            continue;
+
+        walk->path[length] = '/';
+        memcpy(walk->path + length + 1, item->d_name, nameLength + 1);
+
+        WalkEntry entry;
+        entry.path = walk->path;
+        entry.relative = walk->path + walk->rootLength + 1;
+        entry.directory = S_ISDIR(st.st_mode);
+        entry.size = entry.directory ? 0 : (uint64_t)st.st_size;
+        entry.modified = (int64_t)st.st_mtime;
+
+        // Symlinked directories are listed but not followed, so links can't send the walk in circles.
+        bool link = false;
+#ifdef DT_LNK
+        if (item->d_type == DT_LNK)
+            link = true;
+        else if (item->d_type == DT_UNKNOWN)
+#endif
+        {
+            struct stat lst;
+            link = fstatat(fd, item->d_name, &lst, AT_SYMLINK_NOFOLLOW) == 0 && S_ISLNK(lst.st_mode);
+        }
+
+        if (walk->fn(&entry, walk->user) && entry.directory && walk->recursive && !link)
+            walkLevel(walk, length + 1 + nameLength);
+
+        walk->path[length] = '\0';
+    }
+
+    closedir(dir);
+}
+#endif
+
+bool walkDirectory(const char* root, bool recursive, WalkFn fn, void* user)
+{
+    Walk walk;
+
+    size_t length = strlen(root);
+    while (length > 1 && (root[length - 1] == '/' || root[length - 1] == '\\'))
+        length--;
+
+    if (length >= WALK_MAX_PATH)
+        return false;
+
+    memcpy(walk.path, root, length);
+    walk.path[length] = '\0';
+
+    walk.rootLength = length;
+    walk.recursive = recursive;
+    walk.fn = fn;
+    walk.user = user;
+
+#ifdef _WIN32
+    DWORD attributes = GetFileAttributesA(walk.path);
+    if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY))
+        return false;
+#else
+    struct stat st;
+    if (stat(walk.path, &st) != 0 || !S_ISDIR(st.st_mode))
+        return false;
+#endif
+
+    walkLevel(&walk, length);
+
+    return true;
+}
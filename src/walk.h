@@ -0,0 +1,23 @@
+#ifndef WALK_H
+#define WALK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Directory traversal that reports type, size and modification time from
+// the same pass that lists the entries, instead of a stat call per path.
+
+typedef struct {
+    const char* path; // Root joined with the relative path
+    const char* relative; // Path below the root, always with '/' separators
+    bool directory;
+    uint64_t size;
+    int64_t modified; // Seconds since the epoch
+} WalkEntry;
+
+// Return false to skip descending into a directory entry.
+typedef bool (*WalkFn)(const WalkEntry* entry, void* user);
+
+bool walkDirectory(const char* root, bool recursive, WalkFn fn, void* user);
+
+#endif
@@ -0,0 +1,245 @@
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "watch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "lib/map/map.h"
+
+#include "walk.h"
+
+#define WATCH_MAX_PATH 4096
+
+struct Watch {
+    char root[WATCH_MAX_PATH];
+    map_double_t times; // Polling: relative path to last seen modification time
+    time_t lastScan;
+    map_int_t changed; // Paths reported by the current poll, to drop duplicates
+#ifdef __linux__
+    int fd; // inotify instance, -1 when polling
+    char** dirs; // Watch descriptor to directory relative to the root
+    int dirCount;
+#endif
+};
+
+static void report(Watch* watch, const char* path, WatchFn fn, void* user)
+{
+    if (map_get(&watch->changed, path))
+        return;
+
+    map_set(&watch->changed, path, 1);
+    fn(path, user);
+}
+
+static void clearChanged(Watch* watch)
+{
+    map_deinit(&watch->changed);
+    map_init(&watch->changed);
+}
+
+// Polling fallback
+
+typedef struct {
+    Watch* watch;
+    WatchFn fn;
+    void* user;
+} Scan;
+
+static bool scanEntry(const WalkEntry* entry, void* user)
+{
+    Scan* scan = (Scan*)user;
+    if (entry->directory)
+        return true;
+
+    double modified = (double)entry->modified;
+    double* last = map_get(&scan->watch->times, entry->relative);
+
+    if (last == NULL || *last != modified) {
+        map_set(&scan->watch->times, entry->relative, modified);
+        if (scan->fn)
+            report(scan->watch, entry->relative, scan->fn, scan->user);
+    }
+
+    return true;
+}
+
+static void rescan(Watch* watch, WatchFn fn, void* user)
+{
+    Scan scan = { watch, fn, user };
+    walkDirectory(watch->root, true, scanEntry, &scan);
+    watch->lastScan = time(NULL);
+}
+
+// inotify
+
+#ifdef __linux__
+#define WATCH_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE)
+
+static void addDirectory(Watch* watch, const char* relative)
+{
+    char path[WATCH_MAX_PATH];
+    if (relative[0])
+        snprintf(path, sizeof(path), "%s/%s", watch->root, relative);
+    else
+        snprintf(path, sizeof(path), "%s", watch->root);
+
+    int wd = inotify_add_watch(watch->fd, path, WATCH_EVENTS);
+    if (wd < 0)
+        return;
+
+    if (wd >= watch->dirCount) {
+        int count = wd + 16;
+        char** dirs = (char**)realloc(watch->dirs, count * sizeof(char*));
+        if (dirs == NULL)
+            return;
+
+        memset(dirs + watch->dirCount, 0, (count - watch->dirCount) * sizeof(char*));
+        watch->dirs = dirs;
+        watch->dirCount = count;
+    }
+
+    size_t length = strlen(relative);
+    free(watch->dirs[wd]);
+    watch->dirs[wd] = (char*)malloc(length + 1);
+    if (watch->dirs[wd])
+        memcpy(watch->dirs[wd], relative, length + 1);
+}
+
+static bool addEntry(const WalkEntry* entry, void* user)
+{
+    Scan* scan = (Scan*)user;
+
+    // Walks may start below the root, so take the path relative to the root rather than the walk.
+    const char* relative = entry->path + strlen(scan->watch->root) + 1;
+
+    if (entry->directory)
+        addDirectory(scan->watch, relative);
+    else if (scan->fn)
+        report(scan->watch, relative, scan->fn, scan->user);
+
+    return true;
+}
+
+static void readEvents(Watch* watch, WatchFn fn, void* user)
+{
+    char buffer[16 * 1024] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    for (;;) {
+        ssize_t length = read(watch->fd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break;
+
+        for (char* p = buffer; p < buffer + length;) {
+            struct inotify_event* event = (struct inotify_event*)p;
+            p += sizeof(struct inotify_event) + event->len;
+
+            if (event->len == 0 || event->wd < 0 || event->wd >= watch->dirCount || watch->dirs[event->wd] == NULL)
+                continue;
+
+            const char* dir = watch->dirs[event->wd];
+
+            char path[WATCH_MAX_PATH];
+            if (dir[0])
+                snprintf(path, sizeof(path), "%s/%s", dir, event->name);
+            else
+                snprintf(path, sizeof(path), "%s", event->name);
+
+            if (event->mask & IN_ISDIR) {
+                // New directories get watched too, files written before the watch was added are reported by the walk.
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    char full[WATCH_MAX_PATH];
+                    snprintf(full, sizeof(full), "%s/%s", watch->root, path);
+
+                    Scan scan = { watch, fn, user };
+                    addDirectory(watch, path);
+                    walkDirectory(full, true, addEntry, &scan);
+                }
+            } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                report(watch, path, fn, user);
+            }
+        }
+    }
+}
+#endif
+
+Watch* watchOpen(const char* root)
+{
+    Watch* watch = (Watch*)calloc(1, sizeof(Watch));
+    if (watch == NULL)
+        return NULL;
+
+    size_t length = strlen(root);
+    while (length > 1 && (root[length - 1] == '/' || root[length - 1] == '\\'))
+        length--;
+
+    if (length >= WATCH_MAX_PATH) {
+        free(watch);
+        return NULL;
+    }
+
+    memcpy(watch->root, root, length);
+    watch->root[length] = '\0';
+
+    map_init(&watch->times);
+    map_init(&watch->changed);
+
+#ifdef __linux__
+    watch->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch->fd >= 0) {
+        Scan scan = { watch, NULL, NULL };
+        addDirectory(watch, "");
+        walkDirectory(watch->root, true, addEntry, &scan);
+        return watch;
+    }
+#endif
+
+    // Remember the current times so only later writes are reported.
+    rescan(watch, NULL, NULL);
+
+    return watch;
+}
+
+void watchClose(Watch* watch)
+{
+    if (watch == NULL)
+        return;
+
+#ifdef __linux__
+    if (watch->fd >= 0)
+        close(watch->fd);
+
+    for (int i = 0; i < watch->dirCount; i++)
+        free(watch->dirs[i]);
+    free(watch->dirs);
+#endif
+
+    map_deinit(&watch->times);
+    map_deinit(&watch->changed);
+    free(watch);
+}
+
+void watchPoll(Watch* watch, WatchFn fn, void* user)
+{
+    clearChanged(watch);
+
+#ifdef __linux__
+    if (watch->fd >= 0) {
+        readEvents(watch, fn, user);
+        return;
+    }
+#endif
+
+    if (time(NULL) != watch->lastScan)
+        rescan(watch, fn, user);
+}
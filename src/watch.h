@@ -0,0 +1,20 @@
+#ifndef WATCH_H
+#define WATCH_H
+
+#include <stdbool.h>
+
+// Reports files that changed under a directory. Uses inotify on Linux and
+// falls back to rescanning modification times about once a second.
+
+typedef struct Watch Watch;
+
+typedef void (*WatchFn)(const char* path, void* user);
+
+Watch* watchOpen(const char* root);
+void watchClose(Watch* watch);
+
+// Calls fn once for every file written since the last poll, with its path
+// relative to the root. Never blocks.
+void watchPoll(Watch* watch, WatchFn fn, void* user);
+
+#endif
@@ -9,6 +9,13 @@
 
 #include "api.h"
 #include "api.wren.h"
+#include "bus.h"
+#include "capture.h"
+#include "egg.h"
+#include "feeder.h"
+#include "headless.h"
+#include "nest.h"
+#include "reload.h"
 #include "util.h"
 
 #ifdef _WIN32
@@ -21,48 +28,24 @@
 #endif
 
 static char selfPath[256];
-static struct zip_t* egg = NULL;
+static Egg* egg = NULL;
 
-static unsigned char* zipLoadFileData(const char* path, int* size)
+static unsigned char* eggLoadFileData(const char* path, int* size)
 {
-    if (zip_entry_open(egg, path) < 0)
+    size_t length;
+    unsigned char* buffer = eggLoad(egg, path, &length);
+    if (buffer == NULL)
         return NULL;
 
-    *size = (int)zip_entry_size(egg);
-
-    unsigned char* buffer = (unsigned char*)malloc(*size);
-    if (buffer == NULL) {
-        zip_entry_close(egg);
-        return NULL;
-    }
-
-    zip_entry_noallocread(egg, buffer, *size);
-
-    zip_entry_close(egg);
+    *size = (int)length;
 
     return buffer;
 }
 
-static char* zipLoadFileText(const char* path)
+static char* eggLoadFileText(const char* path)
 {
-    if (zip_entry_open(egg, path) < 0)
-        return NULL;
-
-    size_t size = zip_entry_size(egg);
-
-    char* buffer = (char*)malloc(size + 1);
-    if (buffer == NULL) {
-        zip_entry_close(egg);
-        return NULL;
-    }
-
-    zip_entry_noallocread(egg, buffer, size);
-
-    buffer[size] = '\0';
-
-    zip_entry_close(egg);
-
-    return buffer;
+    size_t length;
+    return (char*)eggLoad(egg, path, &length);
 }
 
 static void onComplete(WrenVM* vm, const char* name, WrenLoadModuleResult result)
@@ -99,6 +82,9 @@ static WrenForeignMethodFn wrenBindForeignMethod(WrenVM* vm, const char* module,
         BIND_METHOD("init()", audioInit);
         BIND_METHOD("volume", audioGetVolume);
         BIND_METHOD("volume=(_)", audioSetVolume);
+        BIND_METHOD("maxVoices", audioGetMaxVoices);
+        BIND_METHOD("maxVoices=(_)", audioSetMaxVoices);
+        BIND_METHOD("activeVoices", audioGetActiveVoices);
     } else if (TextIsEqual(className, "Sound")) {
         BIND_METHOD("init new(_)", soundNew);
         BIND_METHOD("play()", soundPlay);
@@ -109,6 +95,11 @@ static WrenForeignMethodFn wrenBindForeignMethod(WrenVM* vm, const char* module,
         BIND_METHOD("volume=(_)", soundSetVolume);
         BIND_METHOD("pitch=(_)", soundSetPitch);
         BIND_METHOD("pan=(_)", soundSetPan);
+        BIND_METHOD("playVoice(_,_,_)", soundPlayVoice);
+        BIND_METHOD("playVoice(_,_,_,_)", soundPlayVoice2);
+        BIND_METHOD("stopVoices()", soundStopVoices);
+        BIND_METHOD("voices=(_)", soundSetVoices);
+        BIND_METHOD("bus=(_)", soundSetBus);
     } else if (TextIsEqual(className, "SoundAlias")) {
         BIND_METHOD("init new(_)", soundAliasNew);
         BIND_METHOD("play()", soundPlay);
@@ -119,6 +110,48 @@ static WrenForeignMethodFn wrenBindForeignMethod(WrenVM* vm, const char* module,
         BIND_METHOD("volume=(_)", soundSetVolume);
         BIND_METHOD("pitch=(_)", soundSetPitch);
         BIND_METHOD("pan=(_)", soundSetPan);
+        BIND_METHOD("bus=(_)", soundSetBus);
+    } else if (TextIsEqual(className, "Music")) {
+        BIND_METHOD("init new(_)", musicNew);
+        BIND_METHOD("play()", musicPlay);
+        BIND_METHOD("stop()", musicStop);
+        BIND_METHOD("pause()", musicPause);
+        BIND_METHOD("resume()", musicResume);
+        BIND_METHOD("seek(_)", musicSeek);
+        BIND_METHOD("playing", musicGetPlaying);
+        BIND_METHOD("length", musicGetLength);
+        BIND_METHOD("position", musicGetPosition);
+        BIND_METHOD("looping", musicGetLooping);
+        BIND_METHOD("looping=(_)", musicSetLooping);
+        BIND_METHOD("volume=(_)", musicSetVolume);
+        BIND_METHOD("pitch=(_)", musicSetPitch);
+        BIND_METHOD("pan=(_)", musicSetPan);
+        BIND_METHOD("bus=(_)", musicSetBus);
+    } else if (TextIsEqual(className, "AudioStream")) {
+        BIND_METHOD("init new(_,_,_)", audioStreamNew);
+        BIND_METHOD("init new(_,_,_,_)", audioStreamNew2);
+        BIND_METHOD("write(_)", audioStreamWrite);
+        BIND_METHOD("write(_,_,_)", audioStreamWrite2);
+        BIND_METHOD("play()", audioStreamPlay);
+        BIND_METHOD("stop()", audioStreamStop);
+        BIND_METHOD("pause()", audioStreamPause);
+        BIND_METHOD("resume()", audioStreamResume);
+        BIND_METHOD("playing", audioStreamGetPlaying);
+        BIND_METHOD("queued", audioStreamGetQueued);
+        BIND_METHOD("space", audioStreamGetSpace);
+        BIND_METHOD("latency", audioStreamGetLatency);
+        BIND_METHOD("underruns", audioStreamGetUnderruns);
+        BIND_METHOD("volume=(_)", audioStreamSetVolume);
+        BIND_METHOD("pitch=(_)", audioStreamSetPitch);
+        BIND_METHOD("pan=(_)", audioStreamSetPan);
+        BIND_METHOD("bus=(_)", audioStreamSetBus);
+    } else if (TextIsEqual(className, "Mixer")) {
+        BIND_METHOD("gain(_)", mixerGain);
+        BIND_METHOD("setGain(_,_)", mixerSetGain);
+        BIND_METHOD("duck(_,_,_)", mixerDuck);
+        BIND_METHOD("lowPass=(_)", mixerSetLowPass);
+        BIND_METHOD("reverb(_,_,_)", mixerReverb);
+        BIND_METHOD("compressor(_,_)", mixerCompressor);
     } else if (TextIsEqual(className, "Graphics")) {
         BIND_METHOD("begin()", graphicsBegin);
         BIND_METHOD("end()", graphicsEnd);
@@ -127,6 +160,11 @@ static WrenForeignMethodFn wrenBindForeignMethod(WrenVM* vm, const char* module,
         BIND_METHOD("beginScissor(_,_,_,_)", graphicsBeginScissor);
         BIND_METHOD("endScissor()", graphicsEndScissor);
         BIND_METHOD("screenshot(_)", graphicsScreenshot);
+        BIND_METHOD("startRecording(_,_)", graphicsStartRecording);
+        BIND_METHOD("stopRecording()", graphicsStopRecording);
+        BIND_METHOD("recording", graphicsGetRecording);
+        BIND_METHOD("recordedFrames", graphicsGetRecordedFrames);
+        BIND_METHOD("captureFailures", graphicsGetCaptureFailures);
         BIND_METHOD("measure(_,_)", graphicsMeasure);
         BIND_METHOD("noise(_,_,_,_)", graphicsNoise);
         BIND_METHOD("clear(_)", graphicsClear);
@@ -146,6 +184,12 @@ static WrenForeignMethodFn wrenBindForeignMethod(WrenVM* vm, const char* module,
         BIND_METHOD("polygonLines(_,_,_,_,_,_,_)", graphicsPolygonLines);
         BIND_METHOD("noiseSeed=(_)", graphicsSetNoiseSeed);
         BIND_METHOD("lineSpacing=(_)", graphicsSetLineSpacing);
+    } else if (TextIsEqual(className, "Noise")) {
+        BIND_METHOD("fill(_,_,_,_,_,_,_)", noiseFill);
+        BIND_METHOD("fillSimplex(_,_,_,_,_,_,_)", noiseFillSimplex);
+        BIND_METHOD("fillSimplex(_,_,_,_,_,_,_,_)", noiseFillSimplex2);
+        BIND_METHOD("simplex(_,_)", noiseSimplex);
+        BIND_METHOD("simplex(_,_,_)", noiseSimplex2);
     } else if (TextIsEqual(className, "UI")) {
         BIND_METHOD("update()", uiUpdate);
         BIND_METHOD("draw()", uiDraw);
@@ -191,6 +235,7 @@ static WrenForeignMethodFn wrenBindForeignMethod(WrenVM* vm, const char* module,
         BIND_METHOD("init fromGradientLinear(_,_,_,_,_)", imageNew7);
         BIND_METHOD("init fromGradientRadial(_,_,_,_,_)", imageNew8);
         BIND_METHOD("init fromGradientSquare(_,_,_,_,_)", imageNew9);
+        BIND_METHOD("init fromNoise(_,_,_,_,_,_)", imageNew10);
         BIND_METHOD("export(_)", imageExport);
         BIND_METHOD("exportToMemory(_)", imageExportToMemory);
         BIND_METHOD("crop(_,_,_,_)", imageCrop);
@@ -198,13 +243,28 @@ static WrenForeignMethodFn wrenBindForeignMethod(WrenVM* vm, const char* module,
         BIND_METHOD("flipVertical()", imageFlipVertical);
         BIND_METHOD("flipHorizontal()", imageFlipHorizontal);
         BIND_METHOD("rotate(_)", imageRotate);
+        BIND_METHOD("convert(_)", imageConvert);
+        BIND_METHOD("mipmaps()", imageMipmaps);
+        BIND_METHOD("premultiplyAlpha()", imagePremultiplyAlpha);
+        BIND_METHOD("pixels", imageGetPixels);
+        BIND_METHOD("getPixel(_,_)", imageGetPixel);
+        BIND_METHOD("setPixel(_,_,_)", imageSetPixel);
+        BIND_METHOD("fillRect(_,_,_,_,_)", imageFillRect);
+        BIND_METHOD("blit(_,_,_)", imageBlit);
+        BIND_METHOD("blit(_,_,_,_,_,_,_)", imageBlit2);
+        BIND_METHOD("replaceColor(_,_)", imageReplaceColor);
+        BIND_METHOD("convolve(_)", imageConvolve);
         BIND_METHOD("width", imageGetWidth);
         BIND_METHOD("height", imageGetHeight);
         BIND_METHOD("format", imageGetFormat);
+        BIND_METHOD("mipmapCount", imageGetMipmapCount);
     } else if (TextIsEqual(className, "Texture")) {
         BIND_METHOD("init new(_)", textureNew);
+        BIND_METHOD("init new(_,_)", textureNew2);
         BIND_METHOD("draw(_,_,_,_,_,_,_,_)", textureDraw);
         BIND_METHOD("drawRec(_,_,_,_,_,_,_,_,_,_,_,_)", textureDrawRec);
+        BIND_METHOD("updateFromImage(_)", textureUpdateFromImage);
+        BIND_METHOD("updateRect(_,_,_,_,_)", textureUpdateRect);
         BIND_METHOD("width", textureGetWidth);
         BIND_METHOD("height", textureGetHeight);
         BIND_METHOD("filter=(_)", textureSetFilter);
@@ -246,6 +306,13 @@ static WrenForeignMethodFn wrenBindForeignMethod(WrenVM* vm, const char* module,
         BIND_METHOD("begin()", shaderBegin);
         BIND_METHOD("end()", shaderEnd);
         BIND_METHOD("set(_,_)", shaderSet);
+    } else if (TextIsEqual(className, "PostFX")) {
+        BIND_METHOD("init new()", postFXNew);
+        BIND_METHOD("begin()", postFXBegin);
+        BIND_METHOD("end()", postFXEnd);
+        BIND_METHOD("apply(_,_,_)", postFXApply);
+        BIND_METHOD("draw(_,_)", postFXDraw);
+        BIND_METHOD("targets", postFXGetTargets);
     } else if (TextIsEqual(className, "Keyboard")) {
         BIND_METHOD("pressed(_)", keyboardPressed);
         BIND_METHOD("pressedRepeat(_)", keyboardPressedRepeat);
@@ -334,19 +401,85 @@ static WrenForeignMethodFn wrenBindForeignMethod(WrenVM* vm, const char* module,
         BIND_METHOD("compress(_)", dataCompress);
         BIND_METHOD("decompress(_)", dataDecompress);
         BIND_METHOD("encodeBase64(_)", dataEncodeBase64);
+        BIND_METHOD("encodeBase64(_,_,_)", dataEncodeBase64Into);
         BIND_METHOD("decodeBase64(_)", dataDecodeBase64);
+        BIND_METHOD("decodeBase64(_,_,_)", dataDecodeBase64Into);
         BIND_METHOD("encodeHex(_)", dataEncodeHex);
+        BIND_METHOD("encodeHex(_,_,_)", dataEncodeHexInto);
         BIND_METHOD("decodeHex(_)", dataDecodeHex);
+        BIND_METHOD("decodeHex(_,_,_)", dataDecodeHexInto);
         BIND_METHOD("hash(_)", dataHash);
+        BIND_METHOD("hash64(_)", dataHash64);
+        BIND_METHOD("crc32(_)", dataCrc32);
+    } else if (TextIsEqual(className, "Hasher")) {
+        BIND_METHOD("init new(_)", hasherNew);
+        BIND_METHOD("update(_)", hasherUpdate);
+        BIND_METHOD("update(_,_,_)", hasherUpdate2);
+        BIND_METHOD("digest()", hasherDigest);
+        BIND_METHOD("reset()", hasherReset);
+    } else if (TextIsEqual(className, "Deflater")) {
+        BIND_METHOD("init new(_)", deflaterNew);
+        BIND_METHOD("init new(_,_)", deflaterNew2);
+        BIND_METHOD("write(_)", zstreamWrite);
+        BIND_METHOD("write(_,_,_)", zstreamWrite2);
+        BIND_METHOD("finish()", deflaterFinish);
+        BIND_METHOD("read()", zstreamRead);
+        BIND_METHOD("read(_,_)", zstreamReadInto);
+        BIND_METHOD("pending", zstreamGetPending);
+        BIND_METHOD("totalIn", zstreamGetTotalIn);
+        BIND_METHOD("totalOut", zstreamGetTotalOut);
+        BIND_METHOD("finished", zstreamGetFinished);
+    } else if (TextIsEqual(className, "Inflater")) {
+        BIND_METHOD("init new()", inflaterNew);
+        BIND_METHOD("init new(_)", inflaterNew2);
+        BIND_METHOD("write(_)", zstreamWrite);
+        BIND_METHOD("write(_,_,_)", zstreamWrite2);
+        BIND_METHOD("read()", zstreamRead);
+        BIND_METHOD("read(_,_)", zstreamReadInto);
+        BIND_METHOD("pending", zstreamGetPending);
+        BIND_METHOD("totalIn", zstreamGetTotalIn);
+        BIND_METHOD("totalOut", zstreamGetTotalOut);
+        BIND_METHOD("finished", zstreamGetFinished);
     } else if (TextIsEqual(className, "Directory")) {
         BIND_METHOD("exists(_)", directoryExists);
         BIND_METHOD("list(_)", directoryList);
+        BIND_METHOD("walk(_)", directoryWalk);
+        BIND_METHOD("walk(_,_)", directoryWalk2);
     } else if (TextIsEqual(className, "File")) {
         BIND_METHOD("exists(_)", fileExists);
         BIND_METHOD("size(_)", fileSize);
         BIND_METHOD("read(_)", fileRead);
         BIND_METHOD("readEmbedded(_)", fileReadEmbedded);
         BIND_METHOD("write(_,_)", fileWrite);
+    } else if (TextIsEqual(className, "FileHandle")) {
+        BIND_METHOD("init open(_,_)", fileHandleOpen);
+        BIND_METHOD("read(_)", fileHandleRead);
+        BIND_METHOD("read(_,_,_)", fileHandleReadInto);
+        BIND_METHOD("readLine()", fileHandleReadLine);
+        BIND_METHOD("write(_)", fileHandleWrite);
+        BIND_METHOD("write(_,_,_)", fileHandleWrite2);
+        BIND_METHOD("seek(_)", fileHandleSeek);
+        BIND_METHOD("seek(_,_)", fileHandleSeek2);
+        BIND_METHOD("flush()", fileHandleFlush);
+        BIND_METHOD("close()", fileHandleClose);
+        BIND_METHOD("position", fileHandleGetPosition);
+        BIND_METHOD("size", fileHandleGetSize);
+        BIND_METHOD("eof", fileHandleGetEof);
+        BIND_METHOD("isOpen", fileHandleGetIsOpen);
+    } else if (TextIsEqual(className, "FileTask")) {
+        BIND_METHOD("init read(_)", fileTaskRead);
+        BIND_METHOD("init readEmbedded(_)", fileTaskReadEmbedded);
+        BIND_METHOD("init write(_,_)", fileTaskWrite);
+        BIND_METHOD("complete", fileTaskGetComplete);
+        BIND_METHOD("result", fileTaskGetResult);
+        BIND_METHOD("error", fileTaskGetError);
+    } else if (TextIsEqual(className, "Hot")) {
+        BIND_METHOD("watch(_)", hotWatch);
+        BIND_METHOD("state", hotGetState);
+        BIND_METHOD("state=(_)", hotSetState);
+        BIND_METHOD("poll_()", hotPoll);
+        BIND_METHOD("scriptChanged_", hotGetScriptChanged);
+        BIND_METHOD("restart_()", hotRestart);
     } else if (TextIsEqual(className, "Buffer")) {
         BIND_METHOD("init new(_)", bufferNew);
         BIND_METHOD("init from(_)", bufferNew2);
@@ -392,6 +525,8 @@ static WrenForeignMethodFn wrenBindForeignMethod(WrenVM* vm, const char* module,
     } else if (TextIsEqual(className, "Host")) {
         BIND_METHOD("init new(_,_,_,_,_)", hostNew);
         BIND_METHOD("init new(_)", hostNew2);
+        BIND_METHOD("init loopback(_,_,_,_,_)", hostLoopback);
+        BIND_METHOD("init loopback(_)", hostLoopback2);
         BIND_METHOD("connect(_,_,_)", hostConnect);
         BIND_METHOD("service(_)", hostService);
         BIND_METHOD("checkEvents()", hostCheckEvents);
@@ -400,6 +535,7 @@ static WrenForeignMethodFn wrenBindForeignMethod(WrenVM* vm, const char* module,
         BIND_METHOD("broadcast(_,_,_)", hostBroadcast);
         BIND_METHOD("setBandwidthLimit(_,_)", hostSetBandwidthLimit);
         BIND_METHOD("getPeer(_)", hostGetPeer);
+        BIND_METHOD("dumpStats(_,_)", hostDumpStats);
         BIND_METHOD("totalSent", hostGetTotalSent);
         BIND_METHOD("totalReceived", hostGetTotalReceived);
         BIND_METHOD("serviceTime", hostGetServiceTime);
@@ -422,10 +558,21 @@ static WrenForeignMethodFn wrenBindForeignMethod(WrenVM* vm, const char* module,
         BIND_METHOD("rtt", peerGetRtt);
         BIND_METHOD("lastRtt", peerGetLastRtt);
         BIND_METHOD("timeout", peerGetTimeout);
+        BIND_METHOD("stats", peerGetStats);
         BIND_METHOD("toString", peerGetToString);
         BIND_METHOD("pingInterval=(_)", peerSetPingInterval);
         BIND_METHOD("rtt=(_)", peerSetRtt);
         BIND_METHOD("lastRtt=(_)", peerSetLastRtt);
+    } else if (TextIsEqual(className, "Loopback")) {
+        BIND_METHOD("latency=(_)", loopbackSetLatency);
+        BIND_METHOD("jitter=(_)", loopbackSetJitter);
+        BIND_METHOD("loss=(_)", loopbackSetLoss);
+        BIND_METHOD("bandwidth=(_)", loopbackSetBandwidth);
+        BIND_METHOD("seed=(_)", loopbackSetSeed);
+        BIND_METHOD("deterministic=(_)", loopbackSetDeterministic);
+        BIND_METHOD("advance(_)", loopbackAdvance);
+        BIND_METHOD("time", loopbackGetTime);
+        BIND_METHOD("stats", loopbackGetStats);
     }
 
     return NULL;
@@ -441,6 +588,12 @@ static WrenForeignClassMethods wrenBindForeignClass(WrenVM* vm, const char* modu
     } else if (TextIsEqual(className, "SoundAlias")) {
         methods.allocate = soundAllocate;
         methods.finalize = soundAliasFinalize;
+    } else if (TextIsEqual(className, "Music")) {
+        methods.allocate = musicAllocate;
+        methods.finalize = musicFinalize;
+    } else if (TextIsEqual(className, "AudioStream")) {
+        methods.allocate = audioStreamAllocate;
+        methods.finalize = audioStreamFinalize;
     } else if (TextIsEqual(className, "Color")) {
         methods.allocate = colorAllocate;
     } else if (TextIsEqual(className, "Image")) {
@@ -460,8 +613,22 @@ static WrenForeignClassMethods wrenBindForeignClass(WrenVM* vm, const char* modu
     } else if (TextIsEqual(className, "Shader")) {
         methods.allocate = shaderAllocate;
         methods.finalize = shaderFinalize;
+    } else if (TextIsEqual(className, "PostFX")) {
+        methods.allocate = postFXAllocate;
+        methods.finalize = postFXFinalize;
     } else if (TextIsEqual(className, "Gamepad")) {
         methods.allocate = gamepadAllocate;
+    } else if (TextIsEqual(className, "Hasher")) {
+        methods.allocate = hasherAllocate;
+    } else if (TextIsEqual(className, "Deflater") || TextIsEqual(className, "Inflater")) {
+        methods.allocate = zstreamAllocate;
+        methods.finalize = zstreamFinalize;
+    } else if (TextIsEqual(className, "FileHandle")) {
+        methods.allocate = fileHandleAllocate;
+        methods.finalize = fileHandleFinalize;
+    } else if (TextIsEqual(className, "FileTask")) {
+        methods.allocate = fileTaskAllocate;
+        methods.finalize = fileTaskFinalize;
     } else if (TextIsEqual(className, "Buffer")) {
         methods.allocate = bufferAllocate;
         methods.finalize = bufferFinalize;
@@ -496,9 +663,15 @@ static void wrenError(WrenVM* vm, WrenErrorType type, const char* module, int li
     }
 }
 
-static void runWren(const char* script, const char* module)
+// Runs the script in a fresh VM and returns true when Hot.update asked for a restart.
+static bool runVM(const char* script, const char* module, bool* audioInit, bool* windowInit, WrenInterpretResult* result)
 {
     char* source = LoadFileText(script);
+    if (source == NULL) {
+        printf("Failed to load %s\n", script);
+        *result = WREN_RESULT_COMPILE_ERROR;
+        return false;
+    }
 
     WrenConfiguration config;
     wrenInitConfiguration(&config);
@@ -511,16 +684,19 @@ static void runWren(const char* script, const char* module)
 
     WrenVM* vm = wrenNewVM(&config);
 
-    if (wrenInterpret(vm, "wray", apiModuleSource) != WREN_RESULT_SUCCESS) {
+    *result = wrenInterpret(vm, "wray", apiModuleSource);
+    if (*result != WREN_RESULT_SUCCESS) {
         wrenFreeVM(vm);
         UnloadFileText(source);
-        return;
+        return false;
     }
 
     vmData data;
     data.audioInit = false;
     data.windowInit = false;
     data.enetInit = false;
+    data.egg = egg;
+    data.restart = false;
 
     data.uiCtx = malloc(sizeof(mu_Context));
     mu_init(data.uiCtx);
@@ -532,14 +708,20 @@ static void runWren(const char* script, const char* module)
     wrenEnsureSlots(vm, 1);
     wrenGetVariable(vm, "wray", "Texture", 0);
     data.textureClass = wrenGetSlotHandle(vm, 0);
+    wrenGetVariable(vm, "wray", "Color", 0);
+    data.colorClass = wrenGetSlotHandle(vm, 0);
+    wrenGetVariable(vm, "wray", "Buffer", 0);
+    data.bufferClass = wrenGetSlotHandle(vm, 0);
     wrenGetVariable(vm, "wray", "Peer", 0);
     data.peerClass = wrenGetSlotHandle(vm, 0);
 
     wrenSetUserData(vm, &data);
 
-    wrenInterpret(vm, module, source);
+    *result = wrenInterpret(vm, module, source);
 
     wrenReleaseHandle(vm, data.textureClass);
+    wrenReleaseHandle(vm, data.colorClass);
+    wrenReleaseHandle(vm, data.bufferClass);
     wrenReleaseHandle(vm, data.peerClass);
 
     map_deinit(&data.keys);
@@ -549,12 +731,69 @@ static void runWren(const char* script, const char* module)
     UnloadFileText(source);
     wrenFreeVM(vm);
 
-    if (data.audioInit)
-        CloseAudioDevice();
-    if (data.windowInit)
-        CloseWindow();
+    // The window and audio device stay open across restarts, runWren closes them at the end.
+    *audioInit = *audioInit || data.audioInit;
+    *windowInit = *windowInit || data.windowInit;
+
     if (data.enetInit)
         enetClose();
+
+    return data.restart;
+}
+
+// Keeps the window alive until a script is saved again, returns false if it was closed first.
+static bool waitForScriptChange(bool windowInit)
+{
+    printf("Waiting for changes...\n");
+
+    while (!windowInit || !WindowShouldClose()) {
+        reloadPoll(NULL, NULL);
+        if (reloadScriptChanged())
+            return true;
+
+        if (windowInit) {
+            BeginDrawing();
+            EndDrawing();
+        }
+
+        WaitTime(0.05);
+    }
+
+    return false;
+}
+
+static void runWren(const char* script, const char* module)
+{
+    bool audioInit = false;
+    bool windowInit = false;
+    bool restart;
+
+    do {
+        WrenInterpretResult result;
+        restart = runVM(script, module, &audioInit, &windowInit, &result);
+
+        // With hot reload on, a broken script waits for the fix instead of closing the game.
+        if (!restart && result != WREN_RESULT_SUCCESS && reloadWatching())
+            restart = waitForScriptChange(windowInit);
+    } while (restart);
+
+    // Music finalizers have already unregistered, stop the feeder before the device goes away.
+    feederShutdown();
+    busShutdown();
+    captureShutdown();
+    headlessShutdown();
+
+    // Trace logging is off, so a recording that wrote nothing would otherwise go unnoticed.
+    if (captureFailures() > 0)
+        printf("Failed to write %d captured frames\n", captureFailures());
+
+    if (audioInit)
+        CloseAudioDevice();
+    if (windowInit)
+        CloseWindow();
+
+    reloadShutdown();
+    poolShutdown();
 }
 
 typedef struct {
@@ -594,8 +833,15 @@ static int newCommand(int argc, const char** argv)
 
 static int nestCommand(int argc, const char** argv)
 {
+    int level = ZIP_DEFAULT_COMPRESSION_LEVEL;
+    int jobs = 0;
+    int force = 0;
+
     struct argparse_option options[] = {
         OPT_HELP(),
+        OPT_INTEGER('l', "level", &level, "default compression level, 0-9 (6)", NULL, 0, 0),
+        OPT_INTEGER('j', "jobs", &jobs, "number of compression threads (one per CPU)", NULL, 0, 0),
+        OPT_BOOLEAN('f', "force", &force, "repackage everything, ignoring the build cache", NULL, 0, 0),
         OPT_END()
     };
 
@@ -624,107 +870,48 @@ static int nestCommand(int argc, const char** argv)
         return 1;
     }
 
+    if (level < 0 || level > 9) {
+        printf("Compression level must be between 0 and 9.\n");
+        return 1;
+    }
+
     const char* dir = argv[0];
 
-    const char* output = NULL;
+    char output[256];
 
     char lastChar = dir[TextLength(dir) - 1];
     if (lastChar == '/' || lastChar == '\\') {
-        output = TextFormat("%s.egg", GetFileName(TextSubtext(dir, 0, TextLength(dir) - 1)));
+        TextCopy(output, TextFormat("%s.egg", GetFileName(TextSubtext(dir, 0, TextLength(dir) - 1))));
     } else {
-        output = TextFormat("%s.egg", GetFileName(dir));
+        TextCopy(output, TextFormat("%s.egg", GetFileName(dir)));
     }
 
-    struct zip_t* zip = zip_open(output, ZIP_DEFAULT_COMPRESSION_LEVEL, 'w');
-
-    FilePathList files = LoadDirectoryFilesEx(dir, NULL, true);
-
-    for (int i = 0; i < (int)files.count; i++) {
-        const char* name = TextSubtext(files.paths[i], TextLength(dir) + 1, TextLength(files.paths[i]) - TextLength(dir) - 1);
-
-        zip_entry_open(zip, name);
-
-        int size;
-        unsigned char* data = LoadFileData(files.paths[i], &size);
-        zip_entry_write(zip, data, size);
-        UnloadFileData(data);
-
-        zip_entry_close(zip);
-    }
-
-    UnloadDirectoryFiles(files);
-
-    zip_close(zip);
+    NestOptions nestOptions = { level, jobs, force };
+    NestStats stats = { 0 };
+    if (!nestPack(dir, output, &nestOptions, &stats))
+        return 1;
 
-    printf("Packaged %s as %s\n", argv[0], output);
+    printf("Packaged %s as %s (%d entries, %d unchanged)\n", argv[0], output, stats.entries, stats.reused);
 
     return 0;
 }
 
-static unsigned char* checkFused(const char* selfPath, int* size)
-{
-    FILE* self = fopen(selfPath, "rb");
-    if (self == NULL) {
-        printf("Failed to open self.\n");
-        return NULL;
-    }
-
-    int s;
-    char magic[5];
-
-    fseek(self, -8, SEEK_END);
-
-    fread(&s, sizeof(int), 1, self);
-    fread(magic, sizeof(char), 4, self);
-    magic[4] = '\0';
-
-    if (TextIsEqual(magic, "WRAY")) {
-        unsigned char* buffer = (unsigned char*)malloc(s);
-        if (buffer == NULL) {
-            printf("Failed to allocate buffer.\n");
-            fclose(self);
-            return NULL;
-        }
-
-        fseek(self, -8 - s, SEEK_END);
-        fread(buffer, s, 1, self);
-
-        fclose(self);
-
-        *size = s;
-
-        return buffer;
-    }
-
-    return NULL;
-}
-
-static void fuse(const char* selfPath, const char* eggPath)
+static bool fuse(const char* selfPath, const char* eggPath)
 {
-    int selfSize;
-    unsigned char* self = LoadFileData(selfPath, &selfSize);
-
-    int eggSize;
-    unsigned char* egg = LoadFileData(eggPath, &eggSize);
-
-    unsigned char* output = (unsigned char*)malloc(selfSize + eggSize + 8);
-    memcpy(output, self, selfSize);
-    memcpy(output + selfSize, egg, eggSize);
-
-    memcpy(output + selfSize + eggSize, &eggSize, sizeof(int));
-    memcpy(output + selfSize + eggSize + 4, "WRAY", 4);
-
 #ifdef _WIN32
     const char* outName = TextFormat("%s.exe", GetFileNameWithoutExt(eggPath));
 #else
     const char* outName = TextFormat("%s_out", GetFileNameWithoutExt(eggPath));
 #endif
 
-    SaveFileData(outName, output, selfSize + eggSize + 8);
+    if (!eggFuse(selfPath, eggPath, outName))
+        return false;
 
 #ifndef _WIN32
     chmod(outName, 0777);
 #endif
+
+    return true;
 }
 
 static int fuseCommand(int argc, const char** argv)
@@ -759,7 +946,10 @@ static int fuseCommand(int argc, const char** argv)
         return 1;
     }
 
-    fuse(selfPath, argv[0]);
+    if (!fuse(selfPath, argv[0])) {
+        printf("Failed to fuse %s\n", argv[0]);
+        return 1;
+    }
 
 #ifdef _WIN32
     printf("Created %s\n", TextFormat("%s.exe", GetFileNameWithoutExt(argv[0])));
@@ -786,28 +976,34 @@ int main(int argc, char** argv)
 {
     SetTraceLogLevel(LOG_NONE);
 
-    int size;
-    unsigned char* data = checkFused(argv[0], &size);
-    if (data != NULL) {
+    egg = eggOpenFused(argv[0]);
+    if (egg != NULL) {
         setArgs(argc, argv);
 
-        egg = zip_stream_open(data, size, 0, 'r');
-
-        SetLoadFileDataCallback(zipLoadFileData);
-        SetLoadFileTextCallback(zipLoadFileText);
+        SetLoadFileDataCallback(eggLoadFileData);
+        SetLoadFileTextCallback(eggLoadFileText);
 
         runWren("main.wren", "main");
 
-        zip_close(egg);
+        eggClose(egg);
 
         return 0;
     }
 
     TextCopy(selfPath, argv[0]);
 
+    int headless = 0;
+    int fps = 60;
+    int frames = 0;
+    const char* record = NULL;
+
     struct argparse_option options[] = {
         OPT_HELP(),
         OPT_BOOLEAN('v', "version", NULL, "show the version number and exit", versionCallback, 0, OPT_NONEG),
+        OPT_BOOLEAN(0, "headless", &headless, "hidden window, offscreen rendering and fixed dt", NULL, 0, 0),
+        OPT_INTEGER(0, "fps", &fps, "frames per second of game time in headless mode (60)", NULL, 0, 0),
+        OPT_INTEGER(0, "frames", &frames, "close the window after this many headless frames", NULL, 0, 0),
+        OPT_STRING(0, "record", &record, "save every frame to this directory as PNG", NULL, 0, 0),
         OPT_END()
     };
 
@@ -838,6 +1034,30 @@ int main(int argc, char** argv)
         return command->fn(argc, (const char**)argv);
     }
 
+    if (headless) {
+        if (fps <= 0) {
+            printf("Headless fps must be positive.\n");
+            return 1;
+        }
+
+        headlessEnable(1.0 / fps, frames);
+    }
+
+    if (record) {
+        if (!DirectoryExists(record))
+            mkdir(record);
+
+        // Made absolute now, the script's directory becomes the working directory below.
+        bool absolute = record[0] == '/' || record[0] == '\\' || (record[0] != '\0' && record[1] == ':');
+        if (!absolute)
+            record = TextFormat("%s/%s", GetWorkingDirectory(), record);
+
+        if (!DirectoryExists(record) || !captureStartRecording(record, ".png")) {
+            printf("Cannot record to %s\n", record);
+            return 1;
+        }
+    }
+
     setArgs(argc, argv);
 
     if (DirectoryExists(argv[0])) {
@@ -850,14 +1070,18 @@ int main(int argc, char** argv)
 
         runWren("main.wren", "main");
     } else if (FileExists(argv[0]) && TextIsEqual(GetFileExtension(argv[0]), ".egg")) {
-        egg = zip_open(argv[0], 0, 'r');
+        egg = eggOpen(argv[0]);
+        if (egg == NULL) {
+            printf("Failed to open %s\n", argv[0]);
+            return 1;
+        }
 
-        SetLoadFileDataCallback(zipLoadFileData);
-        SetLoadFileTextCallback(zipLoadFileText);
+        SetLoadFileDataCallback(eggLoadFileData);
+        SetLoadFileTextCallback(eggLoadFileText);
 
         runWren("main.wren", "main");
 
-        zip_close(egg);
+        eggClose(egg);
     } else if (FileExists(argv[0])) {
         if (!TextIsEqual(GetFileExtension(argv[0]), ".wren")) {
             printf("%s is not a wren source file.\n", argv[0]);